@@ -143,6 +143,27 @@ def getOptions():
     parser.add_option("--coherent", action="store_true", default=False,
                       help="Whether the caches should be kept coherent")
 
+    parser.add_option("--bb-cache", action="store_true", default=False,
+                      help="Replay cached basic blocks on atomic CPUs")
+
+    parser.add_option("--shared-decode-cache", action="store_true",
+                      default=False,
+                      help="Share decoded instructions between all CPUs")
+
+    parser.add_option("--dtu-cmd-trace", action="store_true", default=False,
+                      help="Record the DTU commands of all PEs for replay")
+
+    parser.add_option("--accel-bufs", type="int", default=1,
+                      help="Number of overlapped blocks in stream accelerators")
+
+    parser.add_option("--accel-ctx-slots", type="int", default=0,
+                      help="Number of on-chip context slots of accelerators")
+
+    parser.add_option("--warm-ticks", type="int", default=0, metavar="T",
+                      help="Fast-forward the cores for T ticks with atomic "
+                      "CPUs that functionally warm the caches, TLBs and "
+                      "branch predictors of the --cpu-type CPUs")
+
     parser.add_option("-m", "--maxtick", type="int", default=m5.MaxTick,
                       metavar="T",
                       help="Stop after T ticks")
@@ -266,6 +287,7 @@ def createPE(noc, options, no, systemType, l1size, l2size, spmsize, dtupos, memP
 
     pe.dtu.coherent = options.coherent
     pe.dtu.num_endpoints = 16
+    pe.dtu.cmd_trace = options.dtu_cmd_trace
     if dtupos > 0:
         pe.dtu.tlb_entries = 32
     else:
@@ -387,8 +409,29 @@ def createCorePE(noc, options, no, cmdline, memPE, l1size=None, l2size=None,
     # connection to the NoC for initialization
     pe.noc_master_port = noc.slave
 
-    pe.cpu = CPUClass()
+    if options.warm_ticks > 0:
+        # fast-forward with the caches bypassed, so that the warmer can
+        # update them on its own thread
+        pe.mem_mode = 'atomic_noncaching'
+        pe.cpu = AtomicSimpleCPU()
+        pe.switch_cpu = CPUClass(switched_out=True)
+        pe.switch_cpu.cpu_id = 0
+    else:
+        pe.cpu = CPUClass()
     pe.cpu.cpu_id = 0
+    if options.bb_cache and hasattr(pe.cpu, 'bb_cache'):
+        pe.cpu.bb_cache = True
+
+    if options.warm_ticks > 0 and not l1size is None:
+        icaches = [pe.l1icache]
+        dcaches = [pe.l1dcache]
+        if not l2size is None:
+            icaches.append(pe.l2cache)
+            dcaches.append(pe.l2cache)
+        pe.cpu.addFunctionalWarmer(icaches=icaches, dcaches=dcaches,
+                                   dtu=pe.dtu)
+        if hasattr(pe.switch_cpu, 'branchPred'):
+            pe.cpu.warmer.branch_pred = pe.switch_cpu.branchPred
 
     connectCuToMem(pe, options,
                    pe.cpu.dcache_port,
@@ -440,6 +483,8 @@ def createCorePE(noc, options, no, cmdline, memPE, l1size=None, l2size=None,
 
     pe.cpu.createThreads()
     pe.cpu.createInterruptController()
+    if hasattr(pe, 'switch_cpu'):
+        pe.switch_cpu.createThreads()
 
     if options.isa == 'x86_64':
         pe.cpu.interrupts[0].pio = pe.xbar.master
@@ -583,11 +628,15 @@ def createAccelPE(noc, options, no, accel, memPE, l1size=None, l2size=None, spms
         pe.accel.logic.algorithm = algos.get(accel)
         pe.accel.logic.port = pe.xbar.slave
         pe.accel.buf_size = "4kB"
+        pe.accel.buf_count = options.accel_bufs
+    elif accel == 'gemm':
+        pe.accel = DtuAccelGemm()
     else:
         print 'Accelerator "%s" does not exist' % (accel)
         sys.exit(1)
     pe.dtu.connector.accelerator = pe.accel
     pe.accel.id = no;
+    pe.accel.ctx_slots = options.accel_ctx_slots
 
     connectCuToMem(pe, options, pe.accel.port)
 
@@ -612,6 +661,7 @@ def createAladdinPE(noc, options, accel, no, memPE, l1size=None, l2size=None, sp
     pe.accel.accel_id = config.getint(accel, "accelerator_id")
     pe.dtu.connector.accelerator = pe.accel
     pe.accel.id = no;
+    pe.accel.ctx_slots = options.accel_ctx_slots
 
     pe.accel_xbar = L2XBar()
     pe.accel.port = pe.accel_xbar.slave
@@ -696,6 +746,50 @@ def createAbortTestPE(noc, options, no, memPE, l1size=None, l2size=None, spmsize
 
     return pe
 
+def createTrafficGenPE(noc, options, no, memPE, targets, l1size=None,
+                       l2size=None, spmsize='64kB'):
+    pe = createPE(
+        noc=noc, options=options, no=no, systemType=SpuSystem,
+        l1size=l1size, l2size=l2size, spmsize=spmsize, memPE=memPE,
+        dtupos=0
+    )
+    pe.dtu.connector = BaseConnector()
+
+    pe.cpu = DtuTrafficGen()
+    pe.cpu.id = no;
+    pe.cpu.targets = targets
+
+    connectCuToMem(pe, options, pe.cpu.port)
+
+    print 'PE%02d: traffic generator' % (no)
+    printConfig(pe, 0)
+    print
+
+    return pe
+
+def createTraceReplayPE(noc, options, no, memPE, trace, l1size=None,
+                        l2size=None, spmsize='64kB'):
+    pe = createPE(
+        noc=noc, options=options, no=no, systemType=SpuSystem,
+        l1size=l1size, l2size=l2size, spmsize=spmsize, memPE=memPE,
+        dtupos=0
+    )
+    pe.dtu.connector = BaseConnector()
+    # the trace contains the commands of this PE, not the replay's
+    pe.dtu.cmd_trace = False
+
+    pe.cpu = DtuTraceReplay()
+    pe.cpu.id = no;
+    pe.cpu.trace_file = trace
+
+    connectCuToMem(pe, options, pe.cpu.port)
+
+    print 'PE%02d: trace replay of %s' % (no, trace)
+    printConfig(pe, 0)
+    print
+
+    return pe
+
 def createMemPE(noc, options, no, size, dram=True, image=None, imageNum=0):
     pe = createPE(
         noc=noc, options=options, no=no, systemType=MemSystem,
@@ -737,7 +831,8 @@ def createMemPE(noc, options, no, size, dram=True, image=None, imageNum=0):
     return pe
 
 def createRoot(options):
-    root = Root(full_system=True)
+    root = Root(full_system=True,
+                shared_decode_cache=options.shared_decode_cache)
 
     # Create a top-level voltage domain
     root.voltage_domain = VoltageDomain(voltage=options.sys_voltage)
@@ -808,6 +903,8 @@ def runSimulation(root, options, pes):
                         assert(False);
                 elif type(pe.accel).__name__ == 'DtuAccelInDir':
                     size |= 4 << 3 # indir accelerator
+                elif type(pe.accel).__name__ == 'DtuAccelGemm':
+                    size |= 13 << 3 # gemm accelerator
                 elif int(pe.accel.logic.algorithm) == 0:
                     size |= 5 << 3 # fft accelerator
                 elif int(pe.accel.logic.algorithm) == 1:
@@ -835,6 +932,14 @@ def runSimulation(root, options, pes):
     m5.instantiate()
 
     # Simulate until program terminates
-    exit_event = m5.simulate(options.maxtick)
+    if options.warm_ticks > 0:
+        exit_event = m5.simulate(options.warm_ticks)
+        if exit_event.getCause() == 'simulate() limit reached':
+            for pe in pes:
+                if hasattr(pe, 'switch_cpu'):
+                    m5.switchCpus(pe, [(pe.cpu, pe.switch_cpu)])
+            exit_event = m5.simulate(options.maxtick - m5.curTick())
+    else:
+        exit_event = m5.simulate(options.maxtick)
 
     print 'Exiting @ tick', m5.curTick(), 'because', exit_event.getCause()
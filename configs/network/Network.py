@@ -65,7 +65,10 @@ def define_options(parser):
                       help="""routing algorithm in network.
                             0: weight-based table
                             1: XY (for Mesh. see garnet2.0/RoutingUnit.cc)
-                            2: Custom (see garnet2.0/RoutingUnit.cc""")
+                            2: Custom (see garnet2.0/RoutingUnit.cc
+                            3: West-first (for Mesh, adaptive)
+                            4: Odd-even (for Mesh, adaptive)
+                            5: Fully adaptive (for Mesh, escape VCs)""")
     parser.add_option("--network-fault-model", action="store_true",
                       default=False,
                       help="""enable network fault model:
@@ -51,8 +51,6 @@
 namespace ArmISA
 {
 
-GenericISA::BasicDecodeCache Decoder::defaultCache;
-
 Decoder::Decoder(ISA* isa)
     : data(0), fpscrLen(0), fpscrStride(0), decoderFlavour(isa
             ? isa->decoderFlavour()
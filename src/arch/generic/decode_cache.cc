@@ -46,6 +46,14 @@ BasicDecodeCache::decode(TheISA::Decoder *decoder,
     if (si && (si->machInst == mach_inst))
         return si;
 
+    if (SharedMap::enabled()) {
+        SharedMap &shared = SharedMap::instance();
+        si = shared.lookup(mach_inst);
+        if (!si)
+            si = shared.insert(mach_inst, decoder->decodeInst(mach_inst));
+        return si;
+    }
+
     auto iter = instMap.find(mach_inst);
     if (iter != instMap.end()) {
         si = iter->second;
@@ -47,6 +47,8 @@ namespace GenericISA
 class BasicDecodeCache
 {
   private:
+    typedef DecodeCache::SharedInstMap<TheISA::ExtMachInst> SharedMap;
+
     DecodeCache::InstMap<TheISA::ExtMachInst> instMap;
     DecodeCache::AddrMap<StaticInstPtr> decodePages;
 
@@ -38,19 +38,10 @@ using namespace PowerISA;
 const std::string &
 PCDependentDisassembly::disassemble(Addr pc, const SymbolTable *symtab) const
 {
-    if (!cachedDisassembly ||
-        pc != cachedPC || symtab != cachedSymtab)
-    {
-        if (cachedDisassembly)
-            delete cachedDisassembly;
-
-        cachedDisassembly =
-            new std::string(generateDisassembly(pc, symtab));
-        cachedPC = pc;
-        cachedSymtab = symtab;
-    }
-
-    return *cachedDisassembly;
+    // valid until the next call in this thread
+    static thread_local std::string disassembly;
+    disassembly = generateDisassembly(pc, symtab);
+    return disassembly;
 }
 
 PowerISA::PCState
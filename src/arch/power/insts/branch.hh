@@ -39,25 +39,19 @@ namespace PowerISA
 /**
  * Base class for instructions whose disassembly is not purely a
  * function of the machine instruction (i.e., it depends on the
- * PC).  This class overrides the disassemble() method to check
- * the PC and symbol table values before re-using a cached
- * disassembly string.  This is necessary for branches and jumps,
- * where the disassembly string includes the target address (which
- * may depend on the PC and/or symbol table).
+ * PC).  This class overrides the disassemble() method to generate
+ * the string on every call instead of caching it in the instruction,
+ * which might be shared between threads.  This is necessary for
+ * branches and jumps, where the disassembly string includes the
+ * target address (which may depend on the PC and/or symbol table).
  */
 class PCDependentDisassembly : public PowerStaticInst
 {
   protected:
-    /// Cached program counter from last disassembly
-    mutable Addr cachedPC;
-    /// Cached symbol table pointer from last disassembly
-    mutable const SymbolTable *cachedSymtab;
-
     /// Constructor
     PCDependentDisassembly(const char *mnem, ExtMachInst _machInst,
                            OpClass __opClass)
-        : PowerStaticInst(mnem, _machInst, __opClass),
-          cachedPC(0), cachedSymtab(0)
+        : PowerStaticInst(mnem, _machInst, __opClass)
     {
     }
 
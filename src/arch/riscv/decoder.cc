@@ -83,6 +83,14 @@ Decoder::decode(ExtMachInst mach_inst, Addr addr)
 {
     DPRINTF(Decode, "Decoding instruction 0x%08x at address %#x\n",
             mach_inst, addr);
+    if (SharedMap::enabled()) {
+        SharedMap &shared = SharedMap::instance();
+        StaticInstPtr si = shared.lookup(mach_inst);
+        if (!si)
+            si = shared.insert(mach_inst, decodeInst(mach_inst));
+        return si;
+    }
+
     if (instMap.find(mach_inst) != instMap.end())
         return instMap[mach_inst];
     else {
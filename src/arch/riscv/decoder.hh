@@ -48,6 +48,8 @@ class ISA;
 class Decoder
 {
   private:
+    typedef DecodeCache::SharedInstMap<ExtMachInst> SharedMap;
+
     DecodeCache::InstMap<ExtMachInst> instMap;
     bool aligned;
     bool mid;
@@ -676,11 +676,18 @@ Decoder::doImmediateState()
 }
 
 Decoder::InstBytes Decoder::dummy;
-Decoder::InstCacheMap Decoder::instCacheMap;
 
 StaticInstPtr
 Decoder::decode(ExtMachInst mach_inst, Addr addr)
 {
+    if (SharedMap::enabled()) {
+        SharedMap &shared = SharedMap::instance();
+        StaticInstPtr si = shared.lookup(mach_inst);
+        if (!si)
+            si = shared.insert(mach_inst, decodeInst(mach_inst));
+        return si;
+    }
+
     auto iter = instMap->find(mach_inst);
     if (iter != instMap->end())
         return iter->second;
@@ -232,7 +232,12 @@ class Decoder
     DecodeCache::InstMap<ExtMachInst> *instMap;
     typedef std::unordered_map<
             CacheKey, DecodeCache::InstMap<ExtMachInst> *> InstCacheMap;
-    static InstCacheMap instCacheMap;
+    InstCacheMap instCacheMap;
+
+    /// The decoded instructions shared with the other decoders. The
+    /// ExtMachInst already contains the operating mode, so that it can
+    /// be used as the key for all modes.
+    typedef DecodeCache::SharedInstMap<ExtMachInst> SharedMap;
 
   public:
     Decoder(ISA* isa = nullptr) : basePC(0), origPC(0), offset(0),
@@ -82,7 +82,7 @@ class CircularQueue : private std::vector<T>
     using Base = std::vector<T>;
     using typename Base::reference;
     using typename Base::const_reference;
-    const uint32_t _capacity;
+    uint32_t _capacity;
     uint32_t _head;
     uint32_t _tail;
     uint32_t _empty;
@@ -67,6 +67,7 @@ Random::~Random()
 void
 Random::init(uint32_t s)
 {
+    _seed = s;
     gen.seed(s);
 }
 
@@ -97,4 +98,4 @@ Random::unserialize(CheckpointIn &cp)
     }
 }
 
-Random random_mt;
+thread_local Random random_mt;
@@ -66,6 +66,8 @@ class Random : public Serializable
 
     std::mt19937_64 gen;
 
+    uint32_t _seed;
+
   public:
 
     Random();
@@ -74,6 +76,9 @@ class Random : public Serializable
 
     void init(uint32_t s);
 
+    /** @return the seed last passed to init() */
+    uint32_t seed() const { return _seed; }
+
     /**
      * Use the SFINAE idiom to choose an implementation based on
      * whether the type is integral or floating point.
@@ -108,6 +113,16 @@ class Random : public Serializable
     void unserialize(CheckpointIn &cp) override;
 };
 
-extern Random random_mt;
+/**
+ * The global generator. Every host thread gets its own instance so that
+ * helper threads (e.g., the functional warmer) neither race with the
+ * simulation thread nor perturb its sequence of random numbers.
+ *
+ * Note that seedRandom() only seeds the instance of the main thread; the
+ * instances of other threads start with the default seed. Helper threads
+ * that use random numbers therefore have to seed their instance
+ * explicitly, e.g., with random_mt.seed() of the main thread.
+ */
+extern thread_local Random random_mt;
 
 #endif // __BASE_RANDOM_HH__
@@ -43,6 +43,7 @@
 #ifndef __BASE_REFCNT_HH__
 #define __BASE_REFCNT_HH__
 
+#include <atomic>
 #include <type_traits>
 
 /**
@@ -101,6 +102,38 @@ class RefCounted
     void decref() const { if (--count <= 0) delete this; }
 };
 
+/**
+ * Like RefCounted, but the reference count is updated atomically. Derive
+ * from this class instead of RefCounted if RefCountingPtrs to an object
+ * are copied or dropped in multiple threads concurrently.
+ */
+class AtomicRefCounted
+{
+  private:
+    mutable std::atomic<int> count;
+
+  private:
+    AtomicRefCounted(const AtomicRefCounted &);
+    AtomicRefCounted &operator=(const AtomicRefCounted &);
+
+  public:
+    AtomicRefCounted() : count(0) {}
+
+    virtual ~AtomicRefCounted() {}
+
+    /// Increment the reference count
+    void incref() const { count.fetch_add(1, std::memory_order_relaxed); }
+
+    /// Decrement the reference count and destroy the object if all
+    /// references are gone.
+    void
+    decref() const
+    {
+        if (count.fetch_sub(1, std::memory_order_acq_rel) <= 1)
+            delete this;
+    }
+};
+
 /**
  * If you want a reference counting pointer to a mutable object,
  * create it like this:
@@ -204,6 +237,14 @@ class RefCountingPtr
     template <bool B = TisConst>
     RefCountingPtr(const NonConstT &r) { copy(r.data); }
 
+    /// Create a new reference counting pointer to a base class of the
+    /// object referenced by another one.  Adds a reference.
+    template <class U, class = typename std::enable_if<
+        std::is_convertible<U *, T *>::value &&
+        !std::is_same<typename std::remove_const<T>::type,
+                      typename std::remove_const<U>::type>::value>::type>
+    RefCountingPtr(const RefCountingPtr<U> &r) { copy(r.get()); }
+
     /// Destroy the pointer and any reference it may hold.
     ~RefCountingPtr() { del(); }
 
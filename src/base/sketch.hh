@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) 2015, Nils Asmussen
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#ifndef __BASE_SKETCH_HH__
+#define __BASE_SKETCH_HH__
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * A count-min sketch that estimates how often keys occurred in a stream,
+ * using a fixed amount of memory. The estimate of a key is never below
+ * its real count, and exceeds it by at most 2N/width with a probability
+ * of at least 1 - 2^-depth for a stream of N elements.
+ *
+ * Counters are updated conservatively, i.e., only the minimal counters of
+ * a key are incremented, which reduces the overestimation.
+ */
+class CountMinSketch
+{
+  public:
+    /**
+     * @param width the number of counters per row (rounded up to a power
+     *              of 2)
+     * @param depth the number of rows, each with its own hash function
+     */
+    CountMinSketch(size_t width, size_t depth)
+        : mask(roundPow2(width) - 1), rows(depth ? depth : 1),
+          counters((mask + 1) * rows, 0), total(0)
+    {}
+
+    /**
+     * Adds 'count' occurrences of 'key'.
+     *
+     * @return the new estimate for the key
+     */
+    uint64_t
+    add(uint64_t key, uint64_t count = 1)
+    {
+        uint64_t est = estimate(key) + count;
+        for (size_t r = 0; r < rows; r++) {
+            uint64_t &ctr = counters[index(key, r)];
+            ctr = std::max(ctr, est);
+        }
+        total += count;
+        return est;
+    }
+
+    /** @return the estimated number of occurrences of 'key' */
+    uint64_t
+    estimate(uint64_t key) const
+    {
+        uint64_t est = std::numeric_limits<uint64_t>::max();
+        for (size_t r = 0; r < rows; r++)
+            est = std::min(est, counters[index(key, r)]);
+        return est;
+    }
+
+    /** @return the number of occurrences of all keys */
+    uint64_t totalCount() const { return total; }
+
+    size_t width() const { return mask + 1; }
+    size_t depth() const { return rows; }
+
+    void
+    clear()
+    {
+        std::fill(counters.begin(), counters.end(), 0);
+        total = 0;
+    }
+
+  private:
+    static size_t
+    roundPow2(size_t n)
+    {
+        size_t p = 1;
+        while (p < n)
+            p <<= 1;
+        return p;
+    }
+
+    size_t
+    index(uint64_t key, size_t row) const
+    {
+        // splitmix64 finalizer, seeded per row
+        uint64_t x = key + (row + 1) * 0x9e3779b97f4a7c15ULL;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        x = x ^ (x >> 31);
+        return row * (mask + 1) + (x & mask);
+    }
+
+    const size_t mask;
+    const size_t rows;
+    std::vector<uint64_t> counters;
+    uint64_t total;
+};
+
+/**
+ * Keeps the K keys with the largest counts, together with some
+ * user-defined information per key, in a min-heap of fixed size. Combined
+ * with a CountMinSketch, this finds the heavy hitters of a stream without
+ * storing all keys.
+ */
+template <class Info>
+class TopK
+{
+  public:
+    struct Entry
+    {
+        uint64_t key;
+        uint64_t count;
+        Info info;
+    };
+
+    explicit TopK(size_t k)
+        : maxSize(k)
+    {
+        heap.reserve(k);
+        positions.reserve(k);
+    }
+
+    /**
+     * Records that 'key' now has the (estimated) count 'count'. The key
+     * replaces the entry with the smallest count, if the heap is full and
+     * 'count' is larger than that. The information of new entries is
+     * value-initialized.
+     *
+     * @return the entry of the key, or nullptr if it is not among the top K
+     */
+    Entry *
+    update(uint64_t key, uint64_t count)
+    {
+        auto it = positions.find(key);
+        if (it != positions.end()) {
+            size_t i = it->second;
+            heap[i].count = std::max(heap[i].count, count);
+            return &heap[siftDown(i)];
+        }
+
+        if (heap.size() < maxSize) {
+            heap.push_back(Entry{key, count, Info()});
+            positions[key] = heap.size() - 1;
+            return &heap[siftUp(heap.size() - 1)];
+        }
+
+        if (maxSize == 0 || count <= heap[0].count)
+            return nullptr;
+
+        positions.erase(heap[0].key);
+        heap[0] = Entry{key, count, Info()};
+        positions[key] = 0;
+        return &heap[siftDown(0)];
+    }
+
+    /** @return the entry of the key, or nullptr if it is not in the top K */
+    const Entry *
+    find(uint64_t key) const
+    {
+        auto it = positions.find(key);
+        return it == positions.end() ? nullptr : &heap[it->second];
+    }
+
+    /** @return all entries, ordered by decreasing count */
+    std::vector<Entry>
+    sorted() const
+    {
+        std::vector<Entry> res(heap);
+        std::sort(res.begin(), res.end(),
+            [](const Entry &a, const Entry &b) {
+                return a.count > b.count ||
+                       (a.count == b.count && a.key < b.key);
+            });
+        return res;
+    }
+
+    size_t size() const { return heap.size(); }
+    size_t capacity() const { return maxSize; }
+
+    void
+    clear()
+    {
+        heap.clear();
+        positions.clear();
+    }
+
+  private:
+    void
+    swap(size_t a, size_t b)
+    {
+        std::swap(heap[a], heap[b]);
+        positions[heap[a].key] = a;
+        positions[heap[b].key] = b;
+    }
+
+    size_t
+    siftUp(size_t i)
+    {
+        while (i > 0) {
+            size_t parent = (i - 1) / 2;
+            if (heap[parent].count <= heap[i].count)
+                break;
+            swap(i, parent);
+            i = parent;
+        }
+        return i;
+    }
+
+    size_t
+    siftDown(size_t i)
+    {
+        for (;;) {
+            size_t min = i;
+            size_t l = 2 * i + 1, r = 2 * i + 2;
+            if (l < heap.size() && heap[l].count < heap[min].count)
+                min = l;
+            if (r < heap.size() && heap[r].count < heap[min].count)
+                min = r;
+            if (min == i)
+                return i;
+            swap(i, min);
+            i = min;
+        }
+    }
+
+    const size_t maxSize;
+    std::vector<Entry> heap;
+    std::unordered_map<uint64_t, size_t> positions;
+};
+
+#endif // __BASE_SKETCH_HH__
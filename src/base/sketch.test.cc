@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2015, Nils Asmussen
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <map>
+
+#include "base/sketch.hh"
+
+// Without collisions, the estimates are exact
+TEST(CountMinSketchTest, Exact)
+{
+    CountMinSketch cms(1024, 4);
+    EXPECT_EQ(1024, cms.width());
+    EXPECT_EQ(4, cms.depth());
+
+    EXPECT_EQ(1, cms.add(0x1000));
+    EXPECT_EQ(2, cms.add(0x1000));
+    EXPECT_EQ(7, cms.add(0x2000, 7));
+
+    EXPECT_EQ(2, cms.estimate(0x1000));
+    EXPECT_EQ(7, cms.estimate(0x2000));
+    EXPECT_EQ(9, cms.totalCount());
+
+    cms.clear();
+    EXPECT_EQ(0, cms.estimate(0x1000));
+    EXPECT_EQ(0, cms.totalCount());
+}
+
+// Estimates never fall below the real counts, even if keys collide
+TEST(CountMinSketchTest, NoUnderestimate)
+{
+    CountMinSketch cms(16, 2);
+    std::map<uint64_t, uint64_t> real;
+    for (uint64_t i = 0; i < 1000; i++) {
+        uint64_t key = (i * 7919) % 100;
+        cms.add(key);
+        real[key]++;
+    }
+
+    for (auto &r : real)
+        EXPECT_LE(r.second, cms.estimate(r.first));
+}
+
+// The width is rounded up to a power of 2
+TEST(CountMinSketchTest, Width)
+{
+    CountMinSketch cms(1000, 0);
+    EXPECT_EQ(1024, cms.width());
+    EXPECT_EQ(1, cms.depth());
+}
+
+struct Info
+{
+    int val;
+};
+
+// The heap keeps the keys with the largest counts
+TEST(TopKTest, Replace)
+{
+    TopK<Info> top(3);
+    EXPECT_NE(nullptr, top.update(1, 10));
+    EXPECT_NE(nullptr, top.update(2, 20));
+    EXPECT_NE(nullptr, top.update(3, 5));
+    EXPECT_EQ(3, top.size());
+
+    // smaller than the minimum
+    EXPECT_EQ(nullptr, top.update(4, 5));
+    EXPECT_EQ(nullptr, top.find(4));
+
+    // replaces key 3
+    auto *e = top.update(5, 15);
+    ASSERT_NE(nullptr, e);
+    EXPECT_EQ(5, e->key);
+    EXPECT_EQ(15, e->count);
+    EXPECT_EQ(0, e->info.val);
+    EXPECT_EQ(nullptr, top.find(3));
+
+    auto entries = top.sorted();
+    ASSERT_EQ(3, entries.size());
+    EXPECT_EQ(2, entries[0].key);
+    EXPECT_EQ(5, entries[1].key);
+    EXPECT_EQ(1, entries[2].key);
+}
+
+// Updates of existing keys keep their information and reorder the heap
+TEST(TopKTest, UpdateExisting)
+{
+    TopK<Info> top(2);
+    top.update(1, 1)->info.val = 42;
+    top.update(2, 2);
+
+    auto *e = top.update(1, 3);
+    ASSERT_NE(nullptr, e);
+    EXPECT_EQ(42, e->info.val);
+
+    // key 2 is now the minimum
+    EXPECT_NE(nullptr, top.update(3, 4));
+    EXPECT_EQ(nullptr, top.find(2));
+    ASSERT_NE(nullptr, top.find(1));
+    EXPECT_EQ(42, top.find(1)->info.val);
+
+    top.clear();
+    EXPECT_EQ(0, top.size());
+    EXPECT_EQ(2, top.capacity());
+}
+
+// Combined with a sketch, the heavy hitters of a stream are found
+TEST(TopKTest, HeavyHitters)
+{
+    CountMinSketch cms(256, 4);
+    TopK<Info> top(4);
+    for (uint64_t i = 0; i < 10000; i++) {
+        // keys 0..3 are hot, all others occur once
+        uint64_t key = (i % 2) ? (i % 8) / 2 : 100 + i;
+        top.update(key, cms.add(key));
+    }
+
+    auto entries = top.sorted();
+    ASSERT_EQ(4, entries.size());
+    for (auto &e : entries)
+        EXPECT_LT(e.key, 4);
+}
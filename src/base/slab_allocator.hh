@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2015, Nils Asmussen
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#ifndef __BASE_SLAB_ALLOCATOR_HH__
+#define __BASE_SLAB_ALLOCATOR_HH__
+
+#include <cstddef>
+#include <cstdlib>
+#include <map>
+#include <new>
+#include <vector>
+
+/**
+ * A free-list allocator for objects of one fixed size. Memory is reserved
+ * in slabs of many objects at once and never returned to the system
+ * before the allocator is destroyed. This avoids one heap allocation per
+ * object and places objects allocated one after another next to each
+ * other.
+ *
+ * The allocator is not thread-safe.
+ */
+class SlabAllocator
+{
+  public:
+    explicit SlabAllocator(size_t obj_size, size_t objs_per_slab = 1024)
+        : objSize(roundUp(obj_size)),
+          objsPerSlab(objs_per_slab ? objs_per_slab : 1),
+          freeList(nullptr), inUse(0)
+    {}
+
+    ~SlabAllocator()
+    {
+        for (auto slab : slabs)
+            std::free(slab);
+    }
+
+    SlabAllocator(const SlabAllocator &) = delete;
+    SlabAllocator &operator=(const SlabAllocator &) = delete;
+
+    /** @return memory for one object */
+    void *
+    allocate()
+    {
+        if (!freeList)
+            grow();
+
+        FreeObj *obj = freeList;
+        freeList = obj->next;
+        inUse++;
+        return obj;
+    }
+
+    /** Returns the given object, obtained by allocate(), to the free list */
+    void
+    deallocate(void *ptr)
+    {
+        FreeObj *obj = static_cast<FreeObj*>(ptr);
+        obj->next = freeList;
+        freeList = obj;
+        inUse--;
+    }
+
+    /** @return the size of each object, including padding */
+    size_t objectSize() const { return objSize; }
+
+    /** @return the number of currently allocated objects */
+    size_t objectsInUse() const { return inUse; }
+
+    /** @return the number of bytes reserved for all slabs */
+    size_t
+    bytesReserved() const
+    {
+        return slabs.size() * objSize * objsPerSlab;
+    }
+
+    /**
+     * Returns a shared allocator for objects of the given size. The
+     * allocators are never destroyed, so that objects with static storage
+     * duration can safely be freed at exit.
+     */
+    static SlabAllocator &
+    forSize(size_t obj_size)
+    {
+        static std::map<size_t, SlabAllocator*> allocators;
+        SlabAllocator *&alloc = allocators[roundUp(obj_size)];
+        if (!alloc)
+            alloc = new SlabAllocator(obj_size);
+        return *alloc;
+    }
+
+  private:
+    struct FreeObj
+    {
+        FreeObj *next;
+    };
+
+    static size_t
+    roundUp(size_t size)
+    {
+        const size_t align = alignof(std::max_align_t);
+        if (size < sizeof(FreeObj))
+            size = sizeof(FreeObj);
+        return (size + align - 1) & ~(align - 1);
+    }
+
+    void
+    grow()
+    {
+        char *slab = static_cast<char*>(std::malloc(objSize * objsPerSlab));
+        if (!slab)
+            throw std::bad_alloc();
+        slabs.push_back(slab);
+
+        // link the objects in address order
+        for (size_t i = objsPerSlab; i-- > 0; ) {
+            FreeObj *obj = reinterpret_cast<FreeObj*>(slab + i * objSize);
+            obj->next = freeList;
+            freeList = obj;
+        }
+    }
+
+    const size_t objSize;
+    const size_t objsPerSlab;
+    std::vector<void*> slabs;
+    FreeObj *freeList;
+    size_t inUse;
+};
+
+#endif // __BASE_SLAB_ALLOCATOR_HH__
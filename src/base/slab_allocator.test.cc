@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2015, Nils Asmussen
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <set>
+
+#include "base/slab_allocator.hh"
+
+// Object sizes are padded to the maximum alignment
+TEST(SlabAllocatorTest, ObjectSize)
+{
+    SlabAllocator alloc(1);
+    EXPECT_EQ(0, alloc.objectSize() % alignof(std::max_align_t));
+    EXPECT_LE(1, alloc.objectSize());
+
+    SlabAllocator alloc64(64);
+    EXPECT_EQ(64, alloc64.objectSize());
+}
+
+// Objects of one slab are distinct, aligned and adjacent
+TEST(SlabAllocatorTest, Contiguous)
+{
+    SlabAllocator alloc(64, 16);
+    std::set<uintptr_t> addrs;
+    uintptr_t prev = 0;
+    for (int i = 0; i < 16; i++) {
+        uintptr_t addr = reinterpret_cast<uintptr_t>(alloc.allocate());
+        EXPECT_EQ(0, addr % alignof(std::max_align_t));
+        if (i > 0) {
+            EXPECT_EQ(prev + 64, addr);
+        }
+        prev = addr;
+        addrs.insert(addr);
+    }
+    EXPECT_EQ(16, addrs.size());
+    EXPECT_EQ(16, alloc.objectsInUse());
+    EXPECT_EQ(16 * 64, alloc.bytesReserved());
+
+    // the next allocation requires a new slab
+    alloc.allocate();
+    EXPECT_EQ(2 * 16 * 64, alloc.bytesReserved());
+}
+
+// Freed objects are reused before new slabs are reserved
+TEST(SlabAllocatorTest, Reuse)
+{
+    SlabAllocator alloc(32, 4);
+    void *objs[4];
+    for (int i = 0; i < 4; i++)
+        objs[i] = alloc.allocate();
+
+    alloc.deallocate(objs[2]);
+    EXPECT_EQ(3, alloc.objectsInUse());
+    EXPECT_EQ(objs[2], alloc.allocate());
+    EXPECT_EQ(4 * 32, alloc.bytesReserved());
+}
+
+// Allocators are shared per (padded) object size
+TEST(SlabAllocatorTest, ForSize)
+{
+    SlabAllocator &a = SlabAllocator::forSize(64);
+    SlabAllocator &b = SlabAllocator::forSize(64);
+    SlabAllocator &c = SlabAllocator::forSize(128);
+    EXPECT_EQ(&a, &b);
+    EXPECT_NE(&a, &c);
+}
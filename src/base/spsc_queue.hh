@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2015, Nils Asmussen
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#ifndef __BASE_SPSC_QUEUE_HH__
+#define __BASE_SPSC_QUEUE_HH__
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+#include "base/intmath.hh"
+
+/**
+ * A bounded lock-free queue for exactly one producer and one consumer
+ * thread. The capacity is rounded up to a power of two.
+ *
+ * The producer and the consumer each own one index and only read the other
+ * one. Both keep a cached copy of the other index to avoid touching the
+ * shared cache line on every operation.
+ */
+template<typename T>
+class SPSCQueue
+{
+  public:
+    explicit SPSCQueue(size_t capacity)
+        : slots(ceilPow2(capacity < 2 ? 2 : capacity)),
+          mask(slots.size() - 1),
+          head(0), tail(0), headCache(0), tailCache(0)
+    {}
+
+    SPSCQueue(const SPSCQueue &) = delete;
+    SPSCQueue &operator=(const SPSCQueue &) = delete;
+
+    /** @return the maximum number of items in the queue */
+    size_t capacity() const { return slots.size(); }
+
+    /**
+     * Appends an item (producer only).
+     *
+     * @return false if the queue is full
+     */
+    bool
+    tryPush(const T &item)
+    {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - headCache == slots.size()) {
+            headCache = head.load(std::memory_order_acquire);
+            if (t - headCache == slots.size())
+                return false;
+        }
+
+        slots[t & mask] = item;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Removes the oldest item (consumer only).
+     *
+     * @return false if the queue is empty
+     */
+    bool
+    tryPop(T &item)
+    {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == tailCache) {
+            tailCache = tail.load(std::memory_order_acquire);
+            if (h == tailCache)
+                return false;
+        }
+
+        item = slots[h & mask];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** @return true if the queue is empty (exact only for the consumer) */
+    bool
+    empty() const
+    {
+        return head.load(std::memory_order_acquire) ==
+               tail.load(std::memory_order_acquire);
+    }
+
+  private:
+    std::vector<T> slots;
+    const size_t mask;
+
+    // the index of the next item to pop, written by the consumer
+    alignas(64) std::atomic<size_t> head;
+    // the index of the next free slot, written by the producer
+    alignas(64) std::atomic<size_t> tail;
+
+    // the producer's view of head
+    alignas(64) size_t headCache;
+    // the consumer's view of tail
+    alignas(64) size_t tailCache;
+};
+
+#endif // __BASE_SPSC_QUEUE_HH__
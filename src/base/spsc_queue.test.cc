@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2015, Nils Asmussen
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include "base/spsc_queue.hh"
+
+// The capacity is rounded up to a power of two
+TEST(SPSCQueueTest, Capacity)
+{
+    SPSCQueue<int> q(5);
+    EXPECT_EQ(8, q.capacity());
+    EXPECT_TRUE(q.empty());
+}
+
+// Items are popped in order and a full queue rejects pushes
+TEST(SPSCQueueTest, PushPopFull)
+{
+    SPSCQueue<int> q(4);
+    for (int i = 0; i < 4; i++)
+        EXPECT_TRUE(q.tryPush(i));
+    EXPECT_FALSE(q.tryPush(4));
+
+    int v;
+    EXPECT_TRUE(q.tryPop(v));
+    EXPECT_EQ(0, v);
+    EXPECT_TRUE(q.tryPush(4));
+
+    for (int i = 1; i <= 4; i++) {
+        EXPECT_TRUE(q.tryPop(v));
+        EXPECT_EQ(i, v);
+    }
+    EXPECT_FALSE(q.tryPop(v));
+    EXPECT_TRUE(q.empty());
+}
+
+// A producer and a consumer thread see every item exactly once, in order
+TEST(SPSCQueueTest, TwoThreads)
+{
+    const unsigned count = 100000;
+    SPSCQueue<unsigned> q(64);
+
+    std::thread producer([&q, count] {
+        for (unsigned i = 0; i < count; i++) {
+            while (!q.tryPush(i))
+                std::this_thread::yield();
+        }
+    });
+
+    unsigned expected = 0;
+    bool inOrder = true;
+    while (expected < count) {
+        unsigned v;
+        if (q.tryPop(v)) {
+            inOrder &= v == expected;
+            expected++;
+        }
+        else
+            std::this_thread::yield();
+    }
+    producer.join();
+
+    EXPECT_TRUE(inOrder);
+    EXPECT_TRUE(q.empty());
+}
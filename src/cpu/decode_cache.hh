@@ -31,6 +31,8 @@
 #ifndef __CPU_DECODE_CACHE_HH__
 #define __CPU_DECODE_CACHE_HH__
 
+#include <functional>
+#include <mutex>
 #include <unordered_map>
 
 #include "arch/isa_traits.hh"
@@ -43,6 +45,10 @@ namespace TheISA
     class Decoder;
 }
 
+/// Whether the decoders of all CPUs share their decoded instructions (set
+/// by the shared_decode_cache parameter of Root).
+extern bool SharedDecodeCache;
+
 namespace DecodeCache
 {
 
@@ -50,6 +56,72 @@ namespace DecodeCache
 template <typename EMI>
 using InstMap = std::unordered_map<EMI, StaticInstPtr>;
 
+/**
+ * A map from machine instructions to decoded instructions that is shared
+ * by all decoders of an ISA in the process. CPUs that execute the same
+ * binaries thus decode every instruction only once and share the
+ * resulting StaticInst. Lookups are thread-safe, so that CPUs in
+ * different event queues can use the map in parallel. To keep the
+ * contention low, the map is split into shards with separate locks.
+ */
+template <typename EMI>
+class SharedInstMap
+{
+  protected:
+    static const size_t NumShards = 64;
+
+    struct Shard {
+        std::mutex lock;
+        InstMap<EMI> insts;
+    };
+    Shard shards[NumShards];
+
+    Shard &
+    getShard(const EMI &emi)
+    {
+        size_t hash = std::hash<EMI>()(emi);
+        hash ^= (hash >> 32) ^ (hash >> 16);
+        return shards[hash % NumShards];
+    }
+
+  public:
+    /// Whether decoders use the shared map instead of their own one.
+    static bool enabled() { return SharedDecodeCache; }
+
+    /// The map for this ISA.
+    static SharedInstMap &
+    instance()
+    {
+        static SharedInstMap map;
+        return map;
+    }
+
+    /// Look up a decoded instruction.
+    /// @param emi The machine instruction.
+    /// @retval The decoded instruction or null if there is none yet.
+    StaticInstPtr
+    lookup(const EMI &emi)
+    {
+        Shard &shard = getShard(emi);
+        std::lock_guard<std::mutex> guard(shard.lock);
+        auto it = shard.insts.find(emi);
+        return it != shard.insts.end() ? it->second : StaticInstPtr();
+    }
+
+    /// Insert a decoded instruction. If another decoder has inserted the
+    /// same machine instruction in the meantime, its instruction is kept.
+    /// @param emi The machine instruction.
+    /// @param si The decoded instruction.
+    /// @retval The instruction to use for emi.
+    StaticInstPtr
+    insert(const EMI &emi, const StaticInstPtr &si)
+    {
+        Shard &shard = getShard(emi);
+        std::lock_guard<std::mutex> guard(shard.lock);
+        return shard.insts.emplace(emi, si).first->second;
+    }
+};
+
 /// A sparse map from an Addr to a Value, stored in page chunks.
 template<class Value>
 class AddrMap
@@ -0,0 +1,50 @@
+# Copyright (c) 2016 Nils Asmussen
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#
+# 1. Redistributions of source code must retain the above copyright notice, this
+#    list of conditions and the following disclaimer.
+# 2. Redistributions in binary form must reproduce the above copyright notice,
+#    this list of conditions and the following disclaimer in the documentation
+#    and/or other materials provided with the distribution.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+# ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+# DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+# ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+# (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+# LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+# ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+# SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+# The views and conclusions contained in the software and documentation are those
+# of the authors and should not be interpreted as representing official policies,
+# either expressed or implied, of the FreeBSD Project.
+
+from DtuAccel import DtuAccel
+from m5.params import *
+from m5.proxy import *
+
+class GemmDataflow(Enum): vals = ['WeightStationary', 'OutputStationary']
+
+class DtuAccelGemm(DtuAccel):
+    type = 'DtuAccelGemm'
+    cxx_header = "cpu/dtu-accel-gemm/accelerator.hh"
+
+    array_rows = Param.Unsigned(16, "Number of rows of the systolic array")
+    array_cols = Param.Unsigned(16, "Number of columns of the systolic array")
+    dataflow = Param.GemmDataflow('WeightStationary',
+        "What stays in the processing elements")
+
+    spm_banks = Param.Unsigned(8, "Number of SPM banks feeding the array")
+    bank_width = Param.Unsigned(8, "Bytes per cycle delivered by each bank")
+
+    tile_m = Param.Unsigned(32, "Rows of the input tiles")
+    tile_n = Param.Unsigned(32, "Columns of the weight tiles")
+    tile_k = Param.Unsigned(32, "Reduction depth of the tiles")
+
+    buf_size = Param.MemorySize("16kB", "The size of the tile buffer")
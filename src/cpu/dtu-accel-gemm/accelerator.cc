@@ -0,0 +1,810 @@
+/*
+ * Copyright (c) 2016, Nils Asmussen
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#include "cpu/dtu-accel-gemm/accelerator.hh"
+#include "cpu/dtu-accel-gemm/kernels.hh"
+#include "base/intmath.hh"
+#include "debug/DtuAccelGemm.hh"
+#include "debug/DtuAccelGemmState.hh"
+#include "mem/dtu/dtu.hh"
+#include "mem/dtu/regfile.hh"
+
+#include <algorithm>
+
+static const char *stateNames[] =
+{
+    "IDLE",
+
+    "FETCH_MSG",
+    "READ_MSG_ADDR",
+    "READ_MSG",
+
+    "READ_IN",
+    "READ_IN_WAIT",
+    "READ_WEIGHTS",
+    "READ_WEIGHTS_WAIT",
+
+    "LOAD_IN",
+    "LOAD_WEIGHTS",
+
+    "STORE_OUT",
+    "WRITE_OUT",
+    "WRITE_OUT_WAIT",
+
+    "STORE_REPLY",
+    "SEND_REPLY",
+    "REPLY_WAIT",
+    "REPLY_ERROR",
+
+    "CTXSW",
+
+    "SYSCALL",
+};
+
+DtuAccelGemm::DtuAccelGemm(const DtuAccelGemmParams *p)
+  : DtuAccel(p),
+    arrayRows(p->array_rows),
+    arrayCols(p->array_cols),
+    dataflow(p->dataflow),
+    spmBW(p->spm_banks * p->bank_width),
+    tileM(p->tile_m),
+    tileN(p->tile_n),
+    tileK(p->tile_k),
+    bufSize(p->buf_size),
+    weightsAddr(BUF_ADDR + tileM * tileK * sizeof(float)),
+    outAddr(weightsAddr + tileK * tileN * sizeof(float)),
+    irqPending(false),
+    memPending(false),
+    state(State::IDLE),
+    lastState(State::CTXSW),    // something different
+    msgAddr(),
+    job(),
+    outWidth(),
+    m0(),
+    n0(),
+    k0(),
+    row(),
+    col(),
+    spmPos(),
+    jobStart(),
+    inTile(tileM * tileK * sizeof(float)),
+    weightTile(tileK * tileN * sizeof(float)),
+    outTile(tileM * tileN * sizeof(float)),
+    accInt(tileM * tileN),
+    accFloat(tileM * tileN),
+    ctx(),
+    sysc(this),
+    yield(this, &sysc),
+    ctxsw(this)
+{
+    static_assert((sizeof(stateNames) / sizeof(stateNames[0]) ==
+                  static_cast<size_t>(State::SYSCALL) + 1), "Missmatch");
+    static_assert(sizeof(MessageHeader) + sizeof(Job) <= MSG_SIZE,
+                  "Job does not fit into a message");
+
+    fatal_if(arrayRows == 0 || arrayCols == 0, "Empty systolic array\n");
+    fatal_if(spmBW == 0, "The SPM needs at least one bank\n");
+    fatal_if(tileM == 0 || tileN == 0 || tileK == 0, "Empty tiles\n");
+    fatal_if(outAddr + tileM * tileN * sizeof(float) > BUF_ADDR + bufSize,
+             "The tiles do not fit into the buffer of %lu bytes\n", bufSize);
+
+    yield.start();
+}
+
+void
+DtuAccelGemm::regStats()
+{
+    DtuAccel::regStats();
+
+    jobs
+        .name(name() + ".jobs")
+        .desc("Number of completed jobs");
+    failedJobs
+        .name(name() + ".failedJobs")
+        .desc("Number of jobs that failed");
+    tiles
+        .name(name() + ".tiles")
+        .desc("Number of computed tiles");
+    macs
+        .name(name() + ".macs")
+        .desc("Number of multiply-accumulate operations");
+    arrayCycles
+        .name(name() + ".arrayCycles")
+        .desc("Cycles the systolic array was busy");
+    stallCycles
+        .name(name() + ".stallCycles")
+        .desc("Cycles the array waited for the SPM banks");
+    readBytes
+        .name(name() + ".readBytes")
+        .desc("Bytes read through the DTU");
+    writtenBytes
+        .name(name() + ".writtenBytes")
+        .desc("Bytes written through the DTU");
+    jobLatency
+        .init(16)
+        .name(name() + ".jobLatency")
+        .desc("Cycles from receiving a job until its reply")
+        .flags(Stats::nozero);
+    arrayUtil
+        .name(name() + ".arrayUtil")
+        .desc("Fraction of PE cycles doing useful work while computing")
+        .precision(4);
+    arrayUtil = macs / ((arrayCycles + stallCycles) *
+                        Stats::constant(arrayRows * arrayCols));
+}
+
+std::string DtuAccelGemm::getStateName() const
+{
+    std::ostringstream os;
+    os << stateNames[static_cast<size_t>(state)];
+    if (state == State::IDLE)
+        os << ":" << yield.stateName();
+    else if (state == State::SYSCALL)
+        os << ":" << sysc.stateName();
+    else if (state == State::CTXSW)
+        os << ":" << ctxsw.stateName();
+    return os.str();
+}
+
+bool
+DtuAccelGemm::startJob()
+{
+    if (job.dtype != INT8 && job.dtype != FP32)
+        return false;
+
+    if (job.op == CONV)
+    {
+        if (job.stride == 0 || job.c == 0 || job.r == 0 || job.s == 0 ||
+            job.r > job.h || job.s > job.w)
+            return false;
+
+        outWidth = (job.w - job.s) / job.stride + 1;
+        job.m = ((job.h - job.r) / job.stride + 1) * outWidth;
+        job.k = static_cast<uint64_t>(job.r) * job.s * job.c;
+    }
+    else if (job.op != GEMM)
+        return false;
+
+    if (job.m == 0 || job.n == 0 || job.k == 0)
+        return false;
+
+    DPRINTF(DtuAccelGemm, "Starting %s job: m=%llu n=%llu k=%llu (%s)\n",
+            job.op == GEMM ? "GEMM" : "CONV", job.m, job.n, job.k,
+            job.dtype == INT8 ? "int8" : "fp32");
+
+    m0 = 0;
+    n0 = 0;
+    startTile();
+    return true;
+}
+
+void
+DtuAccelGemm::finishJob(Error err)
+{
+    Cycles latency = ticksToCycles(curTick() - jobStart);
+
+    DPRINTF(DtuAccelGemm, "Finished job with error %d after %llu cycles\n",
+            err, latency);
+
+    if (err == Error::NONE)
+        jobs++;
+    else
+        failedJobs++;
+    jobLatency.sample(latency);
+
+    reply.msg.err = err;
+    reply.msg.cycles = latency;
+    state = State::STORE_REPLY;
+}
+
+void
+DtuAccelGemm::startTile()
+{
+    k0 = 0;
+    row = 0;
+    col = 0;
+
+    size_t count = tileRows() * tileCols();
+    if (job.dtype == INT8)
+        std::fill(accInt.begin(), accInt.begin() + count, 0);
+    else
+        std::fill(accFloat.begin(), accFloat.begin() + count, 0.0f);
+}
+
+bool
+DtuAccelGemm::nextTile()
+{
+    n0 += tileN;
+    if (n0 >= job.n)
+    {
+        n0 = 0;
+        m0 += tileM;
+    }
+    return m0 < job.m;
+}
+
+Addr
+DtuAccelGemm::inOffset(size_t tileRow, uint64_t k, size_t *len) const
+{
+    uint64_t i = m0 + tileRow;
+    uint64_t end = k0 + tileDepth();
+
+    if (job.op == GEMM)
+    {
+        *len = end - k;
+        return (i * job.k + k) * elemSize();
+    }
+
+    // the patch of an output pixel consists of r input rows with s * c
+    // contiguous elements each
+    uint64_t patchRow = static_cast<uint64_t>(job.s) * job.c;
+    uint64_t pr = k / patchRow;
+    uint64_t pc = k % patchRow;
+    uint64_t y = (i / outWidth) * job.stride + pr;
+    uint64_t x = (i % outWidth) * job.stride;
+    *len = std::min(end - k, patchRow - pc);
+    return ((y * job.w + x) * job.c + pc) * elemSize();
+}
+
+Cycles
+DtuAccelGemm::tileCycles(size_t rows, size_t cols, size_t depth)
+{
+    uint64_t cycles;
+    uint64_t demand;
+    if (dataflow == Enums::WeightStationary)
+    {
+        // a block of weights is preloaded into the array, then the input
+        // rows stream through it and the partial sums leave at the bottom
+        uint64_t passes = divCeil(depth, arrayRows) * divCeil(cols, arrayCols);
+        cycles = passes * (arrayRows + rows + arrayRows + arrayCols - 2);
+        demand = arrayRows * elemSize();
+    }
+    else
+    {
+        // every PE accumulates one output, while the inputs and weights
+        // stream in from the left and the top
+        uint64_t passes = divCeil(rows, arrayRows) * divCeil(cols, arrayCols);
+        cycles = passes * (depth + arrayRows + arrayCols - 2);
+        demand = (arrayRows + arrayCols) * elemSize();
+    }
+    arrayCycles += cycles;
+
+    // the SPM banks might not be able to feed the array at full speed
+    if (demand > spmBW)
+    {
+        uint64_t stall = divCeil(cycles * demand, spmBW) - cycles;
+        stallCycles += stall;
+        cycles += stall;
+    }
+    return Cycles(cycles);
+}
+
+void
+DtuAccelGemm::computeTile()
+{
+    size_t rows = tileRows();
+    size_t cols = tileCols();
+    size_t depth = tileDepth();
+
+    if (job.dtype == INT8)
+    {
+        gemmTile(accInt.data(),
+                 reinterpret_cast<const int8_t*>(inTile.data()),
+                 reinterpret_cast<const int8_t*>(weightTile.data()),
+                 rows, cols, depth);
+    }
+    else
+    {
+        gemmTile(accFloat.data(),
+                 reinterpret_cast<const float*>(inTile.data()),
+                 reinterpret_cast<const float*>(weightTile.data()),
+                 rows, cols, depth);
+    }
+
+    tiles++;
+    macs += rows * cols * depth;
+}
+
+void
+DtuAccelGemm::storeOutput()
+{
+    size_t size = tileRows() * tileCols() * sizeof(float);
+    if (job.dtype == INT8)
+        memcpy(outTile.data(), accInt.data(), size);
+    else
+        memcpy(outTile.data(), accFloat.data(), size);
+}
+
+void
+DtuAccelGemm::completeRequest(PacketPtr pkt)
+{
+    RequestPtr req = pkt->req;
+
+    if (state != lastState ||
+        (state == State::CTXSW && ctxsw.hasStateChanged()) ||
+        (state == State::SYSCALL && sysc.hasStateChanged()) ||
+        (state == State::IDLE && yield.hasStateChanged()))
+    {
+        DPRINTF(DtuAccelGemmState, "[%s] Got response from memory\n",
+            getStateName().c_str());
+        lastState = state;
+    }
+
+    const uint8_t *pkt_data = pkt->getConstPtr<uint8_t>();
+
+    Cycles delay(1);
+    if (pkt->isError())
+    {
+        warn("%s access failed at %#x\n",
+             pkt->isWrite() ? "Write" : "Read", req->getPaddr());
+    }
+    else
+    {
+        switch(state)
+        {
+            case State::IDLE:
+            {
+                if (yield.handleMemResp(pkt))
+                {
+                    if (irqPending)
+                        irqPending = false;
+                    state = State::CTXSW;
+                }
+                break;
+            }
+
+            case State::CTXSW:
+            {
+                if(ctxsw.handleMemResp(pkt))
+                    state = State::FETCH_MSG;
+                break;
+            }
+
+            case State::FETCH_MSG:
+            {
+                state = State::READ_MSG_ADDR;
+                break;
+            }
+            case State::READ_MSG_ADDR:
+            {
+                const RegFile::reg_t *regs = pkt->getConstPtr<RegFile::reg_t>();
+                if(regs[0])
+                {
+                    msgAddr = regs[0];
+                    DPRINTF(DtuAccelGemm, "Received message @ %p\n", msgAddr);
+                    state = State::READ_MSG;
+                }
+                else
+                {
+                    yield.start();
+                    state = State::IDLE;
+                }
+                break;
+            }
+            case State::READ_MSG:
+            {
+                memcpy(&job, pkt_data + sizeof(MessageHeader), sizeof(job));
+                jobStart = curTick();
+
+                if (startJob())
+                    state = State::READ_IN;
+                else
+                    finishJob(Error::INV_ARGS);
+                break;
+            }
+
+            case State::READ_IN:
+            {
+                state = State::READ_IN_WAIT;
+                break;
+            }
+            case State::READ_IN_WAIT:
+            {
+                Dtu::Command::Bits cmd =
+                    *reinterpret_cast<const RegFile::reg_t*>(pkt_data);
+                if (cmd.opcode == 0)
+                {
+                    if (cmd.error != 0)
+                        finishJob(Error::XFER_FAILED);
+                    else if (row < tileRows())
+                        state = State::READ_IN;
+                    else
+                    {
+                        row = 0;
+                        state = State::READ_WEIGHTS;
+                    }
+                }
+                break;
+            }
+
+            case State::READ_WEIGHTS:
+            {
+                state = State::READ_WEIGHTS_WAIT;
+                break;
+            }
+            case State::READ_WEIGHTS_WAIT:
+            {
+                Dtu::Command::Bits cmd =
+                    *reinterpret_cast<const RegFile::reg_t*>(pkt_data);
+                if (cmd.opcode == 0)
+                {
+                    if (cmd.error != 0)
+                        finishJob(Error::XFER_FAILED);
+                    else if (row < tileDepth())
+                        state = State::READ_WEIGHTS;
+                    else
+                    {
+                        spmPos = 0;
+                        state = State::LOAD_IN;
+                    }
+                }
+                break;
+            }
+
+            case State::LOAD_IN:
+            {
+                memcpy(inTile.data() + spmPos, pkt_data, pkt->getSize());
+                spmPos += pkt->getSize();
+                if (spmPos == tileRows() * tileDepth() * elemSize())
+                {
+                    spmPos = 0;
+                    state = State::LOAD_WEIGHTS;
+                }
+                break;
+            }
+            case State::LOAD_WEIGHTS:
+            {
+                memcpy(weightTile.data() + spmPos, pkt_data, pkt->getSize());
+                spmPos += pkt->getSize();
+                if (spmPos == tileDepth() * tileCols() * elemSize())
+                {
+                    computeTile();
+                    delay = tileCycles(tileRows(), tileCols(), tileDepth());
+
+                    k0 += tileK;
+                    if (k0 < job.k)
+                    {
+                        row = 0;
+                        col = k0;
+                        state = State::READ_IN;
+                    }
+                    else
+                    {
+                        storeOutput();
+                        spmPos = 0;
+                        state = State::STORE_OUT;
+                    }
+                }
+                break;
+            }
+
+            case State::STORE_OUT:
+            {
+                spmPos += pkt->getSize();
+                if (spmPos == tileRows() * tileCols() * sizeof(float))
+                {
+                    row = 0;
+                    state = State::WRITE_OUT;
+                }
+                break;
+            }
+            case State::WRITE_OUT:
+            {
+                state = State::WRITE_OUT_WAIT;
+                break;
+            }
+            case State::WRITE_OUT_WAIT:
+            {
+                Dtu::Command::Bits cmd =
+                    *reinterpret_cast<const RegFile::reg_t*>(pkt_data);
+                if (cmd.opcode == 0)
+                {
+                    if (cmd.error != 0)
+                        finishJob(Error::XFER_FAILED);
+                    else if (row < tileRows())
+                        state = State::WRITE_OUT;
+                    else if (nextTile())
+                    {
+                        startTile();
+                        state = State::READ_IN;
+                    }
+                    else
+                        finishJob(Error::NONE);
+                }
+                break;
+            }
+
+            case State::STORE_REPLY:
+            {
+                state = State::SEND_REPLY;
+                break;
+            }
+            case State::SEND_REPLY:
+            {
+                state = State::REPLY_WAIT;
+                break;
+            }
+            case State::REPLY_WAIT:
+            {
+                Dtu::Command::Bits cmd =
+                    *reinterpret_cast<const RegFile::reg_t*>(pkt_data);
+                if (cmd.opcode == 0)
+                {
+                    if (cmd.error == 0)
+                        state = State::CTXSW;
+                    else
+                        state = State::REPLY_ERROR;
+                }
+                break;
+            }
+            case State::REPLY_ERROR:
+            {
+                sysc.start(sizeof(reply));
+                syscNext = State::CTXSW;
+                state = State::SYSCALL;
+                break;
+            }
+
+            case State::SYSCALL:
+            {
+                if(sysc.handleMemResp(pkt))
+                    state = syscNext;
+                break;
+            }
+        }
+    }
+
+    memPending = false;
+    freePacket(pkt);
+
+    // kick things into action again
+    schedule(tickEvent, clockEdge(delay));
+}
+
+void
+DtuAccelGemm::wakeup()
+{
+    sysc.retryFetch();
+
+    if (!memPending && !tickEvent.scheduled())
+        schedule(tickEvent, clockEdge(Cycles(1)));
+}
+
+void
+DtuAccelGemm::interrupt()
+{
+    irqPending = true;
+
+    if (ctxsw.isWaiting())
+    {
+        ctxsw.restart();
+        if (!memPending && !tickEvent.scheduled())
+            schedule(tickEvent, clockEdge(Cycles(1)));
+    }
+}
+
+void
+DtuAccelGemm::reset()
+{
+    irqPending = false;
+
+    yield.start(false);
+    state = State::IDLE;
+    memset(&ctx, 0, sizeof(ctx));
+}
+
+void
+DtuAccelGemm::tick()
+{
+    PacketPtr pkt = nullptr;
+
+    if (state != lastState ||
+        (state == State::CTXSW && ctxsw.hasStateChanged()) ||
+        (state == State::SYSCALL && sysc.hasStateChanged()) ||
+        (state == State::IDLE && yield.hasStateChanged()))
+    {
+        DPRINTF(DtuAccelGemmState, "[%s] tick\n",
+            getStateName().c_str());
+        lastState = state;
+    }
+
+    switch(state)
+    {
+        case State::IDLE:
+        {
+            pkt = yield.tick();
+            break;
+        }
+
+        case State::CTXSW:
+        {
+            pkt = ctxsw.tick();
+            break;
+        }
+
+        case State::FETCH_MSG:
+        {
+            if (irqPending)
+            {
+                irqPending = false;
+                state = State::CTXSW;
+                schedule(tickEvent, clockEdge(Cycles(1)));
+            }
+            else
+            {
+                Addr regAddr = getRegAddr(CmdReg::COMMAND);
+                uint64_t value = Dtu::Command::FETCH_MSG | (EP_RECV << 4);
+                pkt = createDtuRegPkt(regAddr, value, MemCmd::WriteReq);
+            }
+            break;
+        }
+        case State::READ_MSG_ADDR:
+        {
+            Addr regAddr = getRegAddr(CmdReg::OFFSET);
+            pkt = createDtuRegPkt(regAddr, 0, MemCmd::ReadReq);
+            break;
+        }
+        case State::READ_MSG:
+        {
+            pkt = createPacket(msgAddr, MSG_SIZE, MemCmd::ReadReq);
+            break;
+        }
+
+        case State::READ_IN:
+        {
+            // gather the next contiguous piece of an input row
+            size_t len;
+            Addr off = inOffset(row, col, &len);
+            Addr dst = BUF_ADDR + (row * tileDepth() + col - k0) * elemSize();
+            pkt = createDtuCmdPkt(Dtu::Command::READ,
+                                  EP_IN,
+                                  dst,
+                                  len * elemSize(),
+                                  job.inOff + off);
+            readBytes += len * elemSize();
+
+            col += len;
+            if (col == k0 + tileDepth())
+            {
+                row++;
+                col = k0;
+            }
+            break;
+        }
+        case State::READ_WEIGHTS:
+        {
+            size_t size = tileCols() * elemSize();
+            Addr off = ((k0 + row) * job.n + n0) * elemSize();
+            pkt = createDtuCmdPkt(Dtu::Command::READ,
+                                  EP_WEIGHTS,
+                                  weightsAddr + row * size,
+                                  size,
+                                  job.weightOff + off);
+            readBytes += size;
+            row++;
+            break;
+        }
+        case State::READ_IN_WAIT:
+        case State::READ_WEIGHTS_WAIT:
+        case State::WRITE_OUT_WAIT:
+        case State::REPLY_WAIT:
+        {
+            Addr regAddr = getRegAddr(CmdReg::COMMAND);
+            pkt = createDtuRegPkt(regAddr, 0, MemCmd::ReadReq);
+            break;
+        }
+
+        case State::LOAD_IN:
+        {
+            size_t total = tileRows() * tileDepth() * elemSize();
+            pkt = createPacket(BUF_ADDR + spmPos,
+                               std::min(chunkSize, total - spmPos),
+                               MemCmd::ReadReq);
+            break;
+        }
+        case State::LOAD_WEIGHTS:
+        {
+            size_t total = tileDepth() * tileCols() * elemSize();
+            pkt = createPacket(weightsAddr + spmPos,
+                               std::min(chunkSize, total - spmPos),
+                               MemCmd::ReadReq);
+            break;
+        }
+
+        case State::STORE_OUT:
+        {
+            size_t total = tileRows() * tileCols() * sizeof(float);
+            size_t size = std::min(chunkSize, total - spmPos);
+            pkt = createPacket(outAddr + spmPos, size, MemCmd::WriteReq);
+            memcpy(pkt->getPtr<uint8_t>(), outTile.data() + spmPos, size);
+            break;
+        }
+        case State::WRITE_OUT:
+        {
+            size_t size = tileCols() * sizeof(float);
+            Addr off = ((m0 + row) * job.n + n0) * sizeof(float);
+            pkt = createDtuCmdPkt(Dtu::Command::WRITE,
+                                  EP_OUT,
+                                  outAddr + row * size,
+                                  size,
+                                  job.outOff + off);
+            writtenBytes += size;
+            row++;
+            break;
+        }
+
+        case State::STORE_REPLY:
+        {
+            pkt = createPacket(BUF_ADDR + bufSize,
+                               sizeof(reply.msg),
+                               MemCmd::WriteReq);
+            memcpy(pkt->getPtr<uint8_t>(), (char*)&reply.msg, sizeof(reply.msg));
+            break;
+        }
+        case State::SEND_REPLY:
+        {
+            pkt = createDtuCmdPkt(Dtu::Command::REPLY,
+                                  EP_RECV,
+                                  BUF_ADDR + bufSize,
+                                  sizeof(reply.msg),
+                                  msgAddr);
+            break;
+        }
+        case State::REPLY_ERROR:
+        {
+            reply.sys.opcode = SyscallSM::Operation::FORWARD_REPLY;
+            reply.sys.cap = CAP_RBUF;
+            reply.sys.msgaddr = msgAddr;
+            reply.sys.len = sizeof(reply.msg);
+            reply.sys.event = 0;
+
+            pkt = createPacket(MSG_ADDR, sizeof(reply), MemCmd::WriteReq);
+            memcpy(pkt->getPtr<void>(), &reply, sizeof(reply));
+            break;
+        }
+
+        case State::SYSCALL:
+        {
+            pkt = sysc.tick();
+            break;
+        }
+    }
+
+    if (pkt != nullptr)
+    {
+        memPending = true;
+        sendPkt(pkt);
+    }
+}
+
+DtuAccelGemm*
+DtuAccelGemmParams::create()
+{
+    return new DtuAccelGemm(this);
+}
@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) 2016, Nils Asmussen
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#ifndef __CPU_DTU_ACCEL_GEMM_HH__
+#define __CPU_DTU_ACCEL_GEMM_HH__
+
+#include <vector>
+
+#include "params/DtuAccelGemm.hh"
+#include "base/statistics.hh"
+#include "cpu/dtu-accel/accelerator.hh"
+#include "cpu/dtu-accel/ctxswsm.hh"
+#include "cpu/dtu-accel/syscallsm.hh"
+#include "cpu/dtu-accel/yieldsm.hh"
+#include "mem/dtu/connector/base.hh"
+#include "mem/dtu/regfile.hh"
+#include "sim/system.hh"
+
+/**
+ * A matrix engine that multiplies matrices on a systolic array. The inputs
+ * are pulled tile by tile through DTU memory endpoints into the SPM, the
+ * result is computed on the host and the time is derived from the tile
+ * shapes, the array dimensions, the dataflow and the SPM bandwidth.
+ * Convolutions are lowered to matrix multiplications by gathering the input
+ * patches while loading the tiles (im2col).
+ */
+class DtuAccelGemm : public DtuAccel
+{
+    static const unsigned EP_RECV       = 4;
+    static const unsigned EP_IN         = 5;
+    static const unsigned EP_WEIGHTS    = 6;
+    static const unsigned EP_OUT        = 7;
+    static const unsigned CAP_RBUF      = 64;
+
+    static const size_t MSG_SIZE        = 128;
+    static const Addr MSG_ADDR          = 0x2000;
+    static const Addr BUF_ADDR          = 0x8000;
+
+  public:
+    DtuAccelGemm(const DtuAccelGemmParams *p);
+
+    void wakeup() override;
+
+    void interrupt() override;
+
+    void reset() override;
+
+    void regStats() override;
+
+    Addr sendMsgAddr() const override { return MSG_ADDR; }
+    Addr bufferAddr() const override { return BUF_ADDR; }
+    int contextEp() const override { return 0; }
+    size_t stateSize(bool) const override { return 0; }
+    size_t contextSize(bool) const override { return sizeof(Context); }
+    void *context() override { return &ctx; }
+    void setSwitched() override {}
+
+  private:
+
+    /// main simulation loop
+    void tick() override;
+
+    void completeRequest(PacketPtr pkt) override;
+
+    enum class State
+    {
+        IDLE,
+
+        FETCH_MSG,
+        READ_MSG_ADDR,
+        READ_MSG,
+
+        READ_IN,
+        READ_IN_WAIT,
+        READ_WEIGHTS,
+        READ_WEIGHTS_WAIT,
+
+        LOAD_IN,
+        LOAD_WEIGHTS,
+
+        STORE_OUT,
+        WRITE_OUT,
+        WRITE_OUT_WAIT,
+
+        STORE_REPLY,
+        SEND_REPLY,
+        REPLY_WAIT,
+        REPLY_ERROR,
+
+        CTXSW,
+
+        SYSCALL,
+    };
+
+    enum Operation
+    {
+        GEMM,
+        CONV,
+    };
+
+    enum DataType
+    {
+        INT8,
+        FP32,
+    };
+
+    enum Error
+    {
+        NONE,
+        INV_ARGS,
+        XFER_FAILED,
+    };
+
+    /**
+     * The job description in the request message. For GEMM, the input is
+     * an m x k and the weights a k x n matrix. For CONV, the input is a
+     * h x w x c tensor and the weights are r x s x c x n filters; m and k are
+     * derived from that. All data is stored densely in row-major order and
+     * the output is an m x n matrix of 32-bit integers or floats.
+     */
+    struct Job
+    {
+        uint64_t op;
+        uint64_t dtype;
+        uint64_t m;
+        uint64_t n;
+        uint64_t k;
+        uint64_t inOff;
+        uint64_t weightOff;
+        uint64_t outOff;
+        uint32_t h;
+        uint32_t w;
+        uint32_t c;
+        uint32_t r;
+        uint32_t s;
+        uint32_t stride;
+    } M5_ATTR_PACKED;
+
+    std::string getStateName() const;
+
+    bool startJob();
+
+    void finishJob(Error err);
+
+    void startTile();
+
+    bool nextTile();
+
+    size_t elemSize() const { return job.dtype == INT8 ? 1 : 4; }
+    size_t tileRows() const { return std::min(tileM, job.m - m0); }
+    size_t tileCols() const { return std::min(tileN, job.n - n0); }
+    size_t tileDepth() const { return std::min(tileK, job.k - k0); }
+
+    Addr inOffset(size_t tileRow, uint64_t k, size_t *len) const;
+
+    Cycles tileCycles(size_t rows, size_t cols, size_t depth);
+
+    void computeTile();
+
+    void storeOutput();
+
+    size_t arrayRows;
+    size_t arrayCols;
+    Enums::GemmDataflow dataflow;
+    size_t spmBW;
+    size_t tileM;
+    size_t tileN;
+    size_t tileK;
+    size_t bufSize;
+    Addr weightsAddr;
+    Addr outAddr;
+
+    bool irqPending;
+    bool memPending;
+
+    State state;
+    State lastState;
+
+    Addr msgAddr;
+
+    Job job;
+    uint64_t outWidth;
+    uint64_t m0;
+    uint64_t n0;
+    uint64_t k0;
+    size_t row;
+    uint64_t col;
+    size_t spmPos;
+    Tick jobStart;
+
+    std::vector<uint8_t> inTile;
+    std::vector<uint8_t> weightTile;
+    std::vector<uint8_t> outTile;
+    std::vector<int32_t> accInt;
+    std::vector<float> accFloat;
+
+    struct Context
+    {
+        uint64_t dummy;
+    } PACKED;
+
+    struct
+    {
+        struct
+        {
+            uint64_t opcode;
+            uint64_t cap;
+            uint64_t msgaddr;
+            uint64_t len;
+            uint64_t event;
+        } M5_ATTR_PACKED sys;
+        struct
+        {
+            uint64_t err;
+            uint64_t cycles;
+        } M5_ATTR_PACKED msg;
+    } M5_ATTR_PACKED reply;
+
+    Context ctx;
+    SyscallSM sysc;
+    State syscNext;
+    YieldSM yield;
+    AccelCtxSwSM ctxsw;
+
+    Stats::Scalar jobs;
+    Stats::Scalar failedJobs;
+    Stats::Scalar tiles;
+    Stats::Scalar macs;
+    Stats::Scalar arrayCycles;
+    Stats::Scalar stallCycles;
+    Stats::Scalar readBytes;
+    Stats::Scalar writtenBytes;
+    Stats::Histogram jobLatency;
+    Stats::Formula arrayUtil;
+};
+
+#endif // __CPU_DTU_ACCEL_GEMM_HH__
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2016, Nils Asmussen
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#ifndef __CPU_DTU_ACCEL_GEMM_KERNELS_HH__
+#define __CPU_DTU_ACCEL_GEMM_KERNELS_HH__
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Accumulates the product of the m x k tile a and the k x n tile b into the
+ * m x n tile c. All tiles are dense and row-major. The loops are ordered so
+ * that the innermost one walks contiguously through b and c, which lets the
+ * compiler vectorize it.
+ */
+template<typename T, typename Acc>
+static inline void
+gemmTile(Acc *c, const T *a, const T *b, size_t m, size_t n, size_t k)
+{
+    for (size_t i = 0; i < m; ++i)
+    {
+        Acc *crow = c + i * n;
+        for (size_t l = 0; l < k; ++l)
+        {
+            const Acc av = a[i * k + l];
+            const T *brow = b + l * n;
+            for (size_t j = 0; j < n; ++j)
+                crow[j] += av * static_cast<Acc>(brow[j]);
+        }
+    }
+}
+
+#endif // __CPU_DTU_ACCEL_GEMM_KERNELS_HH__
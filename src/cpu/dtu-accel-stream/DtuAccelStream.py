@@ -36,3 +36,7 @@ class DtuAccelStream(DtuAccel):
 
     logic = Param.AccelLogic("The accelerator logic")
     buf_size = Param.MemorySize("4kB", "The size of the buffer")
+    buf_count = Param.Unsigned(1, "The number of blocks to overlap " \
+        "reading, computing and writing of (1 = sequential)")
+    block_size = Param.MemorySize("0B", "The size of a block " \
+        "(0 = divide the buffer evenly among the blocks)")
@@ -83,14 +83,36 @@ DtuAccelStream::DtuAccelStream(const DtuAccelStreamParams *p)
     lastFlags(),
     ctx(),
     bufSize(p->buf_size),
+    bufCount(p->buf_count),
+    blockSize(p->block_size),
     sysc(this),
     yield(this, &sysc),
     logic(p->logic),
     ctxsw(this),
-    ctxSwPerformed()
+    ctxSwPerformed(),
+    readStart(),
+    writeStart(),
+    compStart(),
+    pipeStart(),
+    pipeBusy()
 {
     static_assert((sizeof(stateNames) / sizeof(stateNames[0]) ==
                   static_cast<size_t>(State::EXIT) + 1), "Missmatch");
+    // the context is saved right below the buffer
+    static_assert(sizeof(ctx) == 256, "Unexpected context size");
+    static_assert(sizeof(ctx) % 64 == 0, "Context not padded");
+    static_assert(BUF_ADDR - sizeof(ctx) >= MSG_ADDR + MSG_SIZE,
+                  "Context overlaps the message");
+    fatal_if(BUF_ADDR - sizeof(ctx) < RCTMUX_FLAGS + sizeof(uint64_t),
+             "Context overlaps the RCTMux flags\n");
+
+    fatal_if(bufCount == 0 || bufCount > MAX_BUFS,
+             "buf_count has to be between 1 and %u\n", MAX_BUFS);
+    if (blockSize == 0)
+        blockSize = bufSize / bufCount;
+    fatal_if(blockSize == 0 || blockSize * bufCount > bufSize,
+             "%u blocks of %lu bytes do not fit into the buffer\n",
+             bufCount, blockSize);
 
     rdwr_msg.sys.opcode = SyscallSM::Operation::FORWARD_MSG;
     rdwr_msg.sys.rgate_sel = CAP_RECV;
@@ -101,6 +123,43 @@ DtuAccelStream::DtuAccelStream(const DtuAccelStreamParams *p)
     yield.start();
 }
 
+void
+DtuAccelStream::regStats()
+{
+    DtuAccel::regStats();
+
+    blocks
+        .name(name() + ".blocks")
+        .desc("Number of computed blocks");
+    readCycles
+        .name(name() + ".readCycles")
+        .desc("Cycles spent reading input blocks");
+    compCycles
+        .name(name() + ".compCycles")
+        .desc("Cycles spent computing blocks");
+    writeCycles
+        .name(name() + ".writeCycles")
+        .desc("Cycles spent writing output blocks");
+    pipeCycles
+        .name(name() + ".pipeCycles")
+        .desc("Cycles with at least one block in flight");
+    readUtil
+        .name(name() + ".readUtil")
+        .desc("Utilization of the read stage")
+        .precision(4);
+    compUtil
+        .name(name() + ".compUtil")
+        .desc("Utilization of the compute stage")
+        .precision(4);
+    writeUtil
+        .name(name() + ".writeUtil")
+        .desc("Utilization of the write stage")
+        .precision(4);
+    readUtil = readCycles / pipeCycles;
+    compUtil = compCycles / pipeCycles;
+    writeUtil = writeCycles / pipeCycles;
+}
+
 std::string DtuAccelStream::getStateName() const
 {
     std::ostringstream os;
@@ -213,8 +272,13 @@ DtuAccelStream::completeRequest(PacketPtr pkt)
             }
             case State::INOUT_ACK:
             {
-                state = (ctx.flags & Flags::OUTPUT) ? State::WRITE_DATA
-                                                    : State::READ_DATA;
+                if (pipelined())
+                    state = State::INOUT_START;
+                else
+                {
+                    state = (ctx.flags & Flags::OUTPUT) ? State::WRITE_DATA
+                                                        : State::READ_DATA;
+                }
                 break;
             }
 
@@ -285,7 +349,9 @@ DtuAccelStream::completeRequest(PacketPtr pkt)
                         if (ctx.inLen == 0)
                         {
                             ctx.flags |= Flags::SEEN_EOF;
-                            state = State::COMMIT_START;
+                            // blocks might still be in flight
+                            state = pipelined() ? State::INOUT_START
+                                                : State::COMMIT_START;
                         }
                         else
                             state = State::INOUT_ACK;
@@ -397,10 +463,27 @@ DtuAccelStream::completeRequest(PacketPtr pkt)
                     *reinterpret_cast<const RegFile::reg_t*>(pkt_data);
                 if (cmd.opcode == 0)
                 {
-                    ctx.bufOff = (cmd.error != 0) ? ctx.inOff : 0;
-                    logic->start(ctx.bufOff, ctx.lastSize, Cycles(ctx.compTime));
-                    ctx.flags |= Flags::COMP;
-                    state = State::FETCH_MSG;
+                    readCycles += curCycle() - readStart;
+                    if (pipelined())
+                    {
+                        // if the read failed, the data has been written
+                        // to our buffer directly
+                        unsigned slot = ctx.rdSlot;
+                        if (cmd.error != 0)
+                            ctx.slotOff[slot] = ctx.inOff + ctx.inPos -
+                                                ctx.slotSize[slot];
+                        ctx.rdSlot = (slot + 1) % bufCount;
+                        ctx.filled++;
+                        if (!(ctx.flags & Flags::COMP))
+                            startLogic(ctx.slotOff[slot], ctx.slotSize[slot]);
+                        state = State::INOUT_START;
+                    }
+                    else
+                    {
+                        ctx.bufOff = (cmd.error != 0) ? ctx.inOff : 0;
+                        startLogic(ctx.bufOff, ctx.lastSize);
+                        state = State::FETCH_MSG;
+                    }
                 }
                 break;
             }
@@ -416,13 +499,29 @@ DtuAccelStream::completeRequest(PacketPtr pkt)
                     *reinterpret_cast<const RegFile::reg_t*>(pkt_data);
                 if (cmd.opcode == 0)
                 {
+                    writeCycles += curCycle() - writeStart;
                     if (ctx.lastSize == 0)
                     {
-                        if (ctx.inPos == ctx.inLen)
+                        if (pipelined())
+                        {
+                            ctx.wrSlot = (ctx.wrSlot + 1) % bufCount;
+                            if (--ctx.computed > 0)
+                                loadWriteHead();
+                        }
+
+                        // the input is only free again if all blocks of it
+                        // have been written
+                        if (ctx.inPos == ctx.inLen && pipelineEmpty())
                             ctx.inAvail = 0;
                         if (ctx.outPos == ctx.outLen)
                             ctx.outAvail = 1;
                         ctx.flags &= ~Flags::OUTPUT;
+
+                        if (pipelineEmpty() && pipeBusy)
+                        {
+                            pipeCycles += curCycle() - pipeStart;
+                            pipeBusy = false;
+                        }
                     }
                     state = State::INOUT_START;
                 }
@@ -558,19 +657,103 @@ DtuAccelStream::reset()
     yield.start(false);
     state = State::IDLE;
     memset(&ctx, 0, sizeof(ctx));
+    pipeBusy = false;
+}
+
+void
+DtuAccelStream::startLogic(Addr offset, Addr size)
+{
+    logic->start(offset, size, Cycles(ctx.compTime));
+    ctx.flags |= Flags::COMP;
+    compStart = curCycle();
+}
+
+void
+DtuAccelStream::loadWriteHead()
+{
+    ctx.bufOff = ctx.slotOff[ctx.wrSlot];
+    ctx.lastSize = ctx.slotSize[ctx.wrSlot];
 }
 
 void
 DtuAccelStream::logicFinished()
 {
-    ctx.lastSize = logic->outDataSize();
-    ctx.flags &= ~(Flags::COMP | Flags::FETCHED);
-    ctx.flags |= Flags::OUTPUT | Flags::COMPDONE;
+    compCycles += curCycle() - compStart;
+    blocks++;
+
+    if (pipelined())
+    {
+        ctx.slotSize[ctx.compSlot] = logic->outDataSize();
+        ctx.compSlot = (ctx.compSlot + 1) % bufCount;
+        ctx.filled--;
+        if (ctx.computed++ == 0)
+            loadWriteHead();
+
+        ctx.flags &= ~(Flags::COMP | Flags::FETCHED);
+        ctx.flags |= Flags::COMPDONE;
+
+        // continue with the next block right away
+        if (ctx.filled > 0)
+        {
+            startLogic(ctx.slotOff[ctx.compSlot],
+                       ctx.slotSize[ctx.compSlot]);
+        }
+    }
+    else
+    {
+        ctx.lastSize = logic->outDataSize();
+        ctx.flags &= ~(Flags::COMP | Flags::FETCHED);
+        ctx.flags |= Flags::OUTPUT | Flags::COMPDONE;
+    }
 
     if (!memPending && !tickEvent.scheduled())
         schedule(tickEvent, clockEdge(Cycles(1)));
 }
 
+void
+DtuAccelStream::pipelineDecide()
+{
+    // keep the logic busy
+    if (!(ctx.flags & Flags::COMP) && ctx.filled > 0)
+        startLogic(ctx.slotOff[ctx.compSlot], ctx.slotSize[ctx.compSlot]);
+
+    // should we check for messages in between?
+    if (!(ctx.flags & Flags::FETCHED))
+    {
+        ctx.flags |= Flags::TRANSFER;
+        state = State::FETCH_MSG;
+    }
+    // write computed blocks first to free their slots
+    else if (ctx.computed > 0 && ctx.outPos < ctx.outLen)
+        state = State::WRITE_DATA;
+    // fill free slots, unless we want to switch the context
+    else if (freeSlots() > 0 && !irqPending && ctx.inPos < ctx.inLen)
+        state = State::READ_DATA;
+    // have seen commit? take that as input
+    else if (freeSlots() > 0 && !irqPending &&
+             (ctx.flags & Flags::SEEN_COMMIT))
+    {
+        ctx.inOff = ctx.commitOff;
+        ctx.inLen = ctx.commitLen;
+        ctx.inPos = 0;
+        ctx.flags &= ~Flags::SEEN_COMMIT;
+        ctx.flags |= Flags::SEEN_EOF;
+        state = State::READ_DATA;
+    }
+    // no space for the computed blocks? request more output
+    else if (ctx.computed > 0)
+        ctx.flags |= Flags::OUTPUT;
+    // wait until the logic is done
+    else if (ctx.flags & Flags::COMP)
+        state = State::FETCH_MSG;
+    // all blocks are written; if we've seen EOF, commit and exit
+    else if (ctx.flags & Flags::SEEN_EOF)
+        state = State::COMMIT_START;
+    // otherwise, request more input
+    else
+        ctx.flags &= ~Flags::OUTPUT;
+}
+
 void
 DtuAccelStream::tick()
 {
@@ -602,6 +785,13 @@ DtuAccelStream::tick()
             state = State::INOUT_START;
             ctx.flags &= ~Flags::COMPDONE;
         }
+        // with multiple buffers, we keep transferring during computations
+        else if (pipelined() && !(ctx.flags & Flags::WAIT) &&
+                 (ctx.flags & Flags::TRANSFER))
+        {
+            state = State::INOUT_START;
+            ctx.flags &= ~Flags::TRANSFER;
+        }
         else if (ctx.flags & Flags::COMP)
             state = State::FETCH_MSG;
         else if (!(ctx.flags & Flags::WAIT) && (ctx.flags & Flags::TRANSFER))
@@ -637,7 +827,7 @@ DtuAccelStream::tick()
 
     if (state == State::INOUT_START)
     {
-        if (irqPending)
+        if (irqPending && !(ctx.flags & Flags::COMP))
         {
             irqPending = false;
             state = State::CTXSW;
@@ -646,6 +836,8 @@ DtuAccelStream::tick()
         // alternatively, if we are already waiting for a response, just check
         else if (ctx.flags & (Flags::EXIT | Flags::WAIT))
             state = State::FETCH_MSG;
+        else if (pipelined())
+            pipelineDecide();
         else if (!(ctx.flags & Flags::OUTPUT))
         {
             // should we check for messages in between?
@@ -783,13 +975,36 @@ DtuAccelStream::tick()
 
         case State::READ_DATA:
         {
-            ctx.lastSize = std::min(bufSize, ctx.inLen - ctx.inPos);
+            if (!pipeBusy)
+            {
+                pipeStart = curCycle();
+                pipeBusy = true;
+            }
+            readStart = curCycle();
+
+            Addr bufOff;
+            size_t amount;
+            if (pipelined())
+            {
+                unsigned slot = ctx.rdSlot;
+                bufOff = slot * blockSize;
+                amount = std::min(blockSize, ctx.inLen - ctx.inPos);
+                ctx.slotOff[slot] = bufOff;
+                ctx.slotSize[slot] = amount;
+            }
+            else
+            {
+                bufOff = 0;
+                amount = std::min(bufSize, ctx.inLen - ctx.inPos);
+                ctx.lastSize = amount;
+            }
+
             pkt = createDtuCmdPkt(Dtu::Command::READ,
                                   EP_IN_MEM,
-                                  BUF_ADDR,
-                                  ctx.lastSize,
+                                  BUF_ADDR + bufOff,
+                                  amount,
                                   ctx.inOff + ctx.inPos);
-            ctx.inPos += ctx.lastSize;
+            ctx.inPos += amount;
             break;
         }
         case State::READ_DATA_WAIT:
@@ -801,6 +1016,8 @@ DtuAccelStream::tick()
 
         case State::WRITE_DATA:
         {
+            writeStart = curCycle();
+
             size_t amount = std::min(ctx.lastSize, ctx.outLen - ctx.outPos);
             pkt = createDtuCmdPkt(Dtu::Command::WRITE,
                                   EP_OUT_MEM,
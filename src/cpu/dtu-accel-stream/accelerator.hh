@@ -31,6 +31,7 @@
 #define __CPU_DTU_ACCEL_STREAM_ACCELERATOR_HH__
 
 #include "params/DtuAccelStream.hh"
+#include "base/statistics.hh"
 #include "cpu/dtu-accel-stream/logic.hh"
 #include "cpu/dtu-accel/accelerator.hh"
 #include "cpu/dtu-accel/ctxswsm.hh"
@@ -65,6 +66,8 @@ class DtuAccelStream : public DtuAccel
 
     static const size_t MSG_SIZE        = 64;
 
+    static const unsigned MAX_BUFS      = 8;
+
     static const uint64_t NO_COMMIT     = 0xFFFFFFFFFFFFFFFF;
 
   public:
@@ -78,6 +81,8 @@ class DtuAccelStream : public DtuAccel
 
     void logicFinished();
 
+    void regStats() override;
+
     Addr sendMsgAddr() const override { return MSG_ADDR; }
     Addr bufferAddr() const override { return BUF_ADDR; }
     int contextEp() const override { return EP_CTX; }
@@ -148,6 +153,25 @@ class DtuAccelStream : public DtuAccel
 
     std::string getStateName() const;
 
+    bool pipelined() const { return bufCount > 1; }
+
+    unsigned freeSlots() const
+    {
+        return bufCount - ctx.filled - ctx.computed;
+    }
+
+    bool pipelineEmpty() const
+    {
+        return ctx.filled == 0 && ctx.computed == 0 &&
+               !(ctx.flags & Flags::COMP);
+    }
+
+    void startLogic(Addr offset, Addr size);
+
+    void loadWriteHead();
+
+    void pipelineDecide();
+
     bool irqPending;
     bool memPending;
 
@@ -191,8 +215,20 @@ class DtuAccelStream : public DtuAccel
         uint64_t outLen;
         uint64_t lastSize;
         uint64_t nextSysc;
-        // padding
-        uint64_t : 64;
+        // multi-buffering: the slots are filled, computed and written in
+        // order. rdSlot is the next one to fill, compSlot the next (or
+        // current) one to compute and wrSlot the one we are writing out.
+        uint8_t rdSlot;
+        uint8_t compSlot;
+        uint8_t wrSlot;
+        uint8_t filled;
+        uint8_t computed;
+        uint8_t : 8;
+        uint16_t : 16;
+        uint32_t slotOff[MAX_BUFS];
+        uint32_t slotSize[MAX_BUFS];
+        // padding to a multiple of 64 bytes
+        uint64_t pad[8];
     } M5_ATTR_PACKED ctx;
 
     struct
@@ -240,6 +276,8 @@ class DtuAccelStream : public DtuAccel
     } M5_ATTR_PACKED reply;
 
     size_t bufSize;
+    unsigned bufCount;
+    size_t blockSize;
     SyscallSM sysc;
     State syscNext;
     Addr replyAddr;
@@ -248,6 +286,21 @@ class DtuAccelStream : public DtuAccel
     AccelLogic *logic;
     AccelCtxSwSM ctxsw;
     bool ctxSwPerformed;
+
+    Cycles readStart;
+    Cycles writeStart;
+    Cycles compStart;
+    Cycles pipeStart;
+    bool pipeBusy;
+
+    Stats::Scalar blocks;
+    Stats::Scalar readCycles;
+    Stats::Scalar compCycles;
+    Stats::Scalar writeCycles;
+    Stats::Scalar pipeCycles;
+    Stats::Formula readUtil;
+    Stats::Formula compUtil;
+    Stats::Formula writeUtil;
 };
 
 #endif // __CPU_DTU_ACCEL_STREAM_ACCELERATOR_HH__
@@ -40,6 +40,7 @@ class DtuAccel(MemObject):
     regfile_base_addr = Param.Addr(0xF0000000, "Register file address")
 
     max_data_size = Param.MemorySize("1kB", "The maximum size of data transfers")
+    ctx_slots = Param.Unsigned(0, "Number of on-chip context slots")
 
 class DtuAccelConnector(BaseConnector):
     type = 'DtuAccelConnector'
@@ -95,6 +95,7 @@ DtuAccel::DtuAccel(const DtuAccelParams *p)
     tickEvent(this),
     chunkSize(system->cacheLineSize()),
     maxDataSize(p->max_data_size),
+    ctxSlots(p->ctx_slots),
     port("port", this),
     masterId(system->getMasterId(this, name())),
     id(p->id),
@@ -113,6 +114,14 @@ DtuAccel::DtuAccel(const DtuAccelParams *p)
     schedule(tickEvent, curTick());
 }
 
+void
+DtuAccel::regStats()
+{
+    MemObject::regStats();
+
+    ctxSlots.regStats(name());
+}
+
 BaseMasterPort &
 DtuAccel::getMasterPort(const std::string& if_name, PortID idx)
 {
@@ -182,6 +191,14 @@ DtuAccel::createDtuRegPkt(Addr reg,
     return pkt;
 }
 
+PacketPtr
+DtuAccel::createDtuRegsReadPkt(Addr reg, size_t count)
+{
+    return createPacket(reg_base + reg,
+                        count * sizeof(RegFile::reg_t),
+                        MemCmd::ReadReq);
+}
+
 PacketPtr
 DtuAccel::createDtuCmdPkt(Dtu::Command::Opcode cmd,
                           unsigned epid,
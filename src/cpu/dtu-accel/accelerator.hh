@@ -32,6 +32,7 @@
 #define __CPU_DTU_ACCEL_HH__
 
 #include "params/DtuAccel.hh"
+#include "cpu/dtu-accel/ctxslots.hh"
 #include "mem/dtu/connector/base.hh"
 #include "mem/dtu/regfile.hh"
 #include "mem/dtu/dtu.hh"
@@ -52,6 +53,8 @@ class DtuAccel : public MemObject
     BaseMasterPort& getMasterPort(const std::string &if_name,
                                   PortID idx = InvalidPortID) override;
 
+    void regStats() override;
+
     void setConnector(BaseConnector *con)
     {
         connector = con;
@@ -109,6 +112,8 @@ class DtuAccel : public MemObject
 
     PacketPtr createDtuRegPkt(Addr reg, RegFile::reg_t value, MemCmd cmd);
 
+    PacketPtr createDtuRegsReadPkt(Addr reg, size_t count);
+
     PacketPtr createDtuCmdPkt(Dtu::Command::Opcode cmd, unsigned epid,
                               uint64_t data, uint64_t size, uint64_t arg,
                               uint64_t reply_label = 0);
@@ -135,6 +140,8 @@ class DtuAccel : public MemObject
     Addr chunkSize;
     size_t maxDataSize;
 
+    AccelCtxSlots ctxSlots;
+
   private:
 
     CpuPort port;
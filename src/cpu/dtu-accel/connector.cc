@@ -53,9 +53,11 @@ DtuAccelConnector::setIrq()
 }
 
 void
-DtuAccelConnector::reset(Addr, Addr)
+DtuAccelConnector::reset(Addr, Addr, uint16_t vpeId)
 {
-    DPRINTF(DtuConnector, "Resetting accelerator\n");
+    DPRINTF(DtuConnector, "Resetting accelerator for VPE %u\n", vpeId);
+    // the VPE starts from scratch, so its saved contexts are stale
+    acc->ctxSlots.invalidate(vpeId);
     acc->reset();
 }
 
@@ -44,7 +44,7 @@ class DtuAccelConnector : public BaseConnector
 
     void setIrq() override;
 
-    void reset(Addr entry, Addr rootpt) override;
+    void reset(Addr entry, Addr rootpt, uint16_t vpeId) override;
 
     void signalFinished(size_t off);
 
@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2016, Nils Asmussen
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#include "cpu/dtu-accel/ctxslots.hh"
+
+AccelCtxSlots::AccelCtxSlots(unsigned count)
+    : slots(count), useCount()
+{
+}
+
+int
+AccelCtxSlots::lookup(const Key &key)
+{
+    for (size_t i = 0; i < slots.size(); ++i)
+    {
+        if (slots[i].valid && slots[i].saved && slots[i].key == key)
+        {
+            restoreHits++;
+            return i;
+        }
+    }
+
+    restoreMisses++;
+    return -1;
+}
+
+int
+AccelCtxSlots::allocate(const Key &key)
+{
+    int victim = -1;
+    for (size_t i = 0; i < slots.size(); ++i)
+    {
+        // reuse the slot we had for this context before
+        if (slots[i].valid && slots[i].key == key)
+        {
+            victim = i;
+            break;
+        }
+
+        if (!slots[i].valid)
+        {
+            if (victim == -1 || slots[victim].valid)
+                victim = i;
+        }
+        // saved contexts have no other copy
+        else if (!slots[i].saved)
+        {
+            if (victim == -1 ||
+                (slots[victim].valid &&
+                 slots[i].lastUse < slots[victim].lastUse))
+                victim = i;
+        }
+    }
+
+    if (victim == -1)
+        saveSpills++;
+    else
+        saveHits++;
+    return victim;
+}
+
+uint8_t *
+AccelCtxSlots::data(int slot, size_t size)
+{
+    slots[slot].data.resize(size);
+    return slots[slot].data.data();
+}
+
+void
+AccelCtxSlots::saved(int slot, const Key &key)
+{
+    slots[slot].key = key;
+    slots[slot].valid = true;
+    slots[slot].saved = true;
+    slots[slot].lastUse = ++useCount;
+}
+
+void
+AccelCtxSlots::restored(int slot)
+{
+    slots[slot].saved = false;
+    slots[slot].lastUse = ++useCount;
+}
+
+void
+AccelCtxSlots::invalidate(uint16_t vpeId)
+{
+    for (auto &s : slots)
+    {
+        if (s.valid && s.key.vpeId == vpeId)
+        {
+            s.valid = false;
+            s.saved = false;
+            s.data.clear();
+            invalidations++;
+        }
+    }
+}
+
+void
+AccelCtxSlots::regStats(const std::string &name)
+{
+    saveHits
+        .name(name + ".ctxSlots.saveHits")
+        .desc("Number of contexts saved into an on-chip slot");
+    saveSpills
+        .name(name + ".ctxSlots.saveSpills")
+        .desc("Number of contexts spilled to memory, because all slots "
+              "were occupied");
+    restoreHits
+        .name(name + ".ctxSlots.restoreHits")
+        .desc("Number of contexts restored from an on-chip slot");
+    restoreMisses
+        .name(name + ".ctxSlots.restoreMisses")
+        .desc("Number of contexts restored from memory");
+    invalidations
+        .name(name + ".ctxSlots.invalidations")
+        .desc("Number of slots dropped, because their VPE was reset");
+    restoreHitRate
+        .name(name + ".ctxSlots.restoreHitRate")
+        .desc("Fraction of restores served by an on-chip slot")
+        .precision(4);
+    restoreHitRate = restoreHits / (restoreHits + restoreMisses);
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2016, Nils Asmussen
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#ifndef __CPU_DTU_ACCEL_CTXSLOTS_HH__
+#define __CPU_DTU_ACCEL_CTXSLOTS_HH__
+
+#include <string>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "mem/dtu/regfile.hh"
+
+/**
+ * On-chip storage for the contexts of VPEs that have been switched out of
+ * an accelerator. A context is identified by the id of the VPE and the
+ * configuration of the context endpoint, which the kernel points to the
+ * VPE's save area. Since VPE ids are reused, all slots of a VPE are
+ * dropped when the DTU is reset for it, i.e., when a VPE is started or
+ * restarted on the accelerator.
+ *
+ * A slot holding a saved context is the only up-to-date copy of it, so it
+ * can only be reused once that context has been restored again. Slots of
+ * running or restored contexts are reused in LRU order. If all slots hold
+ * saved contexts, the context is spilled to memory as without slots.
+ */
+class AccelCtxSlots
+{
+  public:
+
+    struct Key
+    {
+        uint16_t vpeId;
+        RegFile::reg_t regs[numEpRegs];
+
+        bool operator==(const Key &other) const
+        {
+            if (vpeId != other.vpeId)
+                return false;
+            for (size_t i = 0; i < numEpRegs; ++i)
+            {
+                if (regs[i] != other.regs[i])
+                    return false;
+            }
+            return true;
+        }
+    };
+
+    explicit AccelCtxSlots(unsigned count);
+
+    bool enabled() const { return !slots.empty(); }
+
+    /// returns the slot that holds the saved context for <key> or -1
+    int lookup(const Key &key);
+
+    /// returns the slot to save the context for <key> into or -1
+    int allocate(const Key &key);
+
+    uint8_t *data(int slot, size_t size);
+
+    /// marks the slot as holding the saved context for <key>
+    void saved(int slot, const Key &key);
+
+    /// marks the context in <slot> as restored into the accelerator
+    void restored(int slot);
+
+    /// drops all slots of the VPE <vpeId>
+    void invalidate(uint16_t vpeId);
+
+    void regStats(const std::string &name);
+
+  private:
+
+    struct Slot
+    {
+        Slot() : key(), valid(), saved(), lastUse(), data()
+        {}
+
+        Key key;
+        bool valid;
+        bool saved;
+        uint64_t lastUse;
+        std::vector<uint8_t> data;
+    };
+
+    std::vector<Slot> slots;
+    uint64_t useCount;
+
+    Stats::Scalar saveHits;
+    Stats::Scalar saveSpills;
+    Stats::Scalar restoreHits;
+    Stats::Scalar restoreMisses;
+    Stats::Scalar invalidations;
+    Stats::Formula restoreHitRate;
+};
+
+#endif // __CPU_DTU_ACCEL_CTXSLOTS_HH__
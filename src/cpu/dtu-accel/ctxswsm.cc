@@ -32,7 +32,7 @@
 AccelCtxSwSM::AccelCtxSwSM(DtuAccel *_accel)
     : accel(_accel),
       state(CHECK), stateChanged(),
-      offset(), ctxSwPending(), switched()
+      offset(), ctxSwPending(), switched(), key(), slot(-1)
 {
 }
 
@@ -43,6 +43,9 @@ AccelCtxSwSM::stateName() const
     {
         "SAVE",
         "SAVE_ABORT",
+        "SAVE_VPE",
+        "SAVE_KEY",
+        "SAVE_SLOT",
         "SAVE_WRITE",
         "SAVE_SEND",
         "SAVE_WAIT",
@@ -50,6 +53,9 @@ AccelCtxSwSM::stateName() const
         "WAIT",
         "CHECK",
         "FLAGS",
+        "RESTORE_VPE",
+        "RESTORE_KEY",
+        "RESTORE_SLOT",
         "RESTORE",
         "RESTORE_WAIT",
         "RESTORE_READ",
@@ -58,6 +64,22 @@ AccelCtxSwSM::stateName() const
     return names[static_cast<size_t>(state)];
 }
 
+PacketPtr
+AccelCtxSwSM::createVpePkt()
+{
+    // the kernel sets the VPE id before it starts the switch
+    Addr regAddr = accel->getRegAddr(DtuReg::VPE_ID);
+    return accel->createDtuRegPkt(regAddr, 0, MemCmd::ReadReq);
+}
+
+PacketPtr
+AccelCtxSwSM::createKeyPkt()
+{
+    // the context EP identifies the VPE whose context we switch
+    Addr regAddr = accel->getRegAddr(0, accel->contextEp());
+    return accel->createDtuRegsReadPkt(regAddr, numEpRegs);
+}
+
 PacketPtr
 AccelCtxSwSM::tick()
 {
@@ -81,6 +103,27 @@ AccelCtxSwSM::tick()
             pkt = accel->createDtuRegPkt(regAddr, 0, MemCmd::ReadReq);
             break;
         }
+        case State::SAVE_VPE:
+        {
+            pkt = createVpePkt();
+            break;
+        }
+        case State::SAVE_KEY:
+        {
+            pkt = createKeyPkt();
+            break;
+        }
+        case State::SAVE_SLOT:
+        {
+            size_t rem = accel->stateSize(true) - offset;
+            size_t size = std::min(accel->chunkSize, rem);
+            pkt = accel->createPacket(
+                accel->bufferAddr() + offset,
+                size,
+                MemCmd::ReadReq
+            );
+            break;
+        }
         case State::SAVE_WRITE:
         {
             size_t rem = accel->contextSize(true) - offset;
@@ -139,6 +182,31 @@ AccelCtxSwSM::tick()
             break;
         }
 
+        case State::RESTORE_VPE:
+        {
+            pkt = createVpePkt();
+            break;
+        }
+        case State::RESTORE_KEY:
+        {
+            pkt = createKeyPkt();
+            break;
+        }
+        case State::RESTORE_SLOT:
+        {
+            size_t ctxSize = accel->contextSize(false);
+            size_t stateSize = accel->stateSize(false);
+            size_t rem = stateSize - offset;
+            size_t size = std::min(accel->chunkSize, rem);
+            const uint8_t *data = accel->ctxSlots.data(slot, ctxSize + stateSize);
+            pkt = accel->createPacket(
+                accel->bufferAddr() + offset,
+                size,
+                MemCmd::WriteReq
+            );
+            memcpy(pkt->getPtr<uint8_t>(), data + ctxSize + offset, size);
+            break;
+        }
         case State::RESTORE:
         {
             size_t rem = accel->contextSize(false) + accel->stateSize(false) - offset;
@@ -210,10 +278,56 @@ AccelCtxSwSM::handleMemResp(PacketPtr pkt)
             if (cmd.opcode == 0)
             {
                 offset = 0;
-                if (accel->contextSize(true) > 0)
+                if (accel->contextSize(true) == 0)
+                    state = State::SAVE_DONE;
+                else if (accel->ctxSlots.enabled())
+                    state = State::SAVE_VPE;
+                else
                     state = State::SAVE_WRITE;
+            }
+            break;
+        }
+        case State::SAVE_VPE:
+        {
+            key.vpeId = *reinterpret_cast<const RegFile::reg_t*>(pkt_data);
+            state = State::SAVE_KEY;
+            break;
+        }
+        case State::SAVE_KEY:
+        {
+            memcpy(key.regs, pkt_data, sizeof(key.regs));
+            slot = accel->ctxSlots.allocate(key);
+            // no free slot? spill it to memory
+            if (slot == -1)
+                state = State::SAVE_WRITE;
+            else
+            {
+                size_t ctxSize = accel->contextSize(true);
+                size_t stateSize = accel->stateSize(true);
+                uint8_t *data = accel->ctxSlots.data(slot, ctxSize + stateSize);
+                memcpy(data, accel->context(), ctxSize);
+                if (stateSize > 0)
+                    state = State::SAVE_SLOT;
                 else
+                {
+                    accel->ctxSlots.saved(slot, key);
                     state = State::SAVE_DONE;
+                }
+            }
+            break;
+        }
+        case State::SAVE_SLOT:
+        {
+            size_t ctxSize = accel->contextSize(true);
+            size_t stateSize = accel->stateSize(true);
+            uint8_t *data = accel->ctxSlots.data(slot, ctxSize + stateSize);
+            memcpy(data + ctxSize + offset, pkt_data, pkt->getSize());
+
+            offset += pkt->getSize();
+            if (offset == stateSize)
+            {
+                accel->ctxSlots.saved(slot, key);
+                state = State::SAVE_DONE;
             }
             break;
         }
@@ -267,7 +381,10 @@ AccelCtxSwSM::handleMemResp(PacketPtr pkt)
             {
                 offset = 0;
                 switched = true;
-                state = State::RESTORE;
+                if (accel->ctxSlots.enabled())
+                    state = State::RESTORE_VPE;
+                else
+                    state = State::RESTORE;
             }
             else if (val & DtuAccel::RCTMuxCtrl::STORE)
                 state = State::SAVE;
@@ -282,6 +399,44 @@ AccelCtxSwSM::handleMemResp(PacketPtr pkt)
             }
             break;
         }
+        case State::RESTORE_VPE:
+        {
+            key.vpeId = *reinterpret_cast<const RegFile::reg_t*>(pkt_data);
+            state = State::RESTORE_KEY;
+            break;
+        }
+        case State::RESTORE_KEY:
+        {
+            memcpy(key.regs, pkt_data, sizeof(key.regs));
+            slot = accel->ctxSlots.lookup(key);
+            if (slot == -1)
+                state = State::RESTORE;
+            else
+            {
+                size_t ctxSize = accel->contextSize(false);
+                size_t stateSize = accel->stateSize(false);
+                const uint8_t *data = accel->ctxSlots.data(slot, ctxSize + stateSize);
+                memcpy(accel->context(), data, ctxSize);
+                if (stateSize > 0)
+                    state = State::RESTORE_SLOT;
+                else
+                {
+                    accel->ctxSlots.restored(slot);
+                    state = State::RESTORE_DONE;
+                }
+            }
+            break;
+        }
+        case State::RESTORE_SLOT:
+        {
+            offset += pkt->getSize();
+            if (offset == accel->stateSize(false))
+            {
+                accel->ctxSlots.restored(slot);
+                state = State::RESTORE_DONE;
+            }
+            break;
+        }
         case State::RESTORE:
         {
             ctxSwPending = false;
@@ -41,6 +41,9 @@ class AccelCtxSwSM
     {
         SAVE,
         SAVE_ABORT,
+        SAVE_VPE,
+        SAVE_KEY,
+        SAVE_SLOT,
         SAVE_WRITE,
         SAVE_SEND,
         SAVE_WAIT,
@@ -49,6 +52,9 @@ class AccelCtxSwSM
 
         CHECK,
         FLAGS,
+        RESTORE_VPE,
+        RESTORE_KEY,
+        RESTORE_SLOT,
         RESTORE,
         RESTORE_WAIT,
         RESTORE_READ,
@@ -70,12 +76,18 @@ class AccelCtxSwSM
 
    private:
 
+    PacketPtr createVpePkt();
+
+    PacketPtr createKeyPkt();
+
     DtuAccel *accel;
     State state;
     bool stateChanged;
     Addr offset;
     bool ctxSwPending;
     bool switched;
+    AccelCtxSlots::Key key;
+    int slot;
 };
 
 #endif /* __CPU_DTU_ACCEL_CTXSWSM_HH__ */
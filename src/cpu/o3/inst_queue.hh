@@ -45,10 +45,10 @@
 #define __CPU_O3_INST_QUEUE_HH__
 
 #include <list>
-#include <map>
 #include <queue>
 #include <vector>
 
+#include "base/circular_queue.hh"
 #include "base/statistics.hh"
 #include "base/types.hh"
 #include "cpu/o3/dep_graph.hh"
@@ -91,8 +91,11 @@ class InstructionQueue
     typedef typename Impl::CPUPol::IssueStruct IssueStruct;
     typedef typename Impl::CPUPol::TimeStruct TimeStruct;
 
+    /** Fixed-capacity queue of instructions. */
+    typedef CircularQueue<DynInstPtr> InstQueue;
+
     // Typedef of iterator through the list of instructions.
-    typedef typename std::list<DynInstPtr>::iterator ListIt;
+    typedef typename InstQueue::iterator ListIt;
 
     /** FU completion event class. */
     class FUCompletion : public Event {
@@ -312,23 +315,23 @@ class InstructionQueue
     //////////////////////////////////////
 
     /** List of all the instructions in the IQ (some of which may be issued). */
-    std::list<DynInstPtr> instList[Impl::MaxThreads];
+    InstQueue instList[Impl::MaxThreads];
 
     /** List of instructions that are ready to be executed. */
-    std::list<DynInstPtr> instsToExecute;
+    InstQueue instsToExecute;
 
     /** List of instructions waiting for their DTB translation to
      *  complete (hw page table walk in progress).
      */
-    std::list<DynInstPtr> deferredMemInsts;
+    InstQueue deferredMemInsts;
 
     /** List of instructions that have been cache blocked. */
-    std::list<DynInstPtr> blockedMemInsts;
+    InstQueue blockedMemInsts;
 
     /** List of instructions that were cache blocked, but a retry has been seen
      * since, so they can now be retried. May fail again go on the blocked list.
      */
-    std::list<DynInstPtr> retryMemInsts;
+    InstQueue retryMemInsts;
 
     /**
      * Struct for comparing entries to be added to the priority queue.
@@ -353,15 +356,45 @@ class InstructionQueue
     ReadyInstQueue readyInsts[Num_OpClasses];
 
     /** List of non-speculative instructions that will be scheduled
-     *  once the IQ gets a signal from commit.  While it's redundant to
-     *  have the key be a part of the value (the sequence number is stored
-     *  inside of DynInst), when these instructions are woken up only
-     *  the sequence number will be available.  Thus it is most efficient to be
-     *  able to search by the sequence number alone.
+     *  once the IQ gets a signal from commit.  These instructions are
+     *  woken up by their sequence number, but there are only a few of
+     *  them in flight and they are kept in dispatch order, so that a
+     *  linear search from the oldest one is cheap.
+     */
+    InstQueue nonSpecInsts;
+
+    /** Finds a non-speculative instruction by its sequence number. */
+    ListIt findNonSpec(InstSeqNum seq_num);
+
+    /** Appends an instruction to one of the instruction queues. The
+     *  queues are sized for the common case and only grow if needed.
+     */
+    static void pushInst(InstQueue &queue, const DynInstPtr &inst)
+    {
+        if (queue.full())
+            growInsts(queue);
+        queue.push_back(inst);
+    }
+
+    /** Doubles the capacity of an instruction queue. */
+    static void growInsts(InstQueue &queue);
+
+    /** Removes the oldest instruction from one of the instruction queues. */
+    static DynInstPtr popInst(InstQueue &queue)
+    {
+        // move the pointer out, so that the queue holds no reference
+        DynInstPtr inst = std::move(queue.front());
+        queue.pop_front();
+        return inst;
+    }
+
+    /** Removes an instruction from the middle of an instruction queue,
+     *  keeping the order of the other instructions.
      */
-    std::map<InstSeqNum, DynInstPtr> nonSpecInsts;
+    static void eraseInst(InstQueue &queue, ListIt it);
 
-    typedef typename std::map<InstSeqNum, DynInstPtr>::iterator NonSpecMapIt;
+    /** Removes all instructions from an instruction queue. */
+    static void clearInsts(InstQueue &queue);
 
     /** Entry for the list age ordering by op class. */
     struct ListOrderEntry {
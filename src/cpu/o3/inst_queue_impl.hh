@@ -98,6 +98,16 @@ InstructionQueue<Impl>::InstructionQueue(O3CPU *cpu_ptr, IEW *iew_ptr,
 
     numThreads = params->numThreads;
 
+    // Size the instruction queues. The IQ can hold numEntries instructions
+    // per thread and no more instructions than ROB entries are in flight.
+    for (ThreadID tid = 0; tid < Impl::MaxThreads; tid++)
+        instList[tid] = InstQueue(numEntries);
+    instsToExecute = InstQueue(params->numROBEntries);
+    deferredMemInsts = InstQueue(params->numROBEntries);
+    blockedMemInsts = InstQueue(params->numROBEntries);
+    retryMemInsts = InstQueue(params->numROBEntries);
+    nonSpecInsts = InstQueue(params->numROBEntries);
+
     // Set the number of total physical registers
     // As the vector registers have two addressing modes, they are added twice
     numPhysRegs = params->numPhysIntRegs + params->numPhysFloatRegs +
@@ -412,7 +422,7 @@ InstructionQueue<Impl>::resetState()
     //Initialize thread IQ counts
     for (ThreadID tid = 0; tid < Impl::MaxThreads; tid++) {
         count[tid] = 0;
-        instList[tid].clear();
+        clearInsts(instList[tid]);
     }
 
     // Initialize the number of free IQ entries.
@@ -437,11 +447,12 @@ InstructionQueue<Impl>::resetState()
         queueOnList[i] = false;
         readyIt[i] = listOrder.end();
     }
-    nonSpecInsts.clear();
+    clearInsts(nonSpecInsts);
     listOrder.clear();
-    deferredMemInsts.clear();
-    blockedMemInsts.clear();
-    retryMemInsts.clear();
+    clearInsts(instsToExecute);
+    clearInsts(deferredMemInsts);
+    clearInsts(blockedMemInsts);
+    clearInsts(retryMemInsts);
     wbOutstanding = 0;
 }
 
@@ -606,7 +617,7 @@ InstructionQueue<Impl>::insert(const DynInstPtr &new_inst)
 
     assert(freeEntries != 0);
 
-    instList[new_inst->threadNumber].push_back(new_inst);
+    pushInst(instList[new_inst->threadNumber], new_inst);
 
     --freeEntries;
 
@@ -649,7 +660,7 @@ InstructionQueue<Impl>::insertNonSpec(const DynInstPtr &new_inst)
 
     assert(new_inst);
 
-    nonSpecInsts[new_inst->seqNum] = new_inst;
+    pushInst(nonSpecInsts, new_inst);
 
     DPRINTF(IQ, "Adding non-speculative instruction [sn:%lli] PC %s "
             "to the IQ.\n",
@@ -657,7 +668,7 @@ InstructionQueue<Impl>::insertNonSpec(const DynInstPtr &new_inst)
 
     assert(freeEntries != 0);
 
-    instList[new_inst->threadNumber].push_back(new_inst);
+    pushInst(instList[new_inst->threadNumber], new_inst);
 
     --freeEntries;
 
@@ -694,8 +705,7 @@ typename Impl::DynInstPtr
 InstructionQueue<Impl>::getInstToExecute()
 {
     assert(!instsToExecute.empty());
-    DynInstPtr inst = std::move(instsToExecute.front());
-    instsToExecute.pop_front();
+    DynInstPtr inst = popInst(instsToExecute);
     if (inst->isFloating()) {
         fpInstQueueReads++;
     } else if (inst->isVector()) {
@@ -777,7 +787,7 @@ InstructionQueue<Impl>::processFUCompletion(const DynInstPtr &inst, int fu_idx)
     // of a cycle, otherwise they could add too many instructions to
     // the queue.
     issueToExecuteQueue->access(-1)->size++;
-    instsToExecute.push_back(inst);
+    pushInst(instsToExecute, inst);
 }
 
 // @todo: Figure out a better way to remove the squashed items from the
@@ -871,7 +881,7 @@ InstructionQueue<Impl>::scheduleReadyInsts()
         if (idx != FUPool::NoFreeFU) {
             if (op_latency == Cycles(1)) {
                 i2e_info->size++;
-                instsToExecute.push_back(issuing_inst);
+                pushInst(instsToExecute, issuing_inst);
 
                 // Add the FU onto the list of FU's to be freed next
                 // cycle if we used one.
@@ -958,25 +968,62 @@ InstructionQueue<Impl>::scheduleNonSpec(const InstSeqNum &inst)
     DPRINTF(IQ, "Marking nonspeculative instruction [sn:%lli] as ready "
             "to execute.\n", inst);
 
-    NonSpecMapIt inst_it = nonSpecInsts.find(inst);
+    ListIt inst_it = findNonSpec(inst);
 
     assert(inst_it != nonSpecInsts.end());
 
-    ThreadID tid = (*inst_it).second->threadNumber;
+    ThreadID tid = (*inst_it)->threadNumber;
 
-    (*inst_it).second->setAtCommit();
+    (*inst_it)->setAtCommit();
 
-    (*inst_it).second->setCanIssue();
+    (*inst_it)->setCanIssue();
 
-    if (!(*inst_it).second->isMemRef()) {
-        addIfReady((*inst_it).second);
+    if (!(*inst_it)->isMemRef()) {
+        addIfReady(*inst_it);
     } else {
-        memDepUnit[tid].nonSpecInstReady((*inst_it).second);
+        memDepUnit[tid].nonSpecInstReady(*inst_it);
     }
 
-    (*inst_it).second = NULL;
+    eraseInst(nonSpecInsts, inst_it);
+}
+
+template <class Impl>
+typename InstructionQueue<Impl>::ListIt
+InstructionQueue<Impl>::findNonSpec(InstSeqNum seq_num)
+{
+    ListIt it = nonSpecInsts.begin();
+    while (it != nonSpecInsts.end() && (*it)->seqNum != seq_num)
+        ++it;
+    return it;
+}
+
+template <class Impl>
+void
+InstructionQueue<Impl>::growInsts(InstQueue &queue)
+{
+    InstQueue grown(queue.capacity() * 2);
+    while (!queue.empty())
+        grown.push_back(popInst(queue));
+    queue = std::move(grown);
+}
+
+template <class Impl>
+void
+InstructionQueue<Impl>::eraseInst(InstQueue &queue, ListIt it)
+{
+    // shift the younger instructions down and drop the last slot
+    for (ListIt next = it + 1; next != queue.end(); ++it, ++next)
+        *it = std::move(*next);
+    queue.back() = nullptr;
+    queue.pop_back();
+}
 
-    nonSpecInsts.erase(inst_it);
+template <class Impl>
+void
+InstructionQueue<Impl>::clearInsts(InstQueue &queue)
+{
+    while (!queue.empty())
+        popInst(queue);
 }
 
 template <class Impl>
@@ -986,12 +1033,9 @@ InstructionQueue<Impl>::commit(const InstSeqNum &inst, ThreadID tid)
     DPRINTF(IQ, "[tid:%i]: Committing instructions older than [sn:%i]\n",
             tid,inst);
 
-    ListIt iq_it = instList[tid].begin();
-
-    while (iq_it != instList[tid].end() &&
-           (*iq_it)->seqNum <= inst) {
-        ++iq_it;
-        instList[tid].pop_front();
+    while (!instList[tid].empty() &&
+           instList[tid].front()->seqNum <= inst) {
+        popInst(instList[tid]);
     }
 
     assert(freeEntries == (numEntries - countInsts()));
@@ -1146,7 +1190,7 @@ template <class Impl>
 void
 InstructionQueue<Impl>::deferMemInst(const DynInstPtr &deferred_inst)
 {
-    deferredMemInsts.push_back(deferred_inst);
+    pushInst(deferredMemInsts, deferred_inst);
 }
 
 template <class Impl>
@@ -1158,14 +1202,15 @@ InstructionQueue<Impl>::blockMemInst(const DynInstPtr &blocked_inst)
 
     blocked_inst->clearIssued();
     blocked_inst->clearCanIssue();
-    blockedMemInsts.push_back(blocked_inst);
+    pushInst(blockedMemInsts, blocked_inst);
 }
 
 template <class Impl>
 void
 InstructionQueue<Impl>::cacheUnblocked()
 {
-    retryMemInsts.splice(retryMemInsts.end(), blockedMemInsts);
+    while (!blockedMemInsts.empty())
+        pushInst(retryMemInsts, popInst(blockedMemInsts));
     // Get the CPU ticking again
     cpu->wakeCPU();
 }
@@ -1177,8 +1222,8 @@ InstructionQueue<Impl>::getDeferredMemInstToExecute()
     for (ListIt it = deferredMemInsts.begin(); it != deferredMemInsts.end();
          ++it) {
         if ((*it)->translationCompleted() || (*it)->isSquashed()) {
-            DynInstPtr mem_inst = std::move(*it);
-            deferredMemInsts.erase(it);
+            DynInstPtr mem_inst = *it;
+            eraseInst(deferredMemInsts, it);
             return mem_inst;
         }
     }
@@ -1192,9 +1237,7 @@ InstructionQueue<Impl>::getBlockedMemInstToExecute()
     if (retryMemInsts.empty()) {
         return nullptr;
     } else {
-        DynInstPtr mem_inst = std::move(retryMemInsts.front());
-        retryMemInsts.pop_front();
-        return mem_inst;
+        return popInst(retryMemInsts);
     }
 }
 
@@ -1228,19 +1271,16 @@ template <class Impl>
 void
 InstructionQueue<Impl>::doSquash(ThreadID tid)
 {
-    // Start at the tail.
-    ListIt squash_it = instList[tid].end();
-    --squash_it;
-
     DPRINTF(IQ, "[tid:%i]: Squashing until sequence number %i!\n",
             tid, squashedSeqNum[tid]);
 
     // Squash any instructions younger than the squashed sequence number
-    // given.
-    while (squash_it != instList[tid].end() &&
-           (*squash_it)->seqNum > squashedSeqNum[tid]) {
+    // given, starting at the tail.
+    while (!instList[tid].empty() &&
+           instList[tid].back()->seqNum > squashedSeqNum[tid]) {
 
-        DynInstPtr squashed_inst = (*squash_it);
+        DynInstPtr squashed_inst = std::move(instList[tid].back());
+        instList[tid].pop_back();
         if (squashed_inst->isFloating()) {
             fpInstQueueWrites++;
         } else if (squashed_inst->isVector()) {
@@ -1253,7 +1293,6 @@ InstructionQueue<Impl>::doSquash(ThreadID tid)
         // hasn't already been squashed in the IQ.
         if (squashed_inst->threadNumber != tid ||
             squashed_inst->isSquashedInIQ()) {
-            --squash_it;
             continue;
         }
 
@@ -1303,8 +1342,7 @@ InstructionQueue<Impl>::doSquash(ThreadID tid)
                 }
             } else if (!squashed_inst->isStoreConditional() ||
                        !squashed_inst->isCompleted()) {
-                NonSpecMapIt ns_inst_it =
-                    nonSpecInsts.find(squashed_inst->seqNum);
+                ListIt ns_inst_it = findNonSpec(squashed_inst->seqNum);
 
                 // we remove non-speculative instructions from
                 // nonSpecInsts already when they are ready, and so we
@@ -1317,9 +1355,7 @@ InstructionQueue<Impl>::doSquash(ThreadID tid)
                            squashed_inst->isMemRef());
                 } else {
 
-                    (*ns_inst_it).second = NULL;
-
-                    nonSpecInsts.erase(ns_inst_it);
+                    eraseInst(nonSpecInsts, ns_inst_it);
 
                     ++iqSquashedNonSpecRemoved;
                 }
@@ -1361,7 +1397,6 @@ InstructionQueue<Impl>::doSquash(ThreadID tid)
             assert(dependGraph.empty(dest_reg->flatIndex()));
             dependGraph.clearInst(dest_reg->flatIndex());
         }
-        instList[tid].erase(squash_it--);
         ++iqSquashedInstsExamined;
     }
 }
@@ -1538,14 +1573,14 @@ InstructionQueue<Impl>::dumpLists()
 
     cprintf("Non speculative list size: %i\n", nonSpecInsts.size());
 
-    NonSpecMapIt non_spec_it = nonSpecInsts.begin();
-    NonSpecMapIt non_spec_end_it = nonSpecInsts.end();
+    ListIt non_spec_it = nonSpecInsts.begin();
+    ListIt non_spec_end_it = nonSpecInsts.end();
 
     cprintf("Non speculative list: ");
 
     while (non_spec_it != non_spec_end_it) {
-        cprintf("%s [sn:%lli]", (*non_spec_it).second->pcState(),
-                (*non_spec_it).second->seqNum);
+        cprintf("%s [sn:%lli]", (*non_spec_it)->pcState(),
+                (*non_spec_it)->seqNum);
         ++non_spec_it;
     }
 
@@ -49,6 +49,7 @@
 #include <vector>
 
 #include "arch/registers.hh"
+#include "base/circular_queue.hh"
 #include "base/types.hh"
 #include "config/the_isa.hh"
 
@@ -66,7 +67,7 @@ class ROB
     typedef typename Impl::DynInstPtr DynInstPtr;
 
     typedef std::pair<RegIndex, PhysRegIndex> UnmapInfo;
-    typedef typename std::list<DynInstPtr>::iterator InstIt;
+    typedef typename CircularQueue<DynInstPtr>::iterator InstIt;
 
     /** Possible ROB statuses. */
     enum Status {
@@ -288,8 +289,8 @@ class ROB
     /** Max Insts a Thread Can Have in the ROB */
     unsigned maxEntries[Impl::MaxThreads];
 
-    /** ROB List of Instructions */
-    std::list<DynInstPtr> instList[Impl::MaxThreads];
+    /** ROB List of Instructions. Each thread can occupy the whole ROB. */
+    CircularQueue<DynInstPtr> instList[Impl::MaxThreads];
 
     /** Number of instructions that can be squashed in a single cycle. */
     unsigned squashWidth;
@@ -301,20 +302,30 @@ class ROB
      */
     InstIt tail;
 
+    /** Whether tail points to an instruction. */
+    bool tailValid;
+
     /** Iterator pointing to the instruction which is the first instruction in
      *  in the ROB*/
     InstIt head;
 
+    /** Whether head points to an instruction. */
+    bool headValid;
+
   private:
     /** Iterator used for walking through the list of instructions when
      *  squashing.  Used so that there is persistent state between cycles;
      *  when squashing, the instructions are marked as squashed but not
      *  immediately removed, meaning the tail iterator remains the same before
      *  and after a squash.
-     *  This will always be set to cpu->instList.end() if it is invalid.
+     *  Since the iterators of the CircularQueue are positional, end() cannot
+     *  serve as an "invalid" marker; squashItValid tracks that instead.
      */
     InstIt squashIt[Impl::MaxThreads];
 
+    /** Whether squashIt points to an instruction of the thread. */
+    bool squashItValid[Impl::MaxThreads];
+
   public:
     /** Number of instructions in the ROB. */
     int numInstsInROB;
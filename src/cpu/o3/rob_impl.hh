@@ -107,6 +107,10 @@ ROB<Impl>::ROB(O3CPU *_cpu, DerivO3CPUParams *params)
         maxEntries[tid] = 0;
     }
 
+    for (ThreadID tid = 0; tid < Impl::MaxThreads; tid++) {
+        instList[tid] = CircularQueue<DynInstPtr>(numEntries);
+    }
+
     resetState();
 }
 
@@ -116,16 +120,15 @@ ROB<Impl>::resetState()
 {
     for (ThreadID tid = 0; tid  < Impl::MaxThreads; tid++) {
         threadEntries[tid] = 0;
-        squashIt[tid] = instList[tid].end();
+        squashItValid[tid] = false;
         squashedSeqNum[tid] = 0;
         doneSquashing[tid] = true;
     }
     numInstsInROB = 0;
 
-    // Initialize the "universal" ROB head & tail point to invalid
-    // pointers
-    head = instList[0].end();
-    tail = instList[0].end();
+    // Mark the "universal" ROB head & tail as invalid
+    headValid = false;
+    tailValid = false;
 }
 
 template <class Impl>
@@ -230,6 +233,7 @@ ROB<Impl>::insertInst(const DynInstPtr &inst)
     //Set Up head iterator if this is the 1st instruction in the ROB
     if (numInstsInROB == 0) {
         head = instList[tid].begin();
+        headValid = true;
         assert((*head) == inst);
     }
 
@@ -237,6 +241,7 @@ ROB<Impl>::insertInst(const DynInstPtr &inst)
     //actually points to 1 after the last inst
     tail = instList[tid].end();
     tail--;
+    tailValid = true;
 
     inst->setInROB();
 
@@ -256,11 +261,10 @@ ROB<Impl>::retireHead(ThreadID tid)
 
     assert(numInstsInROB > 0);
 
-    // Get the head ROB instruction by copying it and remove it from the list
-    InstIt head_it = instList[tid].begin();
-
-    DynInstPtr head_inst = std::move(*head_it);
-    instList[tid].erase(head_it);
+    // Get the head ROB instruction by moving it out of the list, so that
+    // the list does not keep a reference, and remove it from the list
+    DynInstPtr head_inst = std::move(instList[tid].front());
+    instList[tid].pop_front();
 
     assert(head_inst->readyToCommit());
 
@@ -336,13 +340,13 @@ ROB<Impl>::doSquash(ThreadID tid)
     DPRINTF(ROB, "[tid:%u]: Squashing instructions until [sn:%i].\n",
             tid, squashedSeqNum[tid]);
 
-    assert(squashIt[tid] != instList[tid].end());
+    assert(squashItValid[tid]);
 
     if ((*squashIt[tid])->seqNum < squashedSeqNum[tid]) {
         DPRINTF(ROB, "[tid:%u]: Done squashing instructions.\n",
                 tid);
 
-        squashIt[tid] = instList[tid].end();
+        squashItValid[tid] = false;
 
         doneSquashing[tid] = true;
         return;
@@ -352,7 +356,7 @@ ROB<Impl>::doSquash(ThreadID tid)
 
     for (int numSquashed = 0;
          numSquashed < squashWidth &&
-         squashIt[tid] != instList[tid].end() &&
+         squashItValid[tid] &&
          (*squashIt[tid])->seqNum > squashedSeqNum[tid];
          ++numSquashed)
     {
@@ -372,7 +376,7 @@ ROB<Impl>::doSquash(ThreadID tid)
             DPRINTF(ROB, "Reached head of instruction list while "
                     "squashing.\n");
 
-            squashIt[tid] = instList[tid].end();
+            squashItValid[tid] = false;
 
             doneSquashing[tid] = true;
 
@@ -394,7 +398,7 @@ ROB<Impl>::doSquash(ThreadID tid)
         DPRINTF(ROB, "[tid:%u]: Done squashing instructions.\n",
                 tid);
 
-        squashIt[tid] = instList[tid].end();
+        squashItValid[tid] = false;
 
         doneSquashing[tid] = true;
     }
@@ -441,17 +445,14 @@ ROB<Impl>::updateHead()
         }
     }
 
-    if (first_valid) {
-        head = instList[0].end();
-    }
-
+    headValid = !first_valid;
 }
 
 template <class Impl>
 void
 ROB<Impl>::updateTail()
 {
-    tail = instList[0].end();
+    tailValid = false;
     bool first_valid = true;
 
     list<ThreadID>::iterator threads = activeThreads->begin();
@@ -469,6 +470,7 @@ ROB<Impl>::updateTail()
         if (first_valid) {
             tail = instList[tid].end();
             tail--;
+            tailValid = true;
             first_valid = false;
             continue;
         }
@@ -510,6 +512,7 @@ ROB<Impl>::squash(InstSeqNum squash_num, ThreadID tid)
         tail_thread--;
 
         squashIt[tid] = tail_thread;
+        squashItValid[tid] = true;
 
         doSquash(tid);
     }
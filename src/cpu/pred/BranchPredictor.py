@@ -159,3 +159,42 @@ class LTAGE(TAGE):
     # Add a direction bit to the loop table entries
     useDirectionBit = Param.Bool(False, "Use direction info")
 
+# TAGE-SC-L branch predictor as described in
+# https://www.jilp.org/cbp2016/paper/AndreSeznecLimited.pdf
+# It is an LTAGE predictor with a statistical corrector (SC) that reverts the
+# TAGE prediction for statistically biased branches. The SC consists of a bias
+# table and GEHL tables (one per history length), all of the same size, which
+# is derived from the storage budget.
+class TAGE_SC_L(LTAGE):
+    type = 'TAGE_SC_L'
+    cxx_class = 'TAGE_SC_L'
+    cxx_header = "cpu/pred/tage_sc_l.hh"
+
+    scStorageBudget = Param.MemorySize("4kB",
+        "Storage budget of the statistical corrector")
+    scHistLengths = VectorParam.Unsigned([0, 4, 10, 16, 27, 40],
+        "Global history lengths of the statistical corrector GEHL tables")
+    scCounterBits = Param.Unsigned(6, "Number of bits per SC counter")
+    scInitialThreshold = Param.Unsigned(35,
+        "Initial threshold to revert the TAGE prediction")
+    scThresholdCtrBits = Param.Unsigned(6,
+        "Size of the counter that adapts the SC threshold")
+
+# Hashed perceptron branch predictor as described in
+# https://www.jilp.org/cbp2016/paper/DanielJimenez1.pdf
+# Each table is indexed with a hash of the PC and a segment of the global
+# history; the first table uses the PC only. All tables have the same size,
+# which is derived from the storage budget.
+class HashedPerceptronBP(BranchPredictor):
+    type = 'HashedPerceptronBP'
+    cxx_class = 'HashedPerceptronBP'
+    cxx_header = "cpu/pred/hashed_perceptron.hh"
+
+    storageBudget = Param.MemorySize("8kB", "Storage budget of the weights")
+    histLengths = VectorParam.Unsigned(
+        [0, 3, 8, 12, 17, 33, 49, 67, 97, 138, 195, 256],
+        "End of the global history segment of each table")
+    weightBits = Param.Unsigned(8, "Number of bits per weight")
+    initialThreshold = Param.Unsigned(35, "Initial training threshold")
+    thresholdCtrBits = Param.Unsigned(7,
+        "Size of the counter that adapts the training threshold")
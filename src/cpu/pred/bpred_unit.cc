@@ -149,6 +149,78 @@ BPredUnit::regStats()
         .desc("Number of mispredicted indirect branches.")
         ;
 
+    static const char *classNames[NUM_BRANCH_CLASSES] = {
+        "CondDirect", "CondIndirect", "UncondDirect", "UncondIndirect",
+        "CallDirect", "CallIndirect", "Return",
+    };
+
+    classCommitted
+        .init(NUM_BRANCH_CLASSES)
+        .name(name() + ".classCommitted")
+        .desc("Number of committed branches per branch class")
+        .flags(Stats::total | Stats::nozero)
+        ;
+
+    classMispredicted
+        .init(NUM_BRANCH_CLASSES)
+        .name(name() + ".classMispredicted")
+        .desc("Number of mispredicted branches per branch class")
+        .flags(Stats::total | Stats::nozero)
+        ;
+
+    classMispredictRate
+        .name(name() + ".classMispredictRate")
+        .desc("Misprediction rate per branch class")
+        .flags(Stats::nozero)
+        .precision(6);
+    classMispredictRate = classMispredicted / classCommitted;
+
+    for (int i = 0; i < NUM_BRANCH_CLASSES; ++i) {
+        classCommitted.subname(i, classNames[i]);
+        classMispredicted.subname(i, classNames[i]);
+        classMispredictRate.subname(i, classNames[i]);
+    }
+}
+
+BPredUnit::BranchClass
+BPredUnit::branchClass(const StaticInstPtr &inst)
+{
+    if (inst->isReturn())
+        return RETURN;
+    bool direct = inst->isDirectCtrl();
+    if (inst->isCall())
+        return direct ? CALL_DIRECT : CALL_INDIRECT;
+    if (inst->isUncondCtrl())
+        return direct ? UNCOND_DIRECT : UNCOND_INDIRECT;
+    return direct ? COND_DIRECT : COND_INDIRECT;
+}
+
+void
+BPredUnit::warm(ThreadID tid, Addr pc, BranchClass br_class, bool taken,
+                Addr target)
+{
+    void *bp_history = NULL;
+
+    if (br_class == COND_DIRECT || br_class == COND_INDIRECT) {
+        bool pred_taken = lookup(tid, pc, bp_history);
+        // like a squash, fix up the speculative history first
+        if (pred_taken != taken)
+            update(tid, pc, taken, bp_history, true);
+    } else {
+        uncondBranch(tid, pc, bp_history);
+    }
+    update(tid, pc, taken, bp_history, false);
+
+    bool indirect = br_class == COND_INDIRECT ||
+                    br_class == UNCOND_INDIRECT ||
+                    br_class == CALL_INDIRECT;
+    if (taken && br_class != RETURN && (!indirect || !useIndirect)) {
+        TheISA::PCState corr_target(target);
+        if (!BTB.valid(pc, tid) ||
+            BTB.lookup(pc, tid).instAddr() != target) {
+            BTB.update(pc, corr_target, tid);
+        }
+    }
 }
 
 ProbePoints::PMUUPtr
@@ -210,7 +282,8 @@ BPredUnit::predict(const StaticInstPtr &inst, const InstSeqNum &seqNum,
             "for PC %s\n", tid, seqNum, pc);
 
     PredictorHistory predict_record(seqNum, pc.instAddr(),
-                                    pred_taken, bp_history, tid);
+                                    pred_taken, bp_history, tid,
+                                    branchClass(inst));
 
     // Now lookup in the BTB or RAS.
     if (pred_taken) {
@@ -334,6 +407,7 @@ BPredUnit::update(const InstSeqNum &done_sn, ThreadID tid)
                     predHist[tid].back().predTaken,
                     predHist[tid].back().bpHistory, false);
 
+        ++classCommitted[predHist[tid].back().brClass];
         predHist[tid].pop_back();
     }
 }
@@ -438,6 +512,8 @@ BPredUnit::squash(const InstSeqNum &squashed_sn,
         // local/global histories. The counter tables will be updated when
         // the branch actually commits.
 
+        ++classMispredicted[hist_it->brClass];
+
         // Remember the correct direction for the update at commit.
         pred_hist.front().predTaken = actually_taken;
 
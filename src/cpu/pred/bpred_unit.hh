@@ -192,6 +192,38 @@ class BPredUnit : public SimObject
 
     void dump();
 
+    /** Branch classes for which mispredictions are counted separately. */
+    enum BranchClass {
+        COND_DIRECT = 0,
+        COND_INDIRECT,
+        UNCOND_DIRECT,
+        UNCOND_INDIRECT,
+        CALL_DIRECT,
+        CALL_INDIRECT,
+        RETURN,
+        NUM_BRANCH_CLASSES
+    };
+
+    /**
+     * Classifies a control instruction.
+     * @param inst The branch instruction.
+     * @return The branch class of the instruction.
+     */
+    static BranchClass branchClass(const StaticInstPtr &inst);
+
+    /**
+     * Trains the predictor with the outcome of an already executed branch
+     * (functional warming). Neither the RAS nor the indirect predictor are
+     * warmed. Must not be called while branches are in flight.
+     * @param tid The thread id.
+     * @param pc The PC of the branch.
+     * @param br_class The class of the branch.
+     * @param taken Whether the branch was taken.
+     * @param target The PC the branch went to, if taken.
+     */
+    void warm(ThreadID tid, Addr pc, BranchClass br_class, bool taken,
+              Addr target);
+
   private:
     struct PredictorHistory {
         /**
@@ -200,10 +232,10 @@ class BPredUnit : public SimObject
          */
         PredictorHistory(const InstSeqNum &seq_num, Addr instPC,
                          bool pred_taken, void *bp_history,
-                         ThreadID _tid)
+                         ThreadID _tid, BranchClass br_class)
             : seqNum(seq_num), pc(instPC), bpHistory(bp_history), RASTarget(0),
               RASIndex(0), tid(_tid), predTaken(pred_taken), usedRAS(0), pushedRAS(0),
-              wasCall(0), wasReturn(0), wasIndirect(0)
+              wasCall(0), wasReturn(0), wasIndirect(0), brClass(br_class)
         {}
 
         bool operator==(const PredictorHistory &entry) const {
@@ -248,6 +280,9 @@ class BPredUnit : public SimObject
 
         /** Wether this instruction was an indirect branch */
         bool wasIndirect;
+
+        /** The class of the branch (for the per-class statistics). */
+        BranchClass brClass;
     };
 
     typedef std::deque<PredictorHistory> History;
@@ -303,6 +338,13 @@ class BPredUnit : public SimObject
     /** Stat for the number of indirect target mispredictions.*/
     Stats::Scalar indirectMispredicted;
 
+    /** Stat for the number of committed branches per branch class. */
+    Stats::Vector classCommitted;
+    /** Stat for the number of mispredicted branches per branch class. */
+    Stats::Vector classMispredicted;
+    /** Stat for the misprediction rate per branch class. */
+    Stats::Formula classMispredictRate;
+
   protected:
     /** Number of bits to shift instructions by for predictor addresses. */
     const unsigned instShiftAmt;
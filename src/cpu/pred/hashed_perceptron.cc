@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2015, Nils Asmussen
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+/* @file
+ * Implementation of a hashed perceptron branch predictor
+ */
+
+#include "cpu/pred/hashed_perceptron.hh"
+
+#include <cstdlib>
+
+#include "base/intmath.hh"
+#include "base/logging.hh"
+#include "base/trace.hh"
+#include "debug/Perceptron.hh"
+
+HashedPerceptronBP::HashedPerceptronBP(
+    const HashedPerceptronBPParams *params)
+    : BPredUnit(params),
+      histLengths(params->histLengths),
+      numTables(histLengths.size()),
+      weightBits(params->weightBits),
+      thresholdCtrBits(params->thresholdCtrBits),
+      weightMax((1 << (weightBits - 1)) - 1),
+      weightMin(-(1 << (weightBits - 1))),
+      logTableSize(0),
+      histMask(0),
+      threadHistory(params->numThreads),
+      threshold(params->initialThreshold),
+      thresholdCtr(0)
+{
+    // the weights are packed into bytes
+    if (weightBits < 2 || weightBits > 8)
+        fatal("Invalid perceptron weight size.\n");
+    if (numTables == 0 || histLengths[0] != 0)
+        fatal("The first perceptron table has to be indexed by the PC.\n");
+    for (unsigned i = 1; i < numTables; ++i) {
+        if (histLengths[i] <= histLengths[i - 1])
+            fatal("Perceptron history lengths have to be increasing.\n");
+    }
+
+    uint64_t entries = (params->storageBudget * 8) /
+                       (numTables * weightBits);
+    if (entries < 2)
+        fatal("Perceptron storage budget of %llu bytes is too small.\n",
+              params->storageBudget);
+    logTableSize = floorLog2(entries);
+    weights.resize(numTables << logTableSize, 0);
+
+    // leave room for the branches in flight behind the longest history
+    const unsigned histSize = ceilPow2(histLengths.back() + 1024);
+    histMask = histSize - 1;
+    for (auto &hist : threadHistory) {
+        hist.bits.resize(histSize, 0);
+        hist.ptr = 0;
+    }
+
+    DPRINTF(Perceptron, "%u tables with %llu weights (%llu bits)\n",
+            numTables, ULL(1) << logTableSize,
+            weights.size() * weightBits);
+}
+
+void
+HashedPerceptronBP::pushHistory(ThreadID tid, bool taken)
+{
+    ThreadHistory &hist = threadHistory[tid];
+    hist.ptr = (hist.ptr - 1) & histMask;
+    hist.bits[hist.ptr] = taken;
+}
+
+unsigned
+HashedPerceptronBP::index(ThreadID tid, Addr pc, unsigned table) const
+{
+    const unsigned mask = (1 << logTableSize) - 1;
+
+    // fold the history segment of the table into logTableSize bits
+    unsigned folded = 0;
+    if (table > 0) {
+        unsigned ptr = threadHistory[tid].ptr;
+        for (unsigned i = histLengths[table - 1]; i < histLengths[table];
+             ++i) {
+            folded = (folded << 1) | histBit(tid, ptr, i);
+            folded ^= folded >> logTableSize;
+            folded &= mask;
+        }
+    }
+
+    Addr pc_bits = pc >> instShiftAmt;
+    unsigned idx = (pc_bits ^ (pc_bits >> logTableSize) ^ folded) & mask;
+    return (table << logTableSize) | idx;
+}
+
+bool
+HashedPerceptronBP::lookup(ThreadID tid, Addr branch_addr, void * &bp_history)
+{
+    BPHistory *history = new BPHistory;
+    history->histPtr = threadHistory[tid].ptr;
+    history->indices.resize(numTables);
+    history->sum = 0;
+    history->condBranch = true;
+
+    for (unsigned i = 0; i < numTables; ++i) {
+        history->indices[i] = index(tid, branch_addr, i);
+        history->sum += weights[history->indices[i]];
+    }
+
+    bool taken = history->sum >= 0;
+    DPRINTF(Perceptron, "Predict for %lx: taken?:%d, sum:%d, threshold:%d\n",
+            branch_addr, taken, history->sum, threshold);
+
+    pushHistory(tid, taken);
+    bp_history = static_cast<void*>(history);
+    return taken;
+}
+
+void
+HashedPerceptronBP::uncondBranch(ThreadID tid, Addr pc, void * &bp_history)
+{
+    BPHistory *history = new BPHistory;
+    history->histPtr = threadHistory[tid].ptr;
+    history->sum = 0;
+    history->condBranch = false;
+
+    pushHistory(tid, true);
+    bp_history = static_cast<void*>(history);
+}
+
+void
+HashedPerceptronBP::btbUpdate(ThreadID tid, Addr branch_addr,
+                              void * &bp_history)
+{
+    // the branch is not taken without a target; fix the speculative history
+    ThreadHistory &hist = threadHistory[tid];
+    hist.bits[hist.ptr] = 0;
+}
+
+void
+HashedPerceptronBP::squash(ThreadID tid, void *bp_history)
+{
+    BPHistory *history = static_cast<BPHistory*>(bp_history);
+    threadHistory[tid].ptr = history->histPtr;
+
+    delete history;
+}
+
+void
+HashedPerceptronBP::update(ThreadID tid, Addr branch_addr, bool taken,
+                           void *bp_history, bool squashed)
+{
+    assert(bp_history);
+
+    BPHistory *history = static_cast<BPHistory*>(bp_history);
+
+    // We do not update the weights speculatively on a squash.
+    // We just repair the global history.
+    if (squashed) {
+        threadHistory[tid].ptr = history->histPtr;
+        pushHistory(tid, taken);
+        return;
+    }
+
+    if (history->condBranch)
+        train(taken, history);
+
+    delete history;
+}
+
+void
+HashedPerceptronBP::train(bool taken, const BPHistory *history)
+{
+    bool pred_wrong = (history->sum >= 0) != taken;
+    if (!pred_wrong && std::abs(history->sum) > threshold)
+        return;
+
+    for (unsigned idx : history->indices) {
+        int8_t &w = weights[idx];
+        if (taken && w < weightMax)
+            w++;
+        else if (!taken && w > weightMin)
+            w--;
+    }
+    weightUpdates++;
+
+    // adapt the threshold as in O-GEHL: raise it on mispredictions, lower
+    // it on correct predictions that were not confident enough
+    const int ctr_max = (1 << (thresholdCtrBits - 1)) - 1;
+    if (pred_wrong) {
+        if (++thresholdCtr >= ctr_max) {
+            threshold++;
+            thresholdCtr = 0;
+            thresholdUpdates++;
+        }
+    } else {
+        if (--thresholdCtr <= -ctr_max - 1) {
+            if (threshold > 0)
+                threshold--;
+            thresholdCtr = 0;
+            thresholdUpdates++;
+        }
+    }
+}
+
+unsigned
+HashedPerceptronBP::getGHR(ThreadID tid, void *bp_history) const
+{
+    const BPHistory *history = static_cast<const BPHistory*>(bp_history);
+    unsigned val = 0;
+    for (unsigned i = 0; i < 32; ++i)
+        val |= static_cast<unsigned>(histBit(tid, history->histPtr, i)) << i;
+    return val;
+}
+
+void
+HashedPerceptronBP::regStats()
+{
+    BPredUnit::regStats();
+
+    weightUpdates
+        .name(name() + ".weightUpdates")
+        .desc("Number of times the perceptron weights were trained")
+        ;
+
+    thresholdUpdates
+        .name(name() + ".thresholdUpdates")
+        .desc("Number of adaptations of the training threshold")
+        ;
+}
+
+HashedPerceptronBP*
+HashedPerceptronBPParams::create()
+{
+    return new HashedPerceptronBP(this);
+}
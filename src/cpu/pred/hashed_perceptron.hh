@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2015, Nils Asmussen
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+/* @file
+ * Implementation of a hashed perceptron branch predictor
+ */
+
+#ifndef __CPU_PRED_HASHED_PERCEPTRON_HH__
+#define __CPU_PRED_HASHED_PERCEPTRON_HH__
+
+#include <vector>
+
+#include "cpu/pred/bpred_unit.hh"
+#include "params/HashedPerceptronBP.hh"
+
+/**
+ * Implements a hashed perceptron branch predictor. The global history is cut
+ * into segments of increasing length and each segment is hashed together with
+ * the PC to select one weight out of its own table. The first table is
+ * indexed by the PC only and acts as the bias weight. The prediction is the
+ * sign of the sum of the selected weights. At commit, the weights are trained
+ * if the prediction was wrong or the magnitude of the sum did not exceed a
+ * threshold that adapts itself to the ratio of mispredictions and
+ * low-confidence predictions.
+ *
+ * All tables have the same size, which is derived from a storage budget.
+ * The weights are signed counters packed into one byte each.
+ */
+class HashedPerceptronBP : public BPredUnit
+{
+  public:
+    HashedPerceptronBP(const HashedPerceptronBPParams *params);
+    void uncondBranch(ThreadID tid, Addr pc, void * &bp_history) override;
+    void squash(ThreadID tid, void *bp_history) override;
+    bool lookup(ThreadID tid, Addr branch_addr, void * &bp_history) override;
+    void btbUpdate(ThreadID tid, Addr branch_addr,
+                   void * &bp_history) override;
+    void update(ThreadID tid, Addr branch_addr, bool taken, void *bp_history,
+                bool squashed) override;
+    unsigned getGHR(ThreadID tid, void *bp_history) const override;
+
+    void regStats() override;
+
+  private:
+    struct BPHistory {
+        // position of the most recent outcome before this branch
+        unsigned histPtr;
+        // selected weight of every table
+        std::vector<unsigned> indices;
+        int sum;
+        bool condBranch;
+    };
+
+    // Speculative global history per thread. The history is a circular
+    // buffer that grows downwards; bits[ptr] is the most recent outcome.
+    struct ThreadHistory {
+        std::vector<uint8_t> bits;
+        unsigned ptr;
+    };
+
+    /**
+     * Returns the i-th most recent outcome in the global history.
+     * @param tid The thread ID to select the history.
+     * @param ptr The position of the most recent outcome.
+     * @param i The age of the outcome.
+     */
+    bool histBit(ThreadID tid, unsigned ptr, unsigned i) const
+    {
+        return threadHistory[tid].bits[(ptr + i) & histMask];
+    }
+
+    /**
+     * (Speculatively) appends an outcome to the global history.
+     * @param tid The thread ID to select the history.
+     * @param taken The (predicted) branch direction.
+     */
+    void pushHistory(ThreadID tid, bool taken);
+
+    /**
+     * Computes the index used to access a weight table.
+     * @param tid The thread ID to select the history.
+     * @param pc The unshifted branch PC.
+     * @param table The weight table to access.
+     */
+    unsigned index(ThreadID tid, Addr pc, unsigned table) const;
+
+    /**
+     * Trains the weights and adapts the threshold.
+     * @param taken Actual branch outcome.
+     * @param history Information recorded at prediction time.
+     */
+    void train(bool taken, const BPHistory *history);
+
+    // the history segment of table i is [histLengths[i-1], histLengths[i])
+    const std::vector<unsigned> histLengths;
+    const unsigned numTables;
+    const unsigned weightBits;
+    const unsigned thresholdCtrBits;
+    const int weightMax;
+    const int weightMin;
+    unsigned logTableSize;
+    unsigned histMask;
+
+    // all weight tables, one after another
+    std::vector<int8_t> weights;
+
+    std::vector<ThreadHistory> threadHistory;
+
+    int threshold;
+    int thresholdCtr;
+
+    Stats::Scalar weightUpdates;
+    Stats::Scalar thresholdUpdates;
+};
+
+#endif // __CPU_PRED_HASHED_PERCEPTRON_HH__
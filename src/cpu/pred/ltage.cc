@@ -244,11 +244,17 @@ LTAGE::loopUpdate(Addr pc, bool taken, LTageBranchInfo* bi)
 
 }
 
+LTAGE::LTageBranchInfo *
+LTAGE::makeBranchInfo()
+{
+    return new LTageBranchInfo(nHistoryTables+1);
+}
+
 //prediction
 bool
 LTAGE::predict(ThreadID tid, Addr branch_pc, bool cond_branch, void* &b)
 {
-    LTageBranchInfo *bi = new LTageBranchInfo(nHistoryTables+1);
+    LTageBranchInfo *bi = makeBranchInfo();
     b = (void*)(bi);
 
     bool pred_taken = tagePredict(tid, branch_pc, cond_branch, bi);
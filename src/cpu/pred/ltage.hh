@@ -69,7 +69,7 @@ class LTAGE: public TAGE
 
     void regStats() override;
 
-  private:
+  protected:
     // Prediction Structures
     // Loop Predictor Entry
     struct LoopEntry
@@ -111,6 +111,12 @@ class LTAGE: public TAGE
         {}
     };
 
+    /**
+     * Allocates the branch information for a new prediction. Derived
+     * predictors override this to extend LTageBranchInfo.
+     */
+    virtual LTageBranchInfo *makeBranchInfo();
+
     /**
      * Computes the index used to access the
      * loop predictor.
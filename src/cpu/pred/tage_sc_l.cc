@@ -0,0 +1,251 @@
+/*
+ * Copyright (c) 2014 The University of Wisconsin
+ *
+ * Copyright (c) 2006 INRIA (Institut National de Recherche en
+ * Informatique et en Automatique  / French National Research Institute
+ * for Computer Science and Applied Mathematics)
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors: Vignyan Reddy, Dibakar Gope and Arthur Perais,
+ * from André Seznec's code.
+ */
+
+/* @file
+ * Implementation of a TAGE-SC-L branch predictor
+ */
+
+#include "cpu/pred/tage_sc_l.hh"
+
+#include "base/intmath.hh"
+#include "base/logging.hh"
+#include "base/trace.hh"
+#include "debug/TageSCL.hh"
+
+TAGE_SC_L::TAGE_SC_L(const TAGE_SC_LParams *params)
+  : LTAGE(params),
+    scHistLengths(params->scHistLengths),
+    scCounterBits(params->scCounterBits),
+    scThresholdCtrBits(params->scThresholdCtrBits),
+    numScTables(scHistLengths.size()),
+    logScTableSize(0),
+    scThreshold(params->scInitialThreshold),
+    scThresholdCtr(0)
+{
+    // the counters are packed into bytes
+    assert(scCounterBits > 1 && scCounterBits <= 8);
+    assert(scThresholdCtrBits > 1);
+
+    for (auto len : scHistLengths) {
+        fatal_if(len > maxHist,
+                 "SC history length %u exceeds the maximum history (%u)\n",
+                 len, maxHist);
+    }
+
+    // the budget is spent on equally sized GEHL tables plus the bias table
+    uint64_t entries = (params->scStorageBudget * 8) /
+                       ((numScTables + 1) * scCounterBits);
+    fatal_if(entries < 2, "SC storage budget of %llu bytes is too small\n",
+             params->scStorageBudget);
+    logScTableSize = floorLog2(entries);
+
+    scTables.resize(numScTables + 1);
+    for (auto &table : scTables)
+        table.resize(ULL(1) << logScTableSize, 0);
+
+    DPRINTF(TageSCL, "SC: %u+1 tables with %llu entries (%llu bits)\n",
+            numScTables, ULL(1) << logScTableSize,
+            (numScTables + 1) * (ULL(1) << logScTableSize) * scCounterBits);
+}
+
+LTAGE::LTageBranchInfo *
+TAGE_SC_L::makeBranchInfo()
+{
+    return new SCBranchInfo(nHistoryTables + 1, numScTables + 1);
+}
+
+unsigned
+TAGE_SC_L::scIndex(ThreadID tid, Addr pc, unsigned table) const
+{
+    const uint8_t *hist = threadHistory[tid].gHist;
+    const unsigned mask = (1 << logScTableSize) - 1;
+
+    // fold the history of the table into logScTableSize bits
+    unsigned folded = 0;
+    for (unsigned i = 0; i < scHistLengths[table]; i++) {
+        folded = (folded << 1) | hist[i];
+        folded ^= folded >> logScTableSize;
+        folded &= mask;
+    }
+
+    Addr pc_bits = pc >> instShiftAmt;
+    return (pc_bits ^ (pc_bits >> logScTableSize) ^ folded) & mask;
+}
+
+unsigned
+TAGE_SC_L::biasIndex(Addr pc, const SCBranchInfo *bi) const
+{
+    // confidence of TAGE: 0 = weak, 1 = medium, 2 = saturated counter
+    unsigned conf = 1;
+    if (bi->hitBank > 0) {
+        int ctr = gtable[bi->hitBank][bi->hitBankIndex].ctr;
+        int centered = abs(2 * ctr + 1);
+        if (centered == 1)
+            conf = 0;
+        else if (centered == (1 << tagTableCounterBits) - 1)
+            conf = 2;
+    }
+
+    Addr pc_bits = pc >> instShiftAmt;
+    unsigned idx = (pc_bits << 3) | (conf << 1) | bi->tagePred;
+    return idx & ((1 << logScTableSize) - 1);
+}
+
+bool
+TAGE_SC_L::predict(ThreadID tid, Addr branch_pc, bool cond_branch, void* &b)
+{
+    bool pred_taken = LTAGE::predict(tid, branch_pc, cond_branch, b);
+
+    SCBranchInfo *bi = static_cast<SCBranchInfo*>(b);
+    bi->tageLoopPred = pred_taken;
+
+    // the loop predictor is only used if it is confident; leave it alone
+    if (!cond_branch || bi->provider == LOOP)
+        return pred_taken;
+
+    bi->scUsed = true;
+    bi->scSum = 0;
+    for (unsigned i = 0; i < numScTables; i++) {
+        bi->scIndices[i] = scIndex(tid, branch_pc, i);
+        bi->scSum += 2 * scTables[i][bi->scIndices[i]] + 1;
+    }
+    bi->scIndices[numScTables] = biasIndex(branch_pc, bi);
+    bi->scSum += 2 * scTables[numScTables][bi->scIndices[numScTables]] + 1;
+    bi->scPred = bi->scSum >= 0;
+
+    if (bi->scPred != pred_taken && abs(bi->scSum) >= scThreshold) {
+        pred_taken = bi->scPred;
+        bi->scOverride = true;
+    }
+
+    DPRINTF(TageSCL, "Predict for %lx: taken?:%d, tageLoopPred:%d, "
+            "scSum:%d, scThreshold:%d\n",
+            branch_pc, pred_taken, bi->tageLoopPred, bi->scSum, scThreshold);
+
+    return pred_taken;
+}
+
+void
+TAGE_SC_L::scUpdate(bool taken, SCBranchInfo* bi)
+{
+    bool sc_wrong = bi->scPred != taken;
+    if (!sc_wrong && abs(bi->scSum) >= scThreshold)
+        return;
+
+    for (unsigned i = 0; i <= numScTables; i++)
+        ctrUpdate(scTables[i][bi->scIndices[i]], taken, scCounterBits);
+
+    // adapt the threshold as in O-GEHL: raise it if the SC mispredicts
+    // frequently, lower it if it is often right but not confident enough
+    const int ctr_max = (1 << (scThresholdCtrBits - 1)) - 1;
+    if (sc_wrong) {
+        if (++scThresholdCtr >= ctr_max) {
+            scThreshold++;
+            scThresholdCtr = 0;
+            scThresholdUpdates++;
+        }
+    } else {
+        if (--scThresholdCtr <= -ctr_max - 1) {
+            if (scThreshold > 1)
+                scThreshold--;
+            scThresholdCtr = 0;
+            scThresholdUpdates++;
+        }
+    }
+}
+
+void
+TAGE_SC_L::condBranchUpdate(Addr branch_pc, bool taken,
+                            TageBranchInfo* tage_bi, int nrand)
+{
+    SCBranchInfo* bi = static_cast<SCBranchInfo*>(tage_bi);
+
+    if (bi->scUsed)
+        scUpdate(taken, bi);
+
+    LTAGE::condBranchUpdate(branch_pc, taken, bi, nrand);
+}
+
+void
+TAGE_SC_L::updateStats(bool taken, TageBranchInfo* bi)
+{
+    LTAGE::updateStats(taken, bi);
+
+    SCBranchInfo * sc_bi = static_cast<SCBranchInfo *>(bi);
+
+    if (sc_bi->scOverride) {
+        if (taken == sc_bi->scPred) {
+            scOverrideCorrect++;
+        } else {
+            scOverrideWrong++;
+        }
+    } else if (sc_bi->scUsed && sc_bi->tageLoopPred != taken &&
+               sc_bi->scPred == taken) {
+        scWouldHaveHit++;
+    }
+}
+
+void
+TAGE_SC_L::regStats()
+{
+    LTAGE::regStats();
+
+    scOverrideCorrect
+        .name(name() + ".scOverrideCorrect")
+        .desc("Number of times the statistical corrector reverted the "
+              "prediction and the prediction is correct");
+
+    scOverrideWrong
+        .name(name() + ".scOverrideWrong")
+        .desc("Number of times the statistical corrector reverted the "
+              "prediction and the prediction is wrong");
+
+    scWouldHaveHit
+        .name(name() + ".scWouldHaveHit")
+        .desc("Number of times the statistical corrector was right but "
+              "below the threshold while TAGE/loop were wrong");
+
+    scThresholdUpdates
+        .name(name() + ".scThresholdUpdates")
+        .desc("Number of adaptations of the statistical corrector "
+              "threshold");
+}
+
+TAGE_SC_L*
+TAGE_SC_LParams::create()
+{
+    return new TAGE_SC_L(this);
+}
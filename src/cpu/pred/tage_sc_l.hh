@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2014 The University of Wisconsin
+ *
+ * Copyright (c) 2006 INRIA (Institut National de Recherche en
+ * Informatique et en Automatique  / French National Research Institute
+ * for Computer Science and Applied Mathematics)
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors: Vignyan Reddy, Dibakar Gope and Arthur Perais,
+ * from André Seznec's code.
+ */
+
+/* @file
+ * Implementation of a TAGE-SC-L branch predictor. It extends L-TAGE with a
+ * statistical corrector (SC): a bias table indexed with the PC, the TAGE
+ * prediction and its confidence, plus a set of GEHL-like tables indexed with
+ * hashes of the PC and global histories of different lengths. The signed
+ * counters of all tables are summed up and the sum reverts the TAGE
+ * prediction if it disagrees and its magnitude exceeds an adaptive threshold.
+ * This catches branches that are statistically biased but poorly correlated
+ * with the global history, for which TAGE is known to be weak.
+ *
+ * The SC tables are sized from a storage budget and keep their counters
+ * packed in bytes.
+ */
+
+#ifndef __CPU_PRED_TAGE_SC_L
+#define __CPU_PRED_TAGE_SC_L
+
+#include <vector>
+
+#include "base/types.hh"
+#include "cpu/pred/ltage.hh"
+#include "params/TAGE_SC_L.hh"
+
+class TAGE_SC_L: public LTAGE
+{
+  public:
+    TAGE_SC_L(const TAGE_SC_LParams *params);
+
+    void regStats() override;
+
+  private:
+    // Primary branch history entry
+    struct SCBranchInfo : public LTageBranchInfo
+    {
+        // table indices, the bias table being the last one
+        std::vector<unsigned> scIndices;
+        int scSum;
+        bool scUsed;
+        bool scPred;
+        // whether the SC reverted the prediction. the provider stays the
+        // one of TAGE, so that its stats are not affected
+        bool scOverride;
+        bool tageLoopPred;
+
+        SCBranchInfo(int sz, int sc_sz)
+            : LTageBranchInfo(sz),
+              scIndices(sc_sz), scSum(0),
+              scUsed(false), scPred(false), scOverride(false),
+              tageLoopPred(false)
+        {}
+    };
+
+    LTageBranchInfo *makeBranchInfo() override;
+
+    /**
+     * Computes the index used to access a GEHL table of the SC.
+     * @param tid The thread ID used to select the global history.
+     * @param pc The unshifted branch PC.
+     * @param table The GEHL table to access.
+     */
+    unsigned scIndex(ThreadID tid, Addr pc, unsigned table) const;
+
+    /**
+     * Computes the index used to access the bias table of the SC.
+     * @param pc The unshifted branch PC.
+     * @param bi Pointer to the prediction information of TAGE.
+     */
+    unsigned biasIndex(Addr pc, const SCBranchInfo *bi) const;
+
+    /**
+     * Get a branch prediction from TAGE-SC-L. *NOT* an override of
+     * BpredUnit::predict().
+     * @param tid The thread ID to select the global
+     * histories to use.
+     * @param branch_pc The unshifted branch PC.
+     * @param cond_branch True if the branch is conditional.
+     * @param b Reference to wrapping pointer to allow storing
+     * derived class prediction information in the base class.
+     */
+    bool predict(
+        ThreadID tid, Addr branch_pc, bool cond_branch, void* &b) override;
+
+    /**
+     * Update TAGE-SC-L for conditional branches.
+     * @param branch_pc The unshifted branch PC.
+     * @param taken Actual branch outcome.
+     * @param bi Pointer to information on the prediction
+     * recorded at prediction time.
+     * @nrand Random int number from 0 to 3
+     */
+    void condBranchUpdate(
+        Addr branch_pc, bool taken, TageBranchInfo* bi, int nrand) override;
+
+    /**
+     * Trains the SC counters and adapts the threshold.
+     * @param taken Actual branch outcome.
+     * @param bi Pointer to information on the prediction
+     * recorded at prediction time.
+     */
+    void scUpdate(bool taken, SCBranchInfo* bi);
+
+    /**
+     * Update the stats
+     * @param taken Actual branch outcome
+     * @param bi Pointer to information on the prediction
+     * recorded at prediction time.
+     */
+    void updateStats(bool taken, TageBranchInfo* bi) override;
+
+    const std::vector<unsigned> scHistLengths;
+    const unsigned scCounterBits;
+    const unsigned scThresholdCtrBits;
+    const unsigned numScTables;
+    unsigned logScTableSize;
+
+    // counter tables; the bias table is the last one
+    std::vector<std::vector<int8_t>> scTables;
+
+    int scThreshold;
+    int scThresholdCtr;
+
+    // stats
+    Stats::Scalar scOverrideCorrect;
+    Stats::Scalar scOverrideWrong;
+    Stats::Scalar scWouldHaveHit;
+    Stats::Scalar scThresholdUpdates;
+};
+
+#endif // __CPU_PRED_TAGE_SC_L
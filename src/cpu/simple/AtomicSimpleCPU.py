@@ -41,6 +41,7 @@
 from m5.params import *
 from BaseSimpleCPU import BaseSimpleCPU
 from SimPoint import SimPoint
+from FunctionalWarmer import FunctionalWarmer
 
 class AtomicSimpleCPU(BaseSimpleCPU):
     """Simple CPU model executing a configurable number of
@@ -61,8 +62,29 @@ class AtomicSimpleCPU(BaseSimpleCPU):
     width = Param.Int(1, "CPU width")
     simulate_data_stalls = Param.Bool(False, "Simulate dcache stall cycles")
     simulate_inst_stalls = Param.Bool(False, "Simulate icache stall cycles")
+    fetch_backdoor = Param.Bool(True, "Fetch instructions via a memory "
+        "backdoor if the memory provides one (ignored with "
+        "simulate_inst_stalls)")
+    bb_cache = Param.Bool(False, "Cache decoded basic blocks per physical "
+        "PC and replay them without fetching, translating or decoding "
+        "(for fast-forwarding; ignored with simulate_inst_stalls)")
+    bb_cache_blocks = Param.Unsigned(16384, "Maximum number of cached "
+        "basic blocks before the cache is flushed")
+    bb_max_insts = Param.Unsigned(64, "Maximum number of instructions per "
+        "basic block")
+    warmer = Param.FunctionalWarmer(NULL, "Functional warmer that is fed "
+        "with the fetches, data accesses and branches of this CPU")
 
     def addSimPointProbe(self, interval):
         simpoint = SimPoint()
         simpoint.interval = interval
         self.probeListener = simpoint
+
+    def addFunctionalWarmer(self, icaches=[], dcaches=[], branch_pred=NULL,
+                            dtu=NULL):
+        warmer = FunctionalWarmer()
+        warmer.icaches = icaches
+        warmer.dcaches = dcaches
+        warmer.branch_pred = branch_pred
+        warmer.dtu = dtu
+        self.warmer = warmer
@@ -0,0 +1,48 @@
+# Copyright (c) 2015 Nils Asmussen
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#
+# 1. Redistributions of source code must retain the above copyright notice, this
+#    list of conditions and the following disclaimer.
+# 2. Redistributions in binary form must reproduce the above copyright notice,
+#    this list of conditions and the following disclaimer in the documentation
+#    and/or other materials provided with the distribution.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+# ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+# DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+# ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+# (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+# LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+# ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+# SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+# The views and conclusions contained in the software and documentation are those
+# of the authors and should not be interpreted as representing official policies,
+# either expressed or implied, of the FreeBSD Project.
+
+from m5.SimObject import SimObject
+from m5.params import *
+from m5.proxy import *
+
+class FunctionalWarmer(SimObject):
+    """Warms caches, the DTU's TLB and a branch predictor on a separate host
+    thread while an AtomicSimpleCPU fast-forwards. Cache blocks are only
+    warmed while the system bypasses the caches (atomic_noncaching)."""
+
+    type = 'FunctionalWarmer'
+    cxx_header = "cpu/simple/func_warmer.hh"
+
+    icaches = VectorParam.BaseCache([], "Caches for instruction fetches, "
+        "from the L1 downwards")
+    dcaches = VectorParam.BaseCache([], "Caches for data accesses, "
+        "from the L1 downwards")
+    branch_pred = Param.BranchPredictor(NULL, "Branch predictor to warm")
+    dtu = Param.Dtu(NULL, "DTU whose TLB is warmed")
+    queue_entries = Param.Unsigned(65536, "Number of entries in the queue "
+        "to the warming thread")
+    system = Param.System(Parent.any, "System this warmer belongs to")
@@ -49,6 +49,7 @@
 #include "base/output.hh"
 #include "config/the_isa.hh"
 #include "cpu/exetrace.hh"
+#include "cpu/simple/func_warmer.hh"
 #include "debug/Drain.hh"
 #include "debug/ExecFaulting.hh"
 #include "debug/SimpleCPU.hh"
@@ -81,15 +82,28 @@ AtomicSimpleCPU::AtomicSimpleCPU(AtomicSimpleCPUParams *p)
       width(p->width), locked(false),
       simulate_data_stalls(p->simulate_data_stalls),
       simulate_inst_stalls(p->simulate_inst_stalls),
+      useFetchBackdoor(p->fetch_backdoor && !p->simulate_inst_stalls),
       icachePort(name() + ".icache_port", this),
       dcachePort(name() + ".dcache_port", this),
       dcache_access(false), dcache_latency(0),
+      fetchBackdoor(nullptr),
+      bbCacheEnabled(p->bb_cache && !p->simulate_inst_stalls &&
+                     p->numThreads == 1),
+      bbMaxInsts(p->bb_max_insts),
+      bbCache(p->bb_cache_blocks, TheISA::PageBytes),
+      bbReplay(nullptr), bbReplayIdx(0), bbReplayPage(0),
+      bbRecordAddr(0), bbRecording(false),
+      warmer(p->warmer),
       ppCommit(nullptr)
 {
     _status = Idle;
     ifetch_req = std::make_shared<Request>();
     data_read_req = std::make_shared<Request>();
     data_write_req = std::make_shared<Request>();
+
+    if (p->bb_cache && !bbCacheEnabled)
+        warn("%s: basic-block cache disabled (needs a single thread and "
+             "no icache stall simulation)\n", name());
 }
 
 
@@ -150,6 +164,9 @@ AtomicSimpleCPU::drainResume()
     DPRINTF(SimpleCPU, "Resume\n");
     verifyMemoryMode();
 
+    // memory might have changed behind our back (e.g., checkpoint restore)
+    bbCacheFlush();
+
     assert(!threadContexts.empty());
 
     _status = BaseSimpleCPU::Idle;
@@ -198,6 +215,11 @@ AtomicSimpleCPU::switchOut()
     assert(!tickEvent.scheduled());
     assert(_status == BaseSimpleCPU::Running || _status == Idle);
     assert(isDrained());
+
+    bbCacheFlush();
+
+    if (warmer)
+        warmer->finish();
 }
 
 
@@ -277,6 +299,43 @@ AtomicSimpleCPU::sendPacket(MasterPort &port, const PacketPtr &pkt)
     return port.sendAtomic(pkt);
 }
 
+bool
+AtomicSimpleCPU::fetchFromBackdoor()
+{
+    if (!fetchBackdoor || ifetch_req->isUncacheable() ||
+        ifetch_req->isMmappedIpr())
+        return false;
+
+    Addr paddr = ifetch_req->getPaddr();
+    unsigned size = ifetch_req->getSize();
+    if (!fetchBackdoor->covers(paddr, size, false))
+        return false;
+
+    memcpy(&inst, fetchBackdoor->hostAddr(paddr), size);
+    return true;
+}
+
+Tick
+AtomicSimpleCPU::sendFetchPacket(PacketPtr pkt)
+{
+    if (!useFetchBackdoor)
+        return sendPacket(icachePort, pkt);
+
+    MemBackdoorPtr bd = nullptr;
+    Tick latency = icachePort.sendAtomicBackdoor(pkt, bd);
+    if (bd && bd != fetchBackdoor) {
+        DPRINTF(SimpleCPU, "Fetching via backdoor for %s\n",
+                bd->range().to_string());
+
+        fetchBackdoor = bd;
+        bd->addInvalidationCallback([this](const MemBackdoor &backdoor) {
+            if (fetchBackdoor == &backdoor)
+                fetchBackdoor = nullptr;
+        });
+    }
+    return latency;
+}
+
 Tick
 AtomicSimpleCPU::AtomicCPUDPort::recvAtomicSnoop(PacketPtr pkt)
 {
@@ -302,6 +361,9 @@ AtomicSimpleCPU::AtomicCPUDPort::recvAtomicSnoop(PacketPtr pkt)
         for (auto &t_info : cpu->threadInfo) {
             TheISA::handleLockedSnoop(t_info->thread, pkt, cacheBlockMask);
         }
+
+        // somebody else (e.g., the DTU) might have written code
+        cpu->bbCacheInvalidate(pkt->getAddr(), pkt->getSize());
     }
 
     return 0;
@@ -329,6 +391,9 @@ AtomicSimpleCPU::AtomicCPUDPort::recvFunctionalSnoop(PacketPtr pkt)
             TheISA::handleLockedSnoop(t_info->thread, pkt, cacheBlockMask);
         }
     }
+
+    if (pkt->isInvalidate() || pkt->isWrite())
+        cpu->bbCacheInvalidate(pkt->getAddr(), pkt->getSize());
 }
 
 Fault
@@ -373,6 +438,9 @@ AtomicSimpleCPU::readMem(Addr addr, uint8_t * data, unsigned size,
                 dcache_latency += TheISA::handleIprRead(thread->getTC(), &pkt);
             } else {
                 dcache_latency += sendPacket(dcachePort, &pkt);
+
+                if (warmer && !req->isUncacheable())
+                    warmer->access(req->getVaddr(), req->getPaddr(), false);
             }
             dcache_access = true;
 
@@ -489,6 +557,11 @@ AtomicSimpleCPU::writeMem(uint8_t *data, unsigned size, Addr addr,
 
                     // Notify other threads on this CPU of write
                     threadSnoop(&pkt, curThread);
+
+                    bbCacheInvalidate(req->getPaddr(), size);
+
+                    if (warmer && !req->isUncacheable())
+                        warmer->access(req->getVaddr(), req->getPaddr(), true);
                 }
                 dcache_access = true;
                 assert(!pkt.isError());
@@ -535,6 +608,160 @@ AtomicSimpleCPU::writeMem(uint8_t *data, unsigned size, Addr addr,
 }
 
 
+bool
+AtomicSimpleCPU::bbCacheReplay(const TheISA::PCState &pc)
+{
+    if (!bbReplay)
+        return false;
+
+    if (bbReplayIdx == bbReplay->insts.size() ||
+        !(bbReplay->insts[bbReplayIdx].pc == pc)) {
+        bbReplay = nullptr;
+        return false;
+    }
+
+    const BasicBlock::Inst &bbInst = bbReplay->insts[bbReplayIdx++];
+    predecodedInst = bbInst.staticInst;
+    predecodedPC = bbInst.decodedPC;
+    ++bbCacheInsts;
+    return true;
+}
+
+bool
+AtomicSimpleCPU::bbCacheFetch(const TheISA::PCState &pc)
+{
+    SimpleExecContext &t_info = *threadInfo[curThread];
+
+    // code in uncacheable memory can change without us noticing it
+    if (ifetch_req->isUncacheable() || ifetch_req->isMmappedIpr()) {
+        bbCacheFinish();
+        return false;
+    }
+
+    Addr page = roundDown(ifetch_req->getPaddr(), TheISA::PageBytes);
+
+    // all bytes of a block have to come from the same page
+    if (t_info.fetchOffset != 0) {
+        if (bbRecording && page != roundDown(bbRecordAddr, TheISA::PageBytes))
+            bbCacheFinish();
+        return false;
+    }
+
+    Addr paddr = page | (pc.instAddr() & (TheISA::PageBytes - 1));
+    const BasicBlock *bb = bbCache.find(paddr);
+    if (bb) {
+        bbCacheFinish();
+        // finishing the recording might have replaced or flushed the block
+        bb = bbCache.find(paddr);
+    }
+
+    if (bb && bb->insts.front().pc == pc) {
+        DPRINTF(SimpleCPU, "Replaying block @ %#x (%u insts)\n",
+                paddr, bb->insts.size());
+
+        ++bbCacheHits;
+        bbReplay = bb;
+        bbReplayIdx = 0;
+        bbReplayPage = page;
+        // the decoder does not see the replayed instructions
+        t_info.thread->decoder.reset();
+        return bbCacheReplay(pc);
+    }
+
+    if (!bbRecording ||
+        page != roundDown(bbRecordAddr, TheISA::PageBytes) ||
+        bbRecord.insts.size() >= bbMaxInsts) {
+        bbCacheFinish();
+
+        ++bbCacheMisses;
+        bbRecording = true;
+        bbRecordAddr = paddr;
+    }
+    return false;
+}
+
+void
+AtomicSimpleCPU::bbCacheRecord(const TheISA::PCState &pc)
+{
+    SimpleExecContext &t_info = *threadInfo[curThread];
+
+    // wait until the decoder has seen all bytes of the instruction
+    if (!bbRecording || t_info.stayAtPC)
+        return;
+
+    const StaticInstPtr &inst = curMacroStaticInst ? curMacroStaticInst
+                                                   : curStaticInst;
+    if (!inst) {
+        bbCacheFinish();
+        return;
+    }
+
+    bbRecord.insts.push_back({pc, t_info.thread->pcState(), inst});
+
+    if (inst->isControl() || inst->isSerializing() ||
+        bbRecord.insts.size() >= bbMaxInsts)
+        bbCacheFinish();
+}
+
+void
+AtomicSimpleCPU::bbCacheFinish()
+{
+    if (!bbRecording)
+        return;
+
+    bbRecording = false;
+    if (bbRecord.insts.empty())
+        return;
+
+    if (bbCache.full())
+        bbCacheFlush();
+
+    bbCache.insert(bbRecordAddr, std::move(bbRecord));
+    bbRecord.insts.clear();
+}
+
+void
+AtomicSimpleCPU::bbCacheInvalidate(Addr addr, Addr size)
+{
+    if (!bbCacheEnabled || (bbCache.empty() && !bbRecording) || size == 0)
+        return;
+
+    Addr first = roundDown(addr, TheISA::PageBytes);
+    Addr last = roundDown(addr + size - 1, TheISA::PageBytes);
+    if (bbRecording) {
+        Addr page = roundDown(bbRecordAddr, TheISA::PageBytes);
+        if (page >= first && page <= last) {
+            bbRecording = false;
+            bbRecord.insts.clear();
+        }
+    }
+
+    unsigned pages = bbCache.invalidate(addr, size);
+    if (pages == 0)
+        return;
+
+    DPRINTF(SimpleCPU, "Invalidated blocks in %u pages in [%#x, %#x]\n",
+            pages, first, last + TheISA::PageBytes - 1);
+
+    if (bbReplay && bbReplayPage >= first && bbReplayPage <= last)
+        bbReplay = nullptr;
+
+    bbCacheInvalidations += pages;
+}
+
+void
+AtomicSimpleCPU::bbCacheFlush()
+{
+    if (bbCache.empty() && !bbRecording)
+        return;
+
+    ++bbCacheFlushes;
+    bbCache.flush();
+    bbReplay = nullptr;
+    bbRecording = false;
+    bbRecord.insts.clear();
+}
+
 void
 AtomicSimpleCPU::tick()
 {
@@ -562,6 +789,9 @@ AtomicSimpleCPU::tick()
         updateCycleCounters(BaseCPU::CPU_STATE_ON);
 
         if (!curStaticInst || !curStaticInst->isDelayedCommit()) {
+            // interrupts might change the state the decoder depends on
+            if (bbCacheEnabled && checkInterrupts(thread->getTC()))
+                bbCacheFlush();
             checkForInterrupts();
             checkPcEventQueue();
         }
@@ -578,7 +808,9 @@ AtomicSimpleCPU::tick()
 
         bool needToFetch = !isRomMicroPC(pcState.microPC()) &&
                            !curMacroStaticInst;
-        if (needToFetch) {
+        bool replayed = bbCacheEnabled && needToFetch &&
+                        bbCacheReplay(pcState);
+        if (needToFetch && !replayed) {
             ifetch_req->taskId(taskId());
             setupFetchRequest(ifetch_req);
             fault = thread->itb->translateAtomic(ifetch_req, thread->getTC(),
@@ -590,7 +822,10 @@ AtomicSimpleCPU::tick()
             bool icache_access = false;
             dcache_access = false; // assume no dcache access
 
-            if (needToFetch) {
+            if (needToFetch && !replayed && bbCacheEnabled)
+                replayed = bbCacheFetch(pcState);
+
+            if (needToFetch && !replayed) {
                 // This is commented out because the decoder would act like
                 // a tiny cache otherwise. It wouldn't be flushed when needed
                 // like the I cache. It should be flushed, and when that works
@@ -599,20 +834,38 @@ AtomicSimpleCPU::tick()
                 //if (decoder.needMoreBytes())
                 //{
                     icache_access = true;
-                    Packet ifetch_pkt = Packet(ifetch_req, MemCmd::ReadReq);
-                    ifetch_pkt.dataStatic(&inst);
+                    if (!fetchFromBackdoor()) {
+                        Packet ifetch_pkt = Packet(ifetch_req,
+                                                   MemCmd::ReadReq);
+                        ifetch_pkt.dataStatic(&inst);
 
-                    icache_latency = sendPacket(icachePort, &ifetch_pkt);
+                        icache_latency = sendFetchPacket(&ifetch_pkt);
 
-                    assert(!ifetch_pkt.isError());
+                        assert(!ifetch_pkt.isError());
+                    }
 
                     // ifetch_req is initialized to read the instruction directly
                     // into the CPU object's inst field.
                 //}
             }
 
+            if (warmer && needToFetch) {
+                Addr pc = pcState.instAddr();
+                if (replayed) {
+                    warmer->fetch(pc, bbReplayPage |
+                                      (pc & (TheISA::PageBytes - 1)));
+                } else if (!ifetch_req->isUncacheable() &&
+                           !ifetch_req->isMmappedIpr()) {
+                    warmer->fetch(ifetch_req->getVaddr(),
+                                  ifetch_req->getPaddr());
+                }
+            }
+
             preExecute();
 
+            if (needToFetch && !replayed && bbCacheEnabled)
+                bbCacheRecord(pcState);
+
             Tick stall_ticks = 0;
             if (curStaticInst) {
                 fault = curStaticInst->execute(&t_info, traceData);
@@ -621,6 +874,13 @@ AtomicSimpleCPU::tick()
                 if (fault == NoFault) {
                     countInst();
                     ppCommit->notify(std::make_pair(thread, curStaticInst));
+
+                    if (warmer && curStaticInst->isControl()) {
+                        TheISA::PCState pc_state = thread->pcState();
+                        warmer->branch(curThread, pc_state.instAddr(),
+                            BPredUnit::branchClass(curStaticInst),
+                            pc_state.branching(), pc_state.npc());
+                    }
                 }
                 else if (traceData && !DTRACE(ExecFaulting)) {
                     delete traceData;
@@ -636,6 +896,10 @@ AtomicSimpleCPU::tick()
                 }
 
                 postExecute();
+
+                // the decoder state might have changed
+                if (bbCacheEnabled && curStaticInst->isSerializing())
+                    bbCacheFlush();
             }
 
             // @todo remove me after debugging with legion done
@@ -658,6 +922,15 @@ AtomicSimpleCPU::tick()
             }
 
         }
+
+        // faults might switch the execution mode in full-system mode
+        if (bbCacheEnabled && fault != NoFault) {
+            if (FullSystem)
+                bbCacheFlush();
+            else
+                bbCacheFinish();
+        }
+
         if (fault != NoFault || !t_info.stayAtPC)
             advancePC(fault);
     }
@@ -682,6 +955,37 @@ AtomicSimpleCPU::regProbePoints()
                                 (getProbeManager(), "Commit");
 }
 
+void
+AtomicSimpleCPU::regStats()
+{
+    BaseSimpleCPU::regStats();
+
+    bbCacheHits
+        .name(name() + ".bbCacheHits")
+        .desc("Number of basic blocks replayed from the block cache")
+        ;
+
+    bbCacheMisses
+        .name(name() + ".bbCacheMisses")
+        .desc("Number of basic blocks recorded for the block cache")
+        ;
+
+    bbCacheInsts
+        .name(name() + ".bbCacheInsts")
+        .desc("Number of instructions replayed from the block cache")
+        ;
+
+    bbCacheInvalidations
+        .name(name() + ".bbCacheInvalidations")
+        .desc("Number of code pages invalidated due to writes")
+        ;
+
+    bbCacheFlushes
+        .name(name() + ".bbCacheFlushes")
+        .desc("Number of times the block cache has been flushed")
+        ;
+}
+
 void
 AtomicSimpleCPU::printAddr(Addr a)
 {
@@ -43,12 +43,17 @@
 #ifndef __CPU_SIMPLE_ATOMIC_HH__
 #define __CPU_SIMPLE_ATOMIC_HH__
 
+#include <vector>
+
 #include "cpu/simple/base.hh"
+#include "cpu/simple/bb_cache.hh"
 #include "cpu/simple/exec_context.hh"
 #include "mem/request.hh"
 #include "params/AtomicSimpleCPU.hh"
 #include "sim/probe/probe.hh"
 
+class FunctionalWarmer;
+
 class AtomicSimpleCPU : public BaseSimpleCPU
 {
   public:
@@ -66,6 +71,7 @@ class AtomicSimpleCPU : public BaseSimpleCPU
     bool locked;
     const bool simulate_data_stalls;
     const bool simulate_inst_stalls;
+    const bool useFetchBackdoor;
 
     // main simulation loop (one cycle)
     void tick();
@@ -167,6 +173,88 @@ class AtomicSimpleCPU : public BaseSimpleCPU
     bool dcache_access;
     Tick dcache_latency;
 
+    /** Backdoor to the memory we currently fetch instructions from. */
+    MemBackdoorPtr fetchBackdoor;
+
+    /**
+     * Tries to read the instruction described by ifetch_req via the fetch
+     * backdoor into inst.
+     *
+     * @return true on success
+     */
+    bool fetchFromBackdoor();
+
+    /** Sends the given instruction fetch packet to the icache port. */
+    Tick sendFetchPacket(PacketPtr pkt);
+
+    /**
+     * A straight-line sequence of decoded instructions within one
+     * physical page. Blocks are recorded while fetching normally and
+     * replayed later without fetching, translating or decoding.
+     */
+    struct BasicBlock
+    {
+        struct Inst
+        {
+            /** The PC state before decoding. */
+            TheISA::PCState pc;
+            /** The PC state after decoding. */
+            TheISA::PCState decodedPC;
+            StaticInstPtr staticInst;
+        };
+
+        std::vector<Inst> insts;
+    };
+
+    /** Whether decoded basic blocks are cached. */
+    const bool bbCacheEnabled;
+    /** The maximum number of instructions per block. */
+    const unsigned bbMaxInsts;
+
+    /** The cached blocks. */
+    BasicBlockCache<BasicBlock> bbCache;
+
+    /** The block that is replayed and the index of its next instruction. */
+    const BasicBlock *bbReplay;
+    size_t bbReplayIdx;
+    Addr bbReplayPage;
+
+    /** The block that is recorded, if bbRecording is set. */
+    BasicBlock bbRecord;
+    Addr bbRecordAddr;
+    bool bbRecording;
+
+    /**
+     * Hands the next instruction of the replayed block to preExecute() if
+     * it starts at the given PC state. Stops the replay otherwise.
+     *
+     * @return true if the instruction has been replayed
+     */
+    bool bbCacheReplay(const TheISA::PCState &pc);
+
+    /**
+     * Looks up the block at the just translated ifetch_req and starts to
+     * replay it. If there is none, a new block is recorded.
+     *
+     * @return true if the instruction has been replayed
+     */
+    bool bbCacheFetch(const TheISA::PCState &pc);
+
+    /** Appends the instruction decoded by preExecute() to the recording. */
+    void bbCacheRecord(const TheISA::PCState &pc);
+
+    /** Adds the recorded block to the cache. */
+    void bbCacheFinish();
+
+    Stats::Scalar bbCacheHits;
+    Stats::Scalar bbCacheMisses;
+    Stats::Scalar bbCacheInsts;
+    Stats::Scalar bbCacheInvalidations;
+    Stats::Scalar bbCacheFlushes;
+
+    /** Receives the accesses and branches for functional warming. */
+    FunctionalWarmer *warmer;
+
     /** Probe Points. */
     ProbePointArg<std::pair<SimpleThread*, const StaticInstPtr>> *ppCommit;
 
@@ -205,11 +293,24 @@ class AtomicSimpleCPU : public BaseSimpleCPU
 
     void regProbePoints() override;
 
+    void regStats() override;
+
     /**
      * Print state of address in memory system via PrintReq (for
      * debugging).
      */
     void printAddr(Addr a);
+
+    /**
+     * Drops all cached basic blocks in the pages touched by the given
+     * range. Writes by the CPU itself and snooped writes call this
+     * automatically; others that write to code the CPU might have executed
+     * without being snooped (e.g., a DTU) have to call it explicitly.
+     */
+    void bbCacheInvalidate(Addr addr, Addr size);
+
+    /** Drops all blocks, e.g., because the decoder state may change. */
+    void bbCacheFlush();
 };
 
 #endif // __CPU_SIMPLE_ATOMIC_HH__
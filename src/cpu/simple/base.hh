@@ -107,6 +107,14 @@ class BaseSimpleCPU : public BaseCPU
     StaticInstPtr curStaticInst;
     StaticInstPtr curMacroStaticInst;
 
+    /**
+     * An already decoded instruction and the PC state the decoder would
+     * have produced for it. If set, the next preExecute() uses them
+     * instead of passing the fetched bytes to the decoder.
+     */
+    StaticInstPtr predecodedInst;
+    TheISA::PCState predecodedPC;
+
   protected:
     enum Status {
         Idle,
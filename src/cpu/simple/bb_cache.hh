@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2015, Nils Asmussen
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#ifndef __CPU_SIMPLE_BB_CACHE_HH__
+#define __CPU_SIMPLE_BB_CACHE_HH__
+
+#include <unordered_map>
+#include <utility>
+
+#include "base/types.hh"
+
+/**
+ * The decoded basic blocks of a CPU, indexed by the physical address of
+ * their first instruction. Blocks are grouped by page, so that writes to
+ * code drop all blocks of the written pages at once.
+ */
+template <class Block>
+class BasicBlockCache
+{
+  public:
+    /**
+     * @param max_blocks the number of blocks before the cache is flushed
+     * @param page_size the page size (power of 2)
+     */
+    BasicBlockCache(size_t max_blocks, Addr page_size)
+        : numBlocks(0), maxBlocks(max_blocks), pageMask(~(page_size - 1))
+    {}
+
+    /** @return the block at <paddr> or nullptr */
+    Block *
+    find(Addr paddr)
+    {
+        auto pageIt = pages.find(paddr & pageMask);
+        if (pageIt == pages.end())
+            return nullptr;
+        auto it = pageIt->second.find(paddr);
+        return it == pageIt->second.end() ? nullptr : &it->second;
+    }
+
+    /**
+     * Adds or replaces the block at <paddr>. If the cache is full, it is
+     * flushed first.
+     */
+    void
+    insert(Addr paddr, Block &&block)
+    {
+        if (full())
+            flush();
+
+        auto res = pages[paddr & pageMask].emplace(paddr, Block());
+        if (res.second)
+            numBlocks++;
+        res.first->second = std::move(block);
+    }
+
+    /**
+     * Drops all blocks in the pages touched by the given range.
+     *
+     * @return the number of pages that contained blocks
+     */
+    unsigned
+    invalidate(Addr addr, Addr size)
+    {
+        unsigned dropped = 0;
+        if (size == 0)
+            return dropped;
+
+        Addr page = addr & pageMask;
+        Addr last = (addr + size - 1) & pageMask;
+        for (;; page += ~pageMask + 1) {
+            auto it = pages.find(page);
+            if (it != pages.end()) {
+                numBlocks -= it->second.size();
+                pages.erase(it);
+                dropped++;
+            }
+            if (page == last)
+                break;
+        }
+        return dropped;
+    }
+
+    /** Drops all blocks */
+    void
+    flush()
+    {
+        pages.clear();
+        numBlocks = 0;
+    }
+
+    bool empty() const { return numBlocks == 0; }
+    bool full() const { return numBlocks >= maxBlocks; }
+    size_t size() const { return numBlocks; }
+
+  private:
+    std::unordered_map<Addr, std::unordered_map<Addr, Block>> pages;
+    size_t numBlocks;
+    const size_t maxBlocks;
+    const Addr pageMask;
+};
+
+#endif // __CPU_SIMPLE_BB_CACHE_HH__
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2015, Nils Asmussen
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#include <gtest/gtest.h>
+
+#include "cpu/simple/bb_cache.hh"
+
+struct Block
+{
+    int code;
+};
+
+static const Addr PAGE_SIZE = 0x1000;
+
+// Code that is loaded again to the same address is not replayed from the
+// old block, once the writer invalidated the range
+TEST(BasicBlockCacheTest, Reload)
+{
+    BasicBlockCache<Block> bbc(16, PAGE_SIZE);
+    bbc.insert(0x1000, Block{1});
+    bbc.insert(0x1040, Block{2});
+    ASSERT_NE(nullptr, bbc.find(0x1000));
+    EXPECT_EQ(1, bbc.find(0x1000)->code);
+
+    // the new code only covers the first block, but the page is dropped
+    EXPECT_EQ(1, bbc.invalidate(0x1000, 0x20));
+    EXPECT_EQ(nullptr, bbc.find(0x1000));
+    EXPECT_EQ(nullptr, bbc.find(0x1040));
+    EXPECT_TRUE(bbc.empty());
+
+    bbc.insert(0x1000, Block{3});
+    ASSERT_NE(nullptr, bbc.find(0x1000));
+    EXPECT_EQ(3, bbc.find(0x1000)->code);
+}
+
+// Invalidations drop all touched pages, and only these
+TEST(BasicBlockCacheTest, InvalidateRange)
+{
+    BasicBlockCache<Block> bbc(16, PAGE_SIZE);
+    bbc.insert(0x1000, Block{1});
+    bbc.insert(0x2000, Block{2});
+    bbc.insert(0x3ff0, Block{3});
+    bbc.insert(0x4000, Block{4});
+    EXPECT_EQ(4, bbc.size());
+
+    EXPECT_EQ(0, bbc.invalidate(0x5000, 0x100));
+    EXPECT_EQ(0, bbc.invalidate(0x2000, 0));
+    EXPECT_EQ(4, bbc.size());
+
+    // crosses the boundary between the second and third page
+    EXPECT_EQ(2, bbc.invalidate(0x2ff8, 0x10));
+    EXPECT_EQ(nullptr, bbc.find(0x2000));
+    EXPECT_EQ(nullptr, bbc.find(0x3ff0));
+    EXPECT_NE(nullptr, bbc.find(0x1000));
+    EXPECT_NE(nullptr, bbc.find(0x4000));
+    EXPECT_EQ(2, bbc.size());
+}
+
+// Blocks at the same address are replaced
+TEST(BasicBlockCacheTest, Replace)
+{
+    BasicBlockCache<Block> bbc(16, PAGE_SIZE);
+    bbc.insert(0x1000, Block{1});
+    bbc.insert(0x1000, Block{2});
+    EXPECT_EQ(1, bbc.size());
+    EXPECT_EQ(2, bbc.find(0x1000)->code);
+}
+
+// A full cache is flushed before a new block is inserted
+TEST(BasicBlockCacheTest, Full)
+{
+    BasicBlockCache<Block> bbc(2, PAGE_SIZE);
+    bbc.insert(0x1000, Block{1});
+    EXPECT_FALSE(bbc.full());
+    bbc.insert(0x2000, Block{2});
+    EXPECT_TRUE(bbc.full());
+
+    bbc.insert(0x3000, Block{3});
+    EXPECT_EQ(1, bbc.size());
+    EXPECT_EQ(nullptr, bbc.find(0x1000));
+    EXPECT_EQ(3, bbc.find(0x3000)->code);
+
+    bbc.flush();
+    EXPECT_TRUE(bbc.empty());
+    EXPECT_EQ(nullptr, bbc.find(0x3000));
+}
@@ -0,0 +1,361 @@
+/*
+ * Copyright (c) 2015, Nils Asmussen
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#include "cpu/simple/func_warmer.hh"
+
+#include <algorithm>
+#include <chrono>
+
+#include "base/random.hh"
+#include "debug/FuncWarmer.hh"
+#include "mem/cache/base.hh"
+#include "mem/dtu/dtu.hh"
+#include "sim/system.hh"
+
+FunctionalWarmer::FunctionalWarmer(const FunctionalWarmerParams *p)
+    : SimObject(p),
+      icaches(p->icaches), dcaches(p->dcaches),
+      bpred(p->branch_pred), dtu(p->dtu), system(p->system),
+      lineMask(~static_cast<Addr>(p->system->cacheLineSize() - 1)),
+      queue(p->queue_entries), pushed(0), processed(0), stopping(false),
+      warmQueue(name() + ".warmQueue"), lastTick(0),
+      lastFetchLine(MaxAddr), lastDataLine(MaxAddr),
+      maxPages(0),
+      cacheHitCount(0), cacheMissCount(0), branchCount(0)
+{
+    if (dtu && dtu->tlb())
+        maxPages = dtu->tlb()->capacity();
+}
+
+FunctionalWarmer::~FunctionalWarmer()
+{
+    stop();
+}
+
+void
+FunctionalWarmer::startup()
+{
+    start();
+}
+
+void
+FunctionalWarmer::start()
+{
+    stopping.store(false, std::memory_order_relaxed);
+
+    // random_mt is thread-local. seed the warmer's instance like the one of
+    // the main thread, so that, e.g., random replacement stays deterministic
+    uint32_t seed = random_mt.seed();
+    warmer = std::thread([this, seed]() {
+        random_mt.init(seed);
+        run();
+    });
+}
+
+void
+FunctionalWarmer::stop()
+{
+    if (warmer.joinable()) {
+        stopping.store(true, std::memory_order_release);
+        warmer.join();
+    }
+}
+
+void
+FunctionalWarmer::regStats()
+{
+    SimObject::regStats();
+
+    fetches
+        .name(name() + ".fetches")
+        .desc("Number of recorded instruction fetches")
+        ;
+
+    accesses
+        .name(name() + ".accesses")
+        .desc("Number of recorded data accesses")
+        ;
+
+    branches
+        .name(name() + ".branches")
+        .desc("Number of branches applied to the branch predictor")
+        ;
+
+    cacheHits
+        .name(name() + ".cacheHits")
+        .desc("Number of warming accesses that hit in the first cache")
+        ;
+
+    cacheMisses
+        .name(name() + ".cacheMisses")
+        .desc("Number of warming accesses that missed in the first cache")
+        ;
+
+    tlbPages
+        .name(name() + ".tlbPages")
+        .desc("Number of pages applied to the TLB")
+        ;
+
+    queueStalls
+        .name(name() + ".queueStalls")
+        .desc("Number of times the CPU waited for a free queue slot")
+        ;
+}
+
+DrainState
+FunctionalWarmer::drain()
+{
+    // nothing may be left in the queue when the memory mode changes
+    flush();
+    return DrainState::Drained;
+}
+
+void
+FunctionalWarmer::fetch(Addr vaddr, Addr paddr)
+{
+    Addr line = paddr & lineMask;
+    if (line == lastFetchLine)
+        return;
+    lastFetchLine = line;
+
+    touchPage(vaddr, DtuTlb::EXEC | DtuTlb::READ);
+
+    if (icaches.empty() || !system->bypassCaches())
+        return;
+
+    Record rec = Record();
+    rec.type = Record::IFETCH;
+    rec.addr = line;
+    push(rec);
+    fetches++;
+}
+
+void
+FunctionalWarmer::access(Addr vaddr, Addr paddr, bool write)
+{
+    Addr line = paddr & lineMask;
+    if (line == lastDataLine)
+        return;
+    lastDataLine = line;
+
+    touchPage(vaddr, write ? DtuTlb::WRITE : DtuTlb::READ);
+
+    if (dcaches.empty() || !system->bypassCaches())
+        return;
+
+    Record rec = Record();
+    rec.type = Record::DATA;
+    rec.addr = line;
+    push(rec);
+    accesses++;
+}
+
+void
+FunctionalWarmer::branch(ThreadID tid, Addr pc,
+                         BPredUnit::BranchClass br_class,
+                         bool taken, Addr target)
+{
+    if (!bpred)
+        return;
+
+    Record rec = Record();
+    rec.type = Record::BRANCH;
+    rec.brClass = br_class;
+    rec.taken = taken;
+    rec.tid = tid;
+    rec.addr = pc;
+    rec.target = target;
+    push(rec);
+}
+
+void
+FunctionalWarmer::push(const Record &rec)
+{
+    Record r = rec;
+    r.when = curTick();
+
+    // we stopped the thread when the detailed CPU took over
+    if (!warmer.joinable())
+        start();
+
+    if (!queue.tryPush(r)) {
+        queueStalls++;
+        while (!queue.tryPush(r))
+            std::this_thread::yield();
+    }
+    pushed++;
+}
+
+void
+FunctionalWarmer::touchPage(Addr vaddr, uint access)
+{
+    if (maxPages == 0)
+        return;
+
+    Addr virt = vaddr & ~static_cast<Addr>(DtuTlb::PAGE_MASK);
+    if (!pages.empty() && pages.front().virt == virt) {
+        pages.front().access |= access;
+        return;
+    }
+
+    auto it = pageMap.find(virt);
+    if (it != pageMap.end()) {
+        it->second->access |= access;
+        pages.splice(pages.begin(), pages, it->second);
+        return;
+    }
+
+    if (pages.size() == maxPages) {
+        pageMap.erase(pages.back().virt);
+        pages.pop_back();
+    }
+    pages.push_front(Page{virt, access});
+    pageMap[virt] = pages.begin();
+}
+
+void
+FunctionalWarmer::flush()
+{
+    while (processed.load(std::memory_order_acquire) != pushed)
+        std::this_thread::yield();
+
+    cacheHits = cacheHitCount;
+    cacheMisses = cacheMissCount;
+    branches = branchCount;
+}
+
+void
+FunctionalWarmer::finish()
+{
+    flush();
+    // nothing to warm until we fast-forward again, so don't keep polling
+    stop();
+
+    // the snoop filters below a cache track the caches above as a whole,
+    // so they have to learn about the blocks of all caches above them
+    std::map<BaseCache*, std::vector<BaseCache*>> below;
+    for (auto chain : {&icaches, &dcaches}) {
+        for (size_t i = 0; i < chain->size(); ++i) {
+            auto &b = below[(*chain)[i]];
+            b.insert(b.end(), chain->begin() + i + 1, chain->end());
+        }
+    }
+    for (auto &c : below) {
+        std::sort(c.second.begin(), c.second.end());
+        c.second.erase(std::unique(c.second.begin(), c.second.end()),
+                       c.second.end());
+        c.first->fillWarmedBlocks(c.second);
+    }
+
+    // apply the pages from the least to the most recently used one
+    for (auto it = pages.rbegin(); it != pages.rend(); ++it) {
+        dtu->warmTlb(it->virt, it->access | DtuTlb::INTERN);
+        tlbPages++;
+    }
+    pages.clear();
+    pageMap.clear();
+
+    lastFetchLine = MaxAddr;
+    lastDataLine = MaxAddr;
+
+    DPRINTF(FuncWarmer, "Finished warming: %llu records\n", pushed);
+}
+
+void
+FunctionalWarmer::run()
+{
+    // the tags and replacement policies use curTick()
+    curEventQueue(&warmQueue);
+
+    unsigned idle = 0;
+    Record rec = Record();
+    while (true) {
+        if (queue.tryPop(rec)) {
+            process(rec);
+            processed.store(processed.load(std::memory_order_relaxed) + 1,
+                            std::memory_order_release);
+            idle = 0;
+        } else if (stopping.load(std::memory_order_acquire)) {
+            break;
+        } else if (++idle < 1024) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+}
+
+void
+FunctionalWarmer::process(const Record &rec)
+{
+    // keep the order of accesses within a tick for the replacement state
+    lastTick = std::max(rec.when, lastTick + 1);
+    warmQueue.setCurTick(lastTick);
+
+    switch (rec.type) {
+      case Record::IFETCH:
+        if (warmCaches(icaches, rec.addr))
+            cacheHitCount++;
+        else
+            cacheMissCount++;
+        break;
+
+      case Record::DATA:
+        if (warmCaches(dcaches, rec.addr))
+            cacheHitCount++;
+        else
+            cacheMissCount++;
+        break;
+
+      case Record::BRANCH:
+        bpred->warm(rec.tid, rec.addr,
+                    static_cast<BPredUnit::BranchClass>(rec.brClass),
+                    rec.taken, rec.target);
+        branchCount++;
+        break;
+    }
+}
+
+bool
+FunctionalWarmer::warmCaches(const std::vector<BaseCache*> &caches,
+                             Addr addr)
+{
+    // walk down the hierarchy until the first hit
+    for (size_t i = 0; i < caches.size(); ++i) {
+        if (caches[i]->warmAccess(addr, false))
+            return i == 0;
+    }
+    return false;
+}
+
+FunctionalWarmer *
+FunctionalWarmerParams::create()
+{
+    return new FunctionalWarmer(this);
+}
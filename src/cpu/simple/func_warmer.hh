@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2015, Nils Asmussen
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#ifndef __CPU_SIMPLE_FUNC_WARMER_HH__
+#define __CPU_SIMPLE_FUNC_WARMER_HH__
+
+#include <atomic>
+#include <list>
+#include <map>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "base/spsc_queue.hh"
+#include "base/statistics.hh"
+#include "cpu/pred/bpred_unit.hh"
+#include "params/FunctionalWarmer.hh"
+#include "sim/eventq.hh"
+#include "sim/sim_object.hh"
+
+class BaseCache;
+class Dtu;
+class System;
+
+/**
+ * Functional warming of caches, the DTU's TLB and a branch predictor while
+ * fast-forwarding with the AtomicSimpleCPU.
+ *
+ * The CPU pushes its instruction fetches, data accesses and branch
+ * outcomes into a lock-free queue. A separate host thread consumes the
+ * queue and updates the tags and replacement state of the caches and the
+ * branch predictor, without any timing and without moving data. When the
+ * CPU is switched out, the data of the newly allocated cache blocks is
+ * fetched from memory and the TLB is filled with the most recently used
+ * pages, so that the detailed CPU starts with warm structures.
+ *
+ * Cache accesses are only recorded while the system bypasses the caches,
+ * because only then the caches are not accessed by the simulation thread.
+ * For the same reason, the warmed caches and branch predictor must not be
+ * used by the fast-forwarding CPU itself, and every cache may only be
+ * warmed by one warmer.
+ */
+class FunctionalWarmer : public SimObject
+{
+  public:
+    FunctionalWarmer(const FunctionalWarmerParams *p);
+    ~FunctionalWarmer();
+
+    void startup() override;
+    void regStats() override;
+    DrainState drain() override;
+
+    /**
+     * Records an instruction fetch.
+     *
+     * @param vaddr the virtual address
+     * @param paddr the address as seen by the caches
+     */
+    void fetch(Addr vaddr, Addr paddr);
+
+    /**
+     * Records a data access.
+     *
+     * @param vaddr the virtual address
+     * @param paddr the address as seen by the caches
+     * @param write whether it is a write
+     */
+    void access(Addr vaddr, Addr paddr, bool write);
+
+    /**
+     * Records the outcome of a branch.
+     *
+     * @param tid the thread id
+     * @param pc the PC of the branch
+     * @param br_class the class of the branch
+     * @param taken whether the branch was taken
+     * @param target the next PC
+     */
+    void branch(ThreadID tid, Addr pc, BPredUnit::BranchClass br_class,
+                bool taken, Addr target);
+
+    /**
+     * Waits until all recorded events have been applied, stops the
+     * warming thread, fills the warmed cache blocks with data and warms
+     * the TLB. Has to be called before the detailed CPU takes over. The
+     * thread is started again with the next record.
+     */
+    void finish();
+
+  private:
+    struct Record
+    {
+        enum Type : uint8_t
+        {
+            IFETCH,
+            DATA,
+            BRANCH,
+        };
+
+        Type type;
+        uint8_t brClass;
+        bool taken;
+        ThreadID tid;
+        Addr addr;
+        Addr target;
+        Tick when;
+    };
+
+    struct Page
+    {
+        Addr virt;
+        uint access;
+    };
+
+    void push(const Record &rec);
+
+    void start();
+
+    void stop();
+
+    void touchPage(Addr vaddr, uint access);
+
+    /**
+     * Waits until the warming thread has applied all records.
+     */
+    void flush();
+
+    /**
+     * The main loop of the warming thread.
+     */
+    void run();
+
+    void process(const Record &rec);
+
+    bool warmCaches(const std::vector<BaseCache*> &caches, Addr addr);
+
+    const std::vector<BaseCache*> icaches;
+    const std::vector<BaseCache*> dcaches;
+    BPredUnit *bpred;
+    Dtu *dtu;
+    System *system;
+    const Addr lineMask;
+
+    SPSCQueue<Record> queue;
+    /** Number of pushed records (producer only) */
+    uint64_t pushed;
+    /** Number of applied records (written by the warming thread) */
+    std::atomic<uint64_t> processed;
+    std::atomic<bool> stopping;
+    std::thread warmer;
+
+    /** The event queue that provides curTick() to the warming thread */
+    EventQueue warmQueue;
+    Tick lastTick;
+
+    Addr lastFetchLine;
+    Addr lastDataLine;
+
+    /** The pages accessed recently, most recently used first */
+    std::list<Page> pages;
+    std::unordered_map<Addr, std::list<Page>::iterator> pageMap;
+    size_t maxPages;
+
+    /** Counters of the warming thread, published by flush() */
+    uint64_t cacheHitCount;
+    uint64_t cacheMissCount;
+    uint64_t branchCount;
+
+    Stats::Scalar fetches;
+    Stats::Scalar accesses;
+    Stats::Scalar branches;
+    Stats::Scalar cacheHits;
+    Stats::Scalar cacheMisses;
+    Stats::Scalar tlbPages;
+    Stats::Scalar queueStalls;
+};
+
+#endif // __CPU_SIMPLE_FUNC_WARMER_HH__
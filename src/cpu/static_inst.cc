@@ -68,6 +68,8 @@ class NopStaticInst : public StaticInst
 
 }
 
+std::mutex StaticInst::disassemblyLock;
+
 StaticInstPtr StaticInst::nullStaticInstPtr;
 StaticInstPtr StaticInst::nopStaticInstPtr = new NopStaticInst;
 
@@ -122,9 +124,21 @@ StaticInst::branchTarget(ThreadContext *tc) const
 const string &
 StaticInst::disassemble(Addr pc, const SymbolTable *symtab) const
 {
-    if (!cachedDisassembly)
-        cachedDisassembly = new string(generateDisassembly(pc, symtab));
+    {
+        std::lock_guard<std::mutex> guard(disassemblyLock);
+        if (cachedDisassembly)
+            return *cachedDisassembly;
+    }
 
+    // generate it without holding the lock; if another thread was faster,
+    // keep its string, because the caller might already use it
+    string *str = new string(generateDisassembly(pc, symtab));
+
+    std::lock_guard<std::mutex> guard(disassemblyLock);
+    if (cachedDisassembly)
+        delete str;
+    else
+        cachedDisassembly = str;
     return *cachedDisassembly;
 }
 
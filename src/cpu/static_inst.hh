@@ -34,6 +34,7 @@
 
 #include <bitset>
 #include <memory>
+#include <mutex>
 #include <string>
 
 #include "arch/registers.hh"
@@ -68,7 +69,7 @@ namespace Trace {
  * solely on these flags can process instructions without being
  * recompiled for multiple ISAs.
  */
-class StaticInst : public RefCounted, public StaticInstFlags
+class StaticInst : public AtomicRefCounted, public StaticInstFlags
 {
   public:
     /// Binary extended machine instruction type.
@@ -230,10 +231,14 @@ class StaticInst : public RefCounted, public StaticInstFlags
 
     /**
      * String representation of disassembly (lazily evaluated via
-     * disassemble()).
+     * disassemble()). Instructions may be shared between CPUs in
+     * different threads (see DecodeCache::SharedInstMap), so it is only
+     * set under disassemblyLock and never changed afterwards.
      */
     mutable std::string *cachedDisassembly;
 
+    static std::mutex disassemblyLock;
+
     /**
      * Internal function to generate disassembly string.
      */
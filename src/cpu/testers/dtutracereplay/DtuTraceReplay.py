@@ -0,0 +1,45 @@
+# Copyright (c) 2016 Nils Asmussen
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#
+# 1. Redistributions of source code must retain the above copyright notice, this
+#    list of conditions and the following disclaimer.
+# 2. Redistributions in binary form must reproduce the above copyright notice,
+#    this list of conditions and the following disclaimer in the documentation
+#    and/or other materials provided with the distribution.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+# ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+# DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+# ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+# (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+# LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+# ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+# SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+# The views and conclusions contained in the software and documentation are those
+# of the authors and should not be interpreted as representing official policies,
+# either expressed or implied, of the FreeBSD Project.
+
+
+from MemObject import MemObject
+from m5.params import *
+from m5.proxy import *
+
+class DtuTraceReplay(MemObject):
+    type = 'DtuTraceReplay'
+    cxx_header = "cpu/testers/dtutracereplay/dtutracereplay.hh"
+    port = MasterPort("Port to the DTU and Scratch-Pad-Memory")
+    system = Param.System(Parent.any, "System this PE is part of")
+    id = Param.Unsigned("Core ID")
+    regfile_base_addr = Param.Addr(0xF0000000, "Register file address")
+
+    trace_file = Param.String("DTU command trace to replay (as recorded "
+                              "with Dtu.cmd_trace)")
+    map_size = Param.MemorySize("16MB", "Size of the address space that is "
+                                "mapped 1:1 for the buffers of the commands "
+                                "(if the PE uses external memory)")
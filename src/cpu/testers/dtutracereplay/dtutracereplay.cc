@@ -0,0 +1,454 @@
+/*
+ * Copyright (c) 2016, Nils Asmussen
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#include "cpu/testers/dtutracereplay/dtutracereplay.hh"
+
+#include "debug/DtuTraceReplay.hh"
+#include "mem/dtu/dtu.hh"
+#include "mem/dtu/regfile.hh"
+#include "sim/dtu_memory.hh"
+#include "sim/sim_exit.hh"
+#include "sim/stats.hh"
+
+static const unsigned NUM_OPCODES   = Dtu::Command::PRINT + 1;
+
+static const char *opNames[] =
+{
+    "idle",
+    "send",
+    "reply",
+    "read",
+    "write",
+    "fetch",
+    "ack",
+    "sleep",
+    "print",
+};
+
+unsigned DtuTraceReplay::activeReplays = 0;
+
+Addr
+DtuTraceReplay::getRegAddr(CmdReg reg)
+{
+    Addr result = sizeof(RegFile::reg_t) * numDtuRegs;
+
+    result += static_cast<Addr>(reg) * sizeof(RegFile::reg_t);
+
+    return result;
+}
+
+Addr
+DtuTraceReplay::getRegAddr(unsigned reg, unsigned epid)
+{
+    Addr result = sizeof(RegFile::reg_t) * (numDtuRegs + numCmdRegs);
+
+    result += epid * numEpRegs * sizeof(RegFile::reg_t);
+
+    result += reg * sizeof(RegFile::reg_t);
+
+    return result;
+}
+
+bool
+DtuTraceReplay::CpuPort::recvTimingResp(PacketPtr pkt)
+{
+    replay.completeRequest(pkt);
+    return true;
+}
+
+void
+DtuTraceReplay::CpuPort::recvReqRetry()
+{
+    replay.recvRetry();
+}
+
+DtuTraceReplay::DtuTraceReplay(const DtuTraceReplayParams *p)
+  : MemObject(p),
+    tickEvent(this),
+    port("port", this),
+    state(State::INIT),
+    next(State::NEXT),
+    system(p->system),
+    reg_base(p->regfile_base_addr),
+    masterId(p->system->getMasterId(this, name())),
+    id(p->id),
+    atomic(p->system->isAtomicMode()),
+    retryPkt(nullptr),
+    trace(p->trace_file),
+    mapSize(p->map_size),
+    rec(),
+    lastEnd(0),
+    issued(0),
+    fetchStart(0),
+    fetched()
+{
+    activeReplays++;
+
+    // kick things into action
+    schedule(tickEvent, curTick());
+}
+
+BaseMasterPort &
+DtuTraceReplay::getMasterPort(const std::string& if_name, PortID idx)
+{
+    if (if_name == "port")
+        return port;
+    else
+        return MemObject::getMasterPort(if_name, idx);
+}
+
+void
+DtuTraceReplay::regStats()
+{
+    MemObject::regStats();
+
+    replayed
+        .init(NUM_OPCODES)
+        .name(name() + ".replayed")
+        .desc("Number of replayed commands")
+        .flags(Stats::nozero);
+    errors
+        .init(NUM_OPCODES)
+        .name(name() + ".errors")
+        .desc("Number of replayed commands that failed")
+        .flags(Stats::nozero);
+    for (unsigned i = 0; i < NUM_OPCODES; ++i)
+    {
+        replayed.subname(i, opNames[i]);
+        errors.subname(i, opNames[i]);
+    }
+    epConfigs
+        .name(name() + ".epConfigs")
+        .desc("Number of endpoint configurations");
+    gapCycles
+        .name(name() + ".gapCycles")
+        .desc("Number of recorded compute cycles between commands");
+    msgWaitCycles
+        .name(name() + ".msgWaitCycles")
+        .desc("Number of cycles spent waiting for messages");
+    cmdLatency
+        .init(16)
+        .name(name() + ".cmdLatency")
+        .desc("Time from issuing a command to its completion (in cycles)")
+        .flags(Stats::nozero);
+}
+
+bool
+DtuTraceReplay::sendPkt(PacketPtr pkt)
+{
+    if (atomic)
+    {
+        port.sendAtomic(pkt);
+        completeRequest(pkt);
+    }
+    else if (!port.sendTimingReq(pkt))
+    {
+        retryPkt = pkt;
+        return false;
+    }
+
+    return true;
+}
+
+void
+DtuTraceReplay::recvRetry()
+{
+    assert(retryPkt);
+    if (port.sendTimingReq(retryPkt))
+        retryPkt = nullptr;
+}
+
+PacketPtr
+DtuTraceReplay::createPacket(Addr paddr,
+                             size_t size,
+                             MemCmd cmd = MemCmd::WriteReq)
+{
+    Request::Flags flags;
+
+    auto req = std::make_shared<Request>(paddr, size, flags, masterId);
+    req->setContext(id);
+
+    auto pkt = new Packet(req, cmd);
+    auto pkt_data = new uint8_t[size];
+    pkt->dataDynamic(pkt_data);
+
+    return pkt;
+}
+
+PacketPtr
+DtuTraceReplay::createCommandPkt(unsigned opcode,
+                                 unsigned ep,
+                                 unsigned flags,
+                                 uint64_t arg,
+                                 const DataReg &data,
+                                 RegFile::reg_t offset,
+                                 RegFile::reg_t label)
+{
+    static_assert(static_cast<int>(CmdReg::COMMAND) == 0, "");
+    static_assert(static_cast<int>(CmdReg::ABORT) == 1, "");
+    static_assert(static_cast<int>(CmdReg::DATA) == 2, "");
+    static_assert(static_cast<int>(CmdReg::OFFSET) == 3, "");
+    static_assert(static_cast<int>(CmdReg::REPLY_LABEL) == 4, "");
+
+    auto pkt = createPacket(reg_base + getRegAddr(CmdReg::COMMAND),
+                            sizeof(RegFile::reg_t) * numCmdRegs,
+                            MemCmd::WriteReq);
+
+    Dtu::Command::Bits cmdreg = 0;
+    cmdreg.opcode = opcode;
+    cmdreg.epid = ep;
+    cmdreg.flags = flags;
+    cmdreg.arg = arg;
+
+    RegFile::reg_t *regs = pkt->getPtr<RegFile::reg_t>();
+    regs[0] = cmdreg;
+    regs[1] = 0;
+    regs[2] = data.value();
+    regs[3] = offset;
+    regs[4] = label;
+    return pkt;
+}
+
+void
+DtuTraceReplay::nextRecord()
+{
+    if (!trace.next(rec))
+    {
+        state = State::DONE;
+        DPRINTF(DtuTraceReplay, "Replayed all commands\n");
+
+        if (--activeReplays == 0)
+            exitSimLoop("DTU trace replay finished");
+        return;
+    }
+
+    if (rec.type == CmdTraceRecord::EP)
+    {
+        state = State::SETUP_EP;
+        schedule(tickEvent, clockEdge(Cycles(0)));
+        return;
+    }
+
+    fatal_if(rec.opcode != Dtu::Command::SEND &&
+             rec.opcode != Dtu::Command::REPLY &&
+             rec.opcode != Dtu::Command::READ &&
+             rec.opcode != Dtu::Command::WRITE &&
+             rec.opcode != Dtu::Command::FETCH_MSG &&
+             rec.opcode != Dtu::Command::ACK_MSG,
+             "Unsupported opcode %u in command %llu", rec.opcode, rec.seq);
+
+    // the gap is relative to the end of the previous command
+    Cycles start = lastEnd + rec.gap;
+    Cycles now = curCycle();
+    gapCycles += rec.gap;
+    fetchStart = std::max(start, now);
+
+    state = State::ISSUE;
+    schedule(tickEvent, clockEdge(start > now ? Cycles(start - now)
+                                              : Cycles(0)));
+}
+
+void
+DtuTraceReplay::commandDone(unsigned error)
+{
+    if (error != 0)
+    {
+        DPRINTF(DtuTraceReplay, "Command %llu (%s) failed with error %u\n",
+                rec.seq, opNames[rec.opcode], error);
+        errors[rec.opcode]++;
+    }
+
+    replayed[rec.opcode]++;
+    cmdLatency.sample(curCycle() - issued);
+    lastEnd = curCycle();
+}
+
+void
+DtuTraceReplay::completeRequest(PacketPtr pkt)
+{
+    if (pkt->isError())
+    {
+        warn("%s access failed at %#x\n",
+             pkt->isWrite() ? "Write" : "Read", pkt->getAddr());
+    }
+
+    switch (state)
+    {
+        case State::SETUP_EP:
+            epConfigs++;
+            state = State::NEXT;
+            break;
+
+        case State::ISSUE:
+        case State::SLEEP:
+            next = state;
+            state = State::WAIT;
+            break;
+
+        case State::WAIT:
+        {
+            Dtu::Command::Bits cmd = *pkt->getConstPtr<RegFile::reg_t>();
+            if (cmd.opcode != Dtu::Command::IDLE)
+                break;
+
+            // try to fetch the message again after sleeping
+            if (next == State::SLEEP)
+                state = State::ISSUE;
+            else if (rec.opcode == Dtu::Command::FETCH_MSG &&
+                     cmd.error == 0)
+                state = State::FETCH_OFFSET;
+            else
+            {
+                commandDone(cmd.error);
+                state = State::NEXT;
+            }
+            break;
+        }
+
+        case State::FETCH_OFFSET:
+        {
+            Addr msg = *pkt->getConstPtr<RegFile::reg_t>();
+            if (msg == 0)
+            {
+                DPRINTF(DtuTraceReplay,
+                        "Waiting for message of command %llu on EP%u\n",
+                        rec.seq, rec.ep);
+                state = State::SLEEP;
+            }
+            else
+            {
+                fetched[rec.seq] = msg;
+                msgWaitCycles += curCycle() - fetchStart;
+                commandDone(0);
+                state = State::NEXT;
+            }
+            break;
+        }
+
+        case State::INIT:
+        case State::NEXT:
+        case State::DONE:
+            panic("Unexpected response in state %d\n",
+                  static_cast<int>(state));
+    }
+
+    // the packet will delete the data
+    delete pkt;
+
+    // kick things into action again
+    schedule(tickEvent, clockEdge(Cycles(1)));
+}
+
+void
+DtuTraceReplay::tick()
+{
+    PacketPtr pkt = nullptr;
+
+    switch (state)
+    {
+        case State::INIT:
+        {
+            DTUMemory *sys = dynamic_cast<DTUMemory*>(system);
+            if (sys && sys->hasMem(id))
+                sys->mapSegment(0, mapSize, DtuTlb::IRWX);
+
+            nextRecord();
+            return;
+        }
+
+        case State::NEXT:
+            nextRecord();
+            return;
+
+        case State::SETUP_EP:
+        {
+            pkt = createPacket(reg_base + getRegAddr(0, rec.ep),
+                               sizeof(RegFile::reg_t) * numEpRegs,
+                               MemCmd::WriteReq);
+            RegFile::reg_t *regs = pkt->getPtr<RegFile::reg_t>();
+            for (unsigned i = 0; i < numEpRegs; ++i)
+                regs[i] = rec.regs[i];
+            break;
+        }
+
+        case State::ISSUE:
+        {
+            uint64_t arg = rec.arg;
+            // refer to the message we fetched during the replay
+            if ((rec.opcode == Dtu::Command::REPLY ||
+                 rec.opcode == Dtu::Command::ACK_MSG) && rec.dep >= 0)
+            {
+                auto it = fetched.find(rec.dep);
+                if (it != fetched.end())
+                {
+                    arg = it->second;
+                    fetched.erase(it);
+                }
+                else
+                    warn("Command %llu depends on unknown fetch %lld\n",
+                         rec.seq, rec.dep);
+            }
+
+            DPRINTF(DtuTraceReplay, "Issuing command %llu (%s) on EP%u\n",
+                    rec.seq, opNames[rec.opcode], rec.ep);
+
+            issued = curCycle();
+            pkt = createCommandPkt(rec.opcode, rec.ep, rec.flags, arg,
+                                   rec.data, rec.offset, rec.label);
+            break;
+        }
+
+        case State::WAIT:
+            pkt = createPacket(reg_base + getRegAddr(CmdReg::COMMAND),
+                               sizeof(RegFile::reg_t), MemCmd::ReadReq);
+            break;
+
+        case State::FETCH_OFFSET:
+            pkt = createPacket(reg_base + getRegAddr(CmdReg::OFFSET),
+                               sizeof(RegFile::reg_t), MemCmd::ReadReq);
+            break;
+
+        case State::SLEEP:
+            // the DTU wakes us up as soon as a message arrives
+            pkt = createCommandPkt(Dtu::Command::SLEEP, 0, 0, 0,
+                                   DataReg(), 0, 0);
+            break;
+
+        case State::DONE:
+            return;
+    }
+
+    sendPkt(pkt);
+}
+
+DtuTraceReplay*
+DtuTraceReplayParams::create()
+{
+    return new DtuTraceReplay(this);
+}
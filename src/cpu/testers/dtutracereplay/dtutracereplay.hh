@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2016, Nils Asmussen
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#ifndef __CPU_DTUTRACEREPLAY_DTUTRACEREPLAY_HH__
+#define __CPU_DTUTRACEREPLAY_DTUTRACEREPLAY_HH__
+
+#include <unordered_map>
+
+#include "params/DtuTraceReplay.hh"
+#include "mem/dtu/cmd_trace.hh"
+#include "mem/dtu/dtu.hh"
+#include "mem/dtu/regfile.hh"
+#include "sim/system.hh"
+
+/**
+ * A PE that replays a DTU command trace (see CmdTraceRecorder) through
+ * the real DTU instead of running software on a core. Each command is
+ * issued the recorded number of cycles after the previous one finished.
+ * Fetches of messages wait until the message has arrived, so that the
+ * replay adapts to the timing of the NoC and of the other PEs. REPLY and
+ * ACK_MSG refer to the message returned by the corresponding fetch.
+ * Endpoints are configured as recorded, which requires the DTU to be
+ * privileged, i.e., M3 must not be running.
+ */
+class DtuTraceReplay : public MemObject
+{
+  public:
+    DtuTraceReplay(const DtuTraceReplayParams *p);
+
+    BaseMasterPort& getMasterPort(const std::string &if_name,
+                                  PortID idx = InvalidPortID) override;
+
+    void regStats() override;
+
+  protected:
+
+    /// main simulation loop
+    void tick();
+
+    EventWrapper<DtuTraceReplay, &DtuTraceReplay::tick> tickEvent;
+
+    class CpuPort : public MasterPort
+    {
+      private:
+        DtuTraceReplay& replay;
+      public:
+        CpuPort(const std::string& _name, DtuTraceReplay* _replay)
+            : MasterPort(_name, _replay), replay(*_replay)
+        { }
+      protected:
+        bool recvTimingResp(PacketPtr pkt) override;
+
+        void recvReqRetry() override;
+    };
+
+    CpuPort port;
+
+    enum class State
+    {
+        INIT,
+        NEXT,
+        SETUP_EP,
+        ISSUE,
+        WAIT,
+        FETCH_OFFSET,
+        SLEEP,
+        DONE,
+    };
+
+    State state;
+
+    /// The state to continue with after the DTU command finished
+    State next;
+
+    System *system;
+
+    Addr reg_base;
+
+    /// Request id for all generated traffic
+    MasterID masterId;
+
+    unsigned int id;
+
+    const bool atomic;
+
+    /// Stores the Packet for later retry
+    PacketPtr retryPkt;
+
+    CmdTraceReader trace;
+
+    const Addr mapSize;
+
+    /// The record that is currently replayed
+    CmdTraceRecord rec;
+
+    /// The cycle the last command finished
+    Cycles lastEnd;
+
+    /// The cycle the current command has been issued
+    Cycles issued;
+
+    /// The cycle of the first attempt to fetch the current message
+    Cycles fetchStart;
+
+    /// The messages fetched by the FETCH_MSG commands, by sequence number
+    std::unordered_map<uint64_t, Addr> fetched;
+
+    /// Number of replay PEs that are not finished yet
+    static unsigned activeReplays;
+
+    PacketPtr createPacket(Addr paddr, size_t size, MemCmd cmd);
+
+    PacketPtr createCommandPkt(unsigned opcode, unsigned ep, unsigned flags,
+                               uint64_t arg, const DataReg &data,
+                               RegFile::reg_t offset, RegFile::reg_t label);
+
+    bool sendPkt(PacketPtr pkt);
+
+    void completeRequest(PacketPtr pkt);
+
+    void recvRetry();
+
+    /// Reads the next record and finishes the replay at the end
+    void nextRecord();
+
+    /// Records the completion of the current command
+    void commandDone(unsigned error);
+
+    static Addr getRegAddr(CmdReg reg);
+
+    static Addr getRegAddr(unsigned reg, unsigned epid);
+
+    Stats::Vector replayed;
+    Stats::Vector errors;
+    Stats::Scalar epConfigs;
+    Stats::Scalar gapCycles;
+    Stats::Scalar msgWaitCycles;
+    Stats::Histogram cmdLatency;
+};
+
+#endif // __CPU_DTUTRACEREPLAY_DTUTRACEREPLAY_HH__
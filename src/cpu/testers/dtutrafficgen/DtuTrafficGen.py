@@ -0,0 +1,65 @@
+# Copyright (c) 2016 Nils Asmussen
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#
+# 1. Redistributions of source code must retain the above copyright notice, this
+#    list of conditions and the following disclaimer.
+# 2. Redistributions in binary form must reproduce the above copyright notice,
+#    this list of conditions and the following disclaimer in the documentation
+#    and/or other materials provided with the distribution.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+# ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+# DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+# ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+# (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+# LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+# ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+# SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+# The views and conclusions contained in the software and documentation are those
+# of the authors and should not be interpreted as representing official policies,
+# either expressed or implied, of the FreeBSD Project.
+
+
+from MemObject import MemObject
+from m5.params import *
+from m5.proxy import *
+
+class DtuTrafficPattern(Enum):
+    vals = ['uniform', 'hotspot', 'all_to_one', 'permutation']
+
+class DtuTrafficGen(MemObject):
+    type = 'DtuTrafficGen'
+    cxx_header = "cpu/testers/dtutrafficgen/dtutrafficgen.hh"
+    port = MasterPort("Port to the DTU and Scratch-Pad-Memory")
+    system = Param.System(Parent.any, "System this generator is part of")
+    id = Param.Unsigned("Core ID")
+    regfile_base_addr = Param.Addr(0xF0000000, "Register file address")
+
+    targets = VectorParam.Unsigned("Core IDs of all traffic generators")
+    pattern = Param.DtuTrafficPattern('uniform', "Destination pattern")
+    hotspot = Param.Unsigned(0, "Core ID of the hotspot (also used as the "
+                             "destination for all_to_one)")
+    hotspot_ratio = Param.Float(0.5, "Fraction of the commands that are sent "
+                                "to the hotspot")
+
+    send_weight = Param.Unsigned(1, "Relative frequency of SEND commands")
+    read_weight = Param.Unsigned(0, "Relative frequency of READ commands")
+    write_weight = Param.Unsigned(0, "Relative frequency of WRITE commands")
+    reply = Param.Bool(True, "Whether received messages are replied to")
+
+    size = Param.MemorySize("64B", "Payload size of messages and transfers")
+    recv_slots = Param.Unsigned(8, "Number of slots in the receive buffers")
+    injection_rate = Param.Float(0.01, "Average number of commands injected "
+                                 "per cycle (Poisson process)")
+    max_pending = Param.Unsigned(16, "Maximum number of injected commands "
+                                 "that wait to be issued")
+    max_commands = Param.Counter(0, "Number of commands after which the "
+                                 "generator stops (0 = unlimited)")
+    seed = Param.Unsigned(1, "Seed for the permutation (equal for all "
+                          "generators)")
@@ -0,0 +1,763 @@
+/*
+ * Copyright (c) 2016, Nils Asmussen
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#include "cpu/testers/dtutrafficgen/dtutrafficgen.hh"
+
+#include <algorithm>
+#include <cmath>
+
+#include "base/intmath.hh"
+#include "base/random.hh"
+#include "debug/DtuTrafficGen.hh"
+#include "mem/dtu/dtu.hh"
+#include "mem/dtu/regfile.hh"
+#include "sim/dtu_memory.hh"
+#include "sim/sim_exit.hh"
+#include "sim/stats.hh"
+
+// start at 0x4000, because it is 1:1 mapped and we use the first 4 for PTs
+static const Addr DATA_ADDR         = DtuTlb::PAGE_SIZE * 4;
+static const Addr REMOTE_ADDR       = DtuTlb::PAGE_SIZE * 5;
+static const Addr RECV_ADDR         = DtuTlb::PAGE_SIZE * 6;
+static const unsigned EP_SEND       = 0;
+static const unsigned EP_MEM        = 1;
+static const unsigned EP_RECV       = 2;
+static const unsigned EP_REPLY      = 3;
+
+static const char *stateNames[] =
+{
+    "INIT_EPS",
+    "POLL",
+    "FETCH",
+    "FETCH_OFFSET",
+    "READ_STAMP",
+    "RESPOND",
+    "SETUP_EP",
+    "WRITE_STAMP",
+    "ISSUE",
+    "WAIT",
+};
+
+static const char *opNames[] =
+{
+    "send",
+    "read",
+    "write",
+};
+
+unsigned DtuTrafficGen::activeGens = 0;
+
+Addr
+DtuTrafficGen::getRegAddr(DtuReg reg)
+{
+    return static_cast<Addr>(reg) * sizeof(RegFile::reg_t);
+}
+
+Addr
+DtuTrafficGen::getRegAddr(CmdReg reg)
+{
+    Addr result = sizeof(RegFile::reg_t) * numDtuRegs;
+
+    result += static_cast<Addr>(reg) * sizeof(RegFile::reg_t);
+
+    return result;
+}
+
+Addr
+DtuTrafficGen::getRegAddr(unsigned reg, unsigned epid)
+{
+    Addr result = sizeof(RegFile::reg_t) * (numDtuRegs + numCmdRegs);
+
+    result += epid * numEpRegs * sizeof(RegFile::reg_t);
+
+    result += reg * sizeof(RegFile::reg_t);
+
+    return result;
+}
+
+bool
+DtuTrafficGen::CpuPort::recvTimingResp(PacketPtr pkt)
+{
+    gen.completeRequest(pkt);
+    return true;
+}
+
+void
+DtuTrafficGen::CpuPort::recvReqRetry()
+{
+    gen.recvRetry();
+}
+
+DtuTrafficGen::DtuTrafficGen(const DtuTrafficGenParams *p)
+  : MemObject(p),
+    tickEvent(this),
+    port("port", this),
+    state(State::INIT_EPS),
+    next(State::POLL),
+    system(p->system),
+    reg_base(p->regfile_base_addr),
+    masterId(p->system->getMasterId(this, name())),
+    id(p->id),
+    atomic(p->system->isAtomicMode()),
+    retryPkt(nullptr),
+    targets(p->targets),
+    permTarget(p->id),
+    pattern(p->pattern),
+    hotspot(p->hotspot),
+    hotspotRatio(p->hotspot_ratio),
+    weights{p->send_weight, p->read_weight, p->write_weight},
+    totalWeight(p->send_weight + p->read_weight + p->write_weight),
+    reply(p->reply),
+    size(p->size),
+    recvSlots(p->recv_slots),
+    slotSize(roundUp(sizeof(MessageHeader) + p->size, 64)),
+    injectionRate(p->injection_rate),
+    maxPending(p->max_pending),
+    maxCommands(p->max_commands),
+    curCmd(),
+    nextInjection(0),
+    injectedCmds(0),
+    issuedCmds(0),
+    outstanding(0),
+    sendEpTarget(-1),
+    memEpTarget(-1),
+    curEp(EP_RECV),
+    curMsg(0),
+    finished(false)
+{
+    fatal_if(std::find(targets.begin(), targets.end(), id) == targets.end(),
+             "The targets have to include the generator itself");
+    fatal_if(targets.size() < 2 && pattern != Enums::all_to_one,
+             "At least two generators are required");
+    fatal_if(size < sizeof(Tick) || size > DtuTlb::PAGE_SIZE,
+             "The size has to be between %u and %u bytes",
+             sizeof(Tick), DtuTlb::PAGE_SIZE);
+    fatal_if(recvSlots == 0 || recvSlots > RecvEp::MAX_MSGS,
+             "The number of receive slots has to be between 1 and %u",
+             RecvEp::MAX_MSGS);
+    fatal_if(injectionRate <= 0 || injectionRate > 1,
+             "The injection rate has to be in (0, 1]");
+    fatal_if(totalWeight == 0, "At least one operation needs a weight");
+    fatal_if(hotspotRatio < 0 || hotspotRatio > 1,
+             "The hotspot ratio has to be in [0, 1]");
+
+    if (pattern == Enums::permutation)
+    {
+        // all generators build the same permutation, which forms a single
+        // cycle (Sattolo's algorithm) and thus has no fixed points
+        std::vector<unsigned> perm(targets);
+        Random rnd(p->seed);
+        for (size_t i = perm.size() - 1; i > 0; --i)
+            std::swap(perm[i], perm[rnd.random<size_t>(0, i - 1)]);
+
+        for (size_t i = 0; i < perm.size(); ++i)
+        {
+            if (perm[i] == id)
+                permTarget = perm[(i + 1) % perm.size()];
+        }
+    }
+
+    // the hotspot does not talk to itself in the all-to-one pattern
+    if (pattern == Enums::all_to_one && id == hotspot)
+        finished = true;
+    else if (maxCommands > 0)
+        activeGens++;
+
+    // kick things into action
+    schedule(tickEvent, curTick());
+}
+
+BaseMasterPort &
+DtuTrafficGen::getMasterPort(const std::string& if_name, PortID idx)
+{
+    if (if_name == "port")
+        return port;
+    else
+        return MemObject::getMasterPort(if_name, idx);
+}
+
+void
+DtuTrafficGen::regStats()
+{
+    MemObject::regStats();
+
+    injected
+        .name(name() + ".injected")
+        .desc("Number of injected commands");
+    throttled
+        .name(name() + ".throttled")
+        .desc("Number of commands that were not injected due to a full queue");
+    issued
+        .init(OP_COUNT)
+        .name(name() + ".issued")
+        .desc("Number of issued commands")
+        .flags(Stats::nozero);
+    errors
+        .init(OP_COUNT)
+        .name(name() + ".errors")
+        .desc("Number of commands that failed")
+        .flags(Stats::nozero);
+    for (int i = 0; i < OP_COUNT; ++i)
+    {
+        issued.subname(i, opNames[i]);
+        errors.subname(i, opNames[i]);
+    }
+    receivedMsgs
+        .name(name() + ".receivedMsgs")
+        .desc("Number of received messages");
+    deliveredBytes
+        .name(name() + ".deliveredBytes")
+        .desc("Payload bytes of received messages and completed transfers");
+    queueLatency
+        .init(16)
+        .name(name() + ".queueLatency")
+        .desc("Time from injection to issue (in ticks)")
+        .flags(Stats::nozero);
+    msgLatency
+        .init(16)
+        .name(name() + ".msgLatency")
+        .desc("Time from injection to the receipt of messages (in ticks)")
+        .flags(Stats::nozero);
+    roundTripLatency
+        .init(16)
+        .name(name() + ".roundTripLatency")
+        .desc("Time from injection to the receipt of the reply (in ticks)")
+        .flags(Stats::nozero);
+    readLatency
+        .init(16)
+        .name(name() + ".readLatency")
+        .desc("Time from injection to the completion of reads (in ticks)")
+        .flags(Stats::nozero);
+    writeLatency
+        .init(16)
+        .name(name() + ".writeLatency")
+        .desc("Time from injection to the completion of writes (in ticks)")
+        .flags(Stats::nozero);
+    offeredLoad
+        .name(name() + ".offeredLoad")
+        .desc("Offered load (bytes/s)")
+        .precision(0);
+    offeredLoad = injected * size / simSeconds;
+    acceptedThroughput
+        .name(name() + ".acceptedThroughput")
+        .desc("Accepted throughput (bytes/s)")
+        .precision(0);
+    acceptedThroughput = deliveredBytes / simSeconds;
+}
+
+bool
+DtuTrafficGen::sendPkt(PacketPtr pkt)
+{
+    if (atomic)
+    {
+        port.sendAtomic(pkt);
+        completeRequest(pkt);
+    }
+    else if (!port.sendTimingReq(pkt))
+    {
+        retryPkt = pkt;
+        return false;
+    }
+
+    return true;
+}
+
+void
+DtuTrafficGen::recvRetry()
+{
+    assert(retryPkt);
+    if (port.sendTimingReq(retryPkt))
+        retryPkt = nullptr;
+}
+
+PacketPtr
+DtuTrafficGen::createPacket(Addr paddr,
+                            size_t size,
+                            MemCmd cmd = MemCmd::WriteReq)
+{
+    Request::Flags flags;
+
+    auto req = std::make_shared<Request>(paddr, size, flags, masterId);
+    req->setContext(id);
+
+    auto pkt = new Packet(req, cmd);
+    auto pkt_data = new uint8_t[size];
+    pkt->dataDynamic(pkt_data);
+
+    return pkt;
+}
+
+PacketPtr
+DtuTrafficGen::createDtuRegisterPkt(Addr reg,
+                                    RegFile::reg_t value,
+                                    MemCmd cmd = MemCmd::WriteReq)
+{
+    auto pkt = createPacket(reg_base + reg, sizeof(RegFile::reg_t), cmd);
+    *pkt->getPtr<RegFile::reg_t>() = value;
+    return pkt;
+}
+
+PacketPtr
+DtuTrafficGen::createCommandPkt(Dtu::Command::Opcode cmd,
+                                unsigned ep,
+                                Addr data,
+                                Addr size,
+                                Addr arg,
+                                Addr off)
+{
+    static_assert(static_cast<int>(CmdReg::COMMAND) == 0, "");
+    static_assert(static_cast<int>(CmdReg::ABORT) == 1, "");
+    static_assert(static_cast<int>(CmdReg::DATA) == 2, "");
+    static_assert(static_cast<int>(CmdReg::OFFSET) == 3, "");
+
+    auto pkt = createPacket(reg_base + getRegAddr(CmdReg::COMMAND),
+                            sizeof(RegFile::reg_t) * 4,
+                            MemCmd::WriteReq);
+
+    Dtu::Command::Bits cmdreg = 0;
+    cmdreg.opcode = static_cast<RegFile::reg_t>(cmd);
+    cmdreg.epid = ep;
+    cmdreg.arg = arg;
+
+    RegFile::reg_t *regs = pkt->getPtr<RegFile::reg_t>();
+    regs[0] = cmdreg;
+    regs[1] = 0;
+    regs[2] = DataReg(data, size).value();
+    regs[3] = off;
+    return pkt;
+}
+
+PacketPtr
+DtuTrafficGen::createEpPkt(unsigned ep)
+{
+    auto pkt = createPacket(reg_base + getRegAddr(0, ep),
+                            sizeof(RegFile::reg_t) * numEpRegs,
+                            MemCmd::WriteReq);
+
+    RegFile::reg_t *regs = pkt->getPtr<RegFile::reg_t>();
+    RegFile::reg_t target = curCmd.target;
+    if (ep == EP_SEND)
+    {
+        // we use unlimited credits; if the receiver has no free slot, the
+        // command fails with NO_RING_SPACE
+        regs[0] = (static_cast<RegFile::reg_t>(EpType::SEND) << 61) |
+                  (static_cast<RegFile::reg_t>(Dtu::INVALID_VPE_ID) << 16) |
+                  (slotSize << 0);                                  // max msg size
+        regs[1] = (target << 40) |                                  // target core
+                  (static_cast<RegFile::reg_t>(EP_RECV) << 32) |    // target EP
+                  (static_cast<RegFile::reg_t>(Dtu::CREDITS_UNLIM) << 16) |
+                  (Dtu::CREDITS_UNLIM << 0);
+        regs[2] = 0;                                                // label
+        sendEpTarget = target;
+    }
+    else
+    {
+        assert(ep == EP_MEM);
+        regs[0] = (static_cast<RegFile::reg_t>(EpType::MEMORY) << 61) |
+                  DtuTlb::PAGE_SIZE;                                // size
+        regs[1] = REMOTE_ADDR;                                      // address
+        regs[2] = (Dtu::INVALID_VPE_ID << 12) |                     // vpe id
+                  (target << 4) |                                   // core id
+                  (Dtu::READ | Dtu::WRITE);                         // access
+        memEpTarget = target;
+    }
+    return pkt;
+}
+
+unsigned
+DtuTrafficGen::chooseTarget()
+{
+    switch (pattern)
+    {
+        case Enums::all_to_one:
+            return hotspot;
+
+        case Enums::permutation:
+            return permTarget;
+
+        case Enums::hotspot:
+            if (id != hotspot &&
+                random_mt.random<double>() < hotspotRatio)
+                return hotspot;
+            M5_FALLTHROUGH;
+
+        default:
+        case Enums::uniform:
+        {
+            // choose uniformly among all others
+            size_t idx = random_mt.random<size_t>(0, targets.size() - 2);
+            if (targets[idx] == id)
+                idx = targets.size() - 1;
+            return targets[idx];
+        }
+    }
+}
+
+void
+DtuTrafficGen::inject()
+{
+    while (!finished && curCycle() >= nextInjection)
+    {
+        if (maxCommands > 0 && injectedCmds == maxCommands)
+            break;
+
+        if (pending.size() < maxPending)
+        {
+            Command cmd;
+            unsigned w = random_mt.random<unsigned>(0, totalWeight - 1);
+            cmd.op = OP_SEND;
+            while (w >= weights[cmd.op])
+            {
+                w -= weights[cmd.op];
+                cmd.op = static_cast<Op>(cmd.op + 1);
+            }
+            cmd.target = chooseTarget();
+            cmd.injected = cyclesToTicks(nextInjection);
+            pending.push_back(cmd);
+            injectedCmds++;
+            injected++;
+        }
+        else
+            throttled++;
+
+        // inter-arrival times of a Bernoulli process with the given rate
+        Cycles interval(1);
+        if (injectionRate < 1)
+        {
+            double u = 1.0 - random_mt.random<double>();
+            interval = Cycles(std::max(1.0, std::ceil(
+                std::log(u) / std::log(1.0 - injectionRate))));
+        }
+        nextInjection = nextInjection + interval;
+    }
+}
+
+void
+DtuTrafficGen::checkFinished()
+{
+    if (finished || maxCommands == 0 || issuedCmds < maxCommands ||
+        outstanding > 0)
+        return;
+
+    finished = true;
+    DPRINTF(DtuTrafficGen, "Finished all %llu commands\n", issuedCmds);
+
+    // keep going to serve the messages of the others
+    if (--activeGens == 0)
+        exitSimLoop("DTU traffic generation finished");
+}
+
+void
+DtuTrafficGen::commandDone(unsigned error)
+{
+    if (error != 0)
+    {
+        DPRINTF(DtuTrafficGen, "%s to %u failed with error %u\n",
+                opNames[curCmd.op], curCmd.target, error);
+        errors[curCmd.op]++;
+        // the reply will never come
+        if (curCmd.op == OP_SEND && reply)
+            outstanding--;
+    }
+    else if (curCmd.op == OP_READ)
+    {
+        readLatency.sample(curTick() - curCmd.injected);
+        deliveredBytes += size;
+    }
+    else if (curCmd.op == OP_WRITE)
+    {
+        writeLatency.sample(curTick() - curCmd.injected);
+        deliveredBytes += size;
+    }
+
+    checkFinished();
+}
+
+void
+DtuTrafficGen::completeRequest(PacketPtr pkt)
+{
+    DPRINTF(DtuTrafficGen, "[%s] Got response for %s @ %#x\n",
+            stateNames[static_cast<size_t>(state)],
+            pkt->isWrite() ? "write" : "read", pkt->getAddr());
+
+    if (pkt->isError())
+    {
+        warn("%s access failed at %#x\n",
+             pkt->isWrite() ? "Write" : "Read", pkt->getAddr());
+    }
+
+    switch (state)
+    {
+        case State::INIT_EPS:
+            state = State::POLL;
+            break;
+
+        case State::POLL:
+        {
+            // we read EP_RECV and the first register of EP_REPLY
+            const RegFile::reg_t *regs = pkt->getConstPtr<RegFile::reg_t>();
+            unsigned recvCount = regs[0] & 0x3F;
+            unsigned replyCount = regs[numEpRegs] & 0x3F;
+
+            // handle received messages first to free the slots
+            if (replyCount > 0 || recvCount > 0)
+            {
+                curEp = replyCount > 0 ? EP_REPLY : EP_RECV;
+                state = State::FETCH;
+            }
+            else if (!pending.empty())
+            {
+                curCmd = pending.front();
+                pending.pop_front();
+                queueLatency.sample(curTick() - curCmd.injected);
+
+                int epTarget = curCmd.op == OP_SEND ? sendEpTarget
+                                                    : memEpTarget;
+                if (epTarget != static_cast<int>(curCmd.target))
+                    state = State::SETUP_EP;
+                else if (curCmd.op == OP_READ)
+                    state = State::ISSUE;
+                else
+                    state = State::WRITE_STAMP;
+            }
+            break;
+        }
+
+        case State::FETCH:
+            state = State::WAIT;
+            next = State::FETCH_OFFSET;
+            break;
+
+        case State::FETCH_OFFSET:
+            curMsg = *pkt->getConstPtr<RegFile::reg_t>();
+            state = curMsg ? State::READ_STAMP : State::POLL;
+            break;
+
+        case State::READ_STAMP:
+        {
+            Tick stamp = *pkt->getConstPtr<Tick>();
+            if (curEp == EP_REPLY)
+            {
+                roundTripLatency.sample(curTick() - stamp);
+                outstanding--;
+            }
+            else
+            {
+                msgLatency.sample(curTick() - stamp);
+                receivedMsgs++;
+                deliveredBytes += size;
+            }
+            state = State::RESPOND;
+            break;
+        }
+
+        case State::RESPOND:
+            state = State::WAIT;
+            next = State::POLL;
+            break;
+
+        case State::SETUP_EP:
+            state = curCmd.op == OP_READ ? State::ISSUE : State::WRITE_STAMP;
+            break;
+
+        case State::WRITE_STAMP:
+            state = State::ISSUE;
+            break;
+
+        case State::ISSUE:
+            issuedCmds++;
+            issued[curCmd.op]++;
+            if (curCmd.op == OP_SEND && reply)
+                outstanding++;
+            state = State::WAIT;
+            next = State::ISSUE;
+            break;
+
+        case State::WAIT:
+        {
+            Dtu::Command::Bits cmd = *pkt->getConstPtr<RegFile::reg_t>();
+            if (cmd.opcode != Dtu::Command::IDLE)
+                break;
+
+            if (next == State::ISSUE)
+            {
+                commandDone(cmd.error);
+                state = State::POLL;
+            }
+            else
+                state = next;
+            break;
+        }
+    }
+
+    // the packet will delete the data
+    delete pkt;
+
+    // kick things into action again
+    schedule(tickEvent, clockEdge(Cycles(1)));
+}
+
+void
+DtuTrafficGen::tick()
+{
+    PacketPtr pkt = nullptr;
+
+    inject();
+
+    switch (state)
+    {
+        case State::INIT_EPS:
+        {
+            Addr replyAddr = RECV_ADDR + recvSlots * slotSize;
+            DTUMemory *sys = dynamic_cast<DTUMemory*>(system);
+            if (sys && sys->hasMem(id))
+            {
+                sys->mapSegment(0, replyAddr + recvSlots * slotSize,
+                                DtuTlb::IRWX);
+            }
+
+            // configure EP_RECV and EP_REPLY at once
+            static_assert(EP_REPLY == EP_RECV + 1, "");
+            pkt = createPacket(reg_base + getRegAddr(0, EP_RECV),
+                               sizeof(RegFile::reg_t) * numEpRegs * 2,
+                               MemCmd::WriteReq);
+
+            RegFile::reg_t *regs = pkt->getPtr<RegFile::reg_t>();
+            for (int i = 0; i < 2; ++i)
+            {
+                RegFile::reg_t *epRegs = regs + i * numEpRegs;
+                epRegs[0] = (static_cast<RegFile::reg_t>(EpType::RECEIVE) << 61) |
+                            (static_cast<RegFile::reg_t>(slotSize) << 32) | // msg size
+                            (static_cast<RegFile::reg_t>(recvSlots) << 26) | // slots
+                            (static_cast<RegFile::reg_t>(i * recvSlots) << 6); // header
+                epRegs[1] = i == 0 ? RECV_ADDR : replyAddr;            // buf addr
+                epRegs[2] = 0;                                          // occupied + unread
+            }
+            break;
+        }
+
+        case State::POLL:
+        {
+            // read the message counts of EP_RECV and EP_REPLY
+            pkt = createPacket(reg_base + getRegAddr(0, EP_RECV),
+                               sizeof(RegFile::reg_t) * (numEpRegs + 1),
+                               MemCmd::ReadReq);
+            break;
+        }
+
+        case State::FETCH:
+            pkt = createCommandPkt(Dtu::Command::FETCH_MSG, curEp, 0, 0, 0);
+            break;
+
+        case State::FETCH_OFFSET:
+            pkt = createDtuRegisterPkt(getRegAddr(CmdReg::OFFSET), 0,
+                                       MemCmd::ReadReq);
+            break;
+
+        case State::READ_STAMP:
+            pkt = createPacket(curMsg + sizeof(MessageHeader), sizeof(Tick),
+                               MemCmd::ReadReq);
+            break;
+
+        case State::RESPOND:
+        {
+            // echo the payload (including the timestamp) to the sender
+            if (curEp == EP_RECV && reply)
+            {
+                pkt = createCommandPkt(Dtu::Command::REPLY,
+                                       EP_RECV,
+                                       curMsg + sizeof(MessageHeader),
+                                       size,
+                                       curMsg);
+            }
+            else
+            {
+                pkt = createCommandPkt(Dtu::Command::ACK_MSG,
+                                       curEp, 0, 0, curMsg);
+            }
+            break;
+        }
+
+        case State::SETUP_EP:
+            pkt = createEpPkt(curCmd.op == OP_SEND ? EP_SEND : EP_MEM);
+            break;
+
+        case State::WRITE_STAMP:
+            pkt = createPacket(DATA_ADDR, sizeof(Tick), MemCmd::WriteReq);
+            *pkt->getPtr<Tick>() = curCmd.injected;
+            break;
+
+        case State::ISSUE:
+        {
+            if (curCmd.op == OP_SEND)
+            {
+                // since we are privileged, we have to specify the
+                // source of the message in OFFSET
+                uint64_t off =
+                    (static_cast<uint64_t>(id) << 0) |           // sender core
+                    (Dtu::INVALID_VPE_ID << 8) |                  // sender VPE
+                    (EP_SEND << 24) |                             // sender EP
+                    (static_cast<uint64_t>(EP_REPLY) << 32);      // reply EP
+
+                pkt = createCommandPkt(Dtu::Command::SEND,
+                                       EP_SEND,
+                                       DATA_ADDR,
+                                       size,
+                                       EP_REPLY,
+                                       off);
+            }
+            else
+            {
+                pkt = createCommandPkt(curCmd.op == OP_READ
+                                           ? Dtu::Command::READ
+                                           : Dtu::Command::WRITE,
+                                       EP_MEM,
+                                       DATA_ADDR,
+                                       size,
+                                       0);
+            }
+            DPRINTF(DtuTrafficGen, "Issuing %s to %u\n",
+                    opNames[curCmd.op], curCmd.target);
+            break;
+        }
+
+        case State::WAIT:
+            pkt = createDtuRegisterPkt(getRegAddr(CmdReg::COMMAND), 0,
+                                       MemCmd::ReadReq);
+            break;
+    }
+
+    sendPkt(pkt);
+}
+
+DtuTrafficGen*
+DtuTrafficGenParams::create()
+{
+    return new DtuTrafficGen(this);
+}
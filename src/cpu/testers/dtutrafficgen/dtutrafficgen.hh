@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) 2016, Nils Asmussen
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#ifndef __CPU_DTUTRAFFICGEN_DTUTRAFFICGEN_HH__
+#define __CPU_DTUTRAFFICGEN_DTUTRAFFICGEN_HH__
+
+#include <deque>
+#include <vector>
+
+#include "params/DtuTrafficGen.hh"
+#include "mem/dtu/dtu.hh"
+#include "mem/dtu/regfile.hh"
+#include "sim/system.hh"
+
+/**
+ * A synthetic traffic generator that drives the DTU through its command
+ * registers. Commands (SEND, READ and WRITE) are injected according to a
+ * Poisson process and sent to destinations chosen by a traffic pattern.
+ * Received messages are fetched and either replied to or acknowledged.
+ * The generator configures its own endpoints, which requires the DTU to
+ * be privileged, i.e., M3 must not be running.
+ */
+class DtuTrafficGen : public MemObject
+{
+  public:
+    DtuTrafficGen(const DtuTrafficGenParams *p);
+
+    BaseMasterPort& getMasterPort(const std::string &if_name,
+                                  PortID idx = InvalidPortID) override;
+
+    void regStats() override;
+
+  protected:
+
+    /// main simulation loop
+    void tick();
+
+    EventWrapper<DtuTrafficGen, &DtuTrafficGen::tick> tickEvent;
+
+    class CpuPort : public MasterPort
+    {
+      private:
+        DtuTrafficGen& gen;
+      public:
+        CpuPort(const std::string& _name, DtuTrafficGen* _gen)
+            : MasterPort(_name, _gen), gen(*_gen)
+        { }
+      protected:
+        bool recvTimingResp(PacketPtr pkt) override;
+
+        void recvReqRetry() override;
+    };
+
+    CpuPort port;
+
+    enum class State
+    {
+        INIT_EPS,
+        POLL,
+        FETCH,
+        FETCH_OFFSET,
+        READ_STAMP,
+        RESPOND,
+        SETUP_EP,
+        WRITE_STAMP,
+        ISSUE,
+        WAIT,
+    };
+
+    enum Op
+    {
+        OP_SEND,
+        OP_READ,
+        OP_WRITE,
+        OP_COUNT,
+    };
+
+    struct Command
+    {
+        Op op;
+        unsigned target;
+        Tick injected;
+    };
+
+    State state;
+
+    /// The state to continue with after the DTU command finished
+    State next;
+
+    System *system;
+
+    Addr reg_base;
+
+    /// Request id for all generated traffic
+    MasterID masterId;
+
+    unsigned int id;
+
+    const bool atomic;
+
+    /// Stores the Packet for later retry
+    PacketPtr retryPkt;
+
+    /// Core IDs of all generators and the permutation partner
+    std::vector<unsigned> targets;
+    unsigned permTarget;
+
+    const Enums::DtuTrafficPattern pattern;
+    const unsigned hotspot;
+    const double hotspotRatio;
+
+    /// Relative frequencies of the operations
+    unsigned weights[OP_COUNT];
+    unsigned totalWeight;
+
+    const bool reply;
+    const Addr size;
+    const unsigned recvSlots;
+    const Addr slotSize;
+    const double injectionRate;
+    const unsigned maxPending;
+    const Counter maxCommands;
+
+    /// Injected commands that wait to be issued
+    std::deque<Command> pending;
+
+    /// The command that is currently issued
+    Command curCmd;
+
+    /// The cycle of the next injection
+    Cycles nextInjection;
+
+    /// Number of injected and issued commands
+    Counter injectedCmds;
+    Counter issuedCmds;
+
+    /// Number of sent messages that wait for a reply
+    Counter outstanding;
+
+    /// The current targets of the send and the memory EP
+    int sendEpTarget;
+    int memEpTarget;
+
+    /// The message that is currently handled
+    unsigned curEp;
+    Addr curMsg;
+
+    /// Whether this generator has finished all commands
+    bool finished;
+
+    /// Number of generators that are not finished yet
+    static unsigned activeGens;
+
+    PacketPtr createPacket(Addr paddr, size_t size, MemCmd cmd);
+
+    PacketPtr createDtuRegisterPkt(Addr reg, RegFile::reg_t value, MemCmd cmd);
+
+    PacketPtr createCommandPkt(Dtu::Command::Opcode cmd,
+                               unsigned ep,
+                               Addr data,
+                               Addr size,
+                               Addr arg,
+                               Addr off = 0);
+
+    PacketPtr createEpPkt(unsigned ep);
+
+    bool sendPkt(PacketPtr pkt);
+
+    void completeRequest(PacketPtr pkt);
+
+    void recvRetry();
+
+    /// Injects all commands up to the current cycle
+    void inject();
+
+    /// Chooses the destination of the next command
+    unsigned chooseTarget();
+
+    /// Checks whether we are done and ends the simulation if all are
+    void checkFinished();
+
+    /// Records the completion of the current command
+    void commandDone(unsigned error);
+
+    static Addr getRegAddr(DtuReg reg);
+
+    static Addr getRegAddr(CmdReg reg);
+
+    static Addr getRegAddr(unsigned reg, unsigned epid);
+
+    Stats::Scalar injected;
+    Stats::Scalar throttled;
+    Stats::Vector issued;
+    Stats::Vector errors;
+    Stats::Scalar receivedMsgs;
+    Stats::Scalar deliveredBytes;
+    Stats::Histogram queueLatency;
+    Stats::Histogram msgLatency;
+    Stats::Histogram roundTripLatency;
+    Stats::Histogram readLatency;
+    Stats::Histogram writeLatency;
+    Stats::Formula offeredLoad;
+    Stats::Formula acceptedThroughput;
+};
+
+#endif // __CPU_DTUTRAFFICGEN_DTUTRAFFICGEN_HH__
@@ -73,6 +73,23 @@ class BaseXBar(MemObject):
     # Width governing the throughput of the crossbar
     width = Param.Unsigned("Datapath width per port (bytes)")
 
+    # Each destination port can be served by several layers in
+    # parallel. Packets are assigned to the layers by interleaving on
+    # their address, and each layer may transfer data multiple times
+    # per crossbar cycle.
+    layers_per_port = Param.Unsigned(1, "Number of parallel layers per port")
+    layer_interleave = Param.MemorySize('64B', "Address-interleaving " \
+                                        "granularity of the parallel layers")
+    layer_frequency_ratio = Param.Unsigned(1, "Number of data transfers " \
+                                           "per crossbar cycle of a layer")
+
+    # A small direct-mapped cache in front of the address decoding
+    # that maps address blocks to ports
+    decode_cache_entries = Param.Unsigned(64, "Number of entries in the " \
+                                          "address-decode cache (0 = off)")
+    decode_cache_block_size = Param.MemorySize('4kB', "Size of the address " \
+                                               "blocks in the decode cache")
+
     # The default port can be left unconnected, or be used to connect
     # a default slave port
     default = MasterPort("Port for connecting an optional default slave")
@@ -59,10 +59,15 @@ using namespace std;
 AbstractMemory::AbstractMemory(const Params *p) :
     MemObject(p), range(params()->range), pmemAddr(NULL),
     confTableReported(p->conf_table_reported), inAddrMap(p->in_addr_map),
-    kvmMap(p->kvm_map), _system(NULL)
+    kvmMap(p->kvm_map), backdoor(params()->range), _system(NULL)
 {
 }
 
+AbstractMemory::~AbstractMemory()
+{
+    backdoor.invalidate();
+}
+
 void
 AbstractMemory::init()
 {
@@ -76,6 +81,18 @@ void
 AbstractMemory::setBackingStore(uint8_t* pmem_addr)
 {
     pmemAddr = pmem_addr;
+
+    // existing users of the backdoor still refer to the old store
+    backdoor.invalidate();
+    backdoor.ptr(pmemAddr);
+    backdoor.flags(MemBackdoor::ReadWrite);
+}
+
+void
+AbstractMemory::getBackdoor(MemBackdoorPtr &bd_ptr)
+{
+    if (pmemAddr && !range.interleaved() && lockedAddrList.empty())
+        bd_ptr = &backdoor;
 }
 
 void
@@ -220,6 +237,9 @@ AbstractMemory::trackLoadLocked(PacketPtr pkt)
     DPRINTF(LLSC, "Adding lock record: context %d addr %#x\n",
             req->contextId(), paddr);
     lockedAddrList.push_front(LockedAddr(req));
+
+    // stores through the backdoor would not clear the lock
+    backdoor.invalidate();
 }
 
 
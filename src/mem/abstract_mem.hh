@@ -49,6 +49,7 @@
 #ifndef __MEM_ABSTRACT_MEMORY_HH__
 #define __MEM_ABSTRACT_MEMORY_HH__
 
+#include "mem/backdoor.hh"
 #include "mem/mem_object.hh"
 #include "params/AbstractMemory.hh"
 #include "sim/stats.hh"
@@ -121,6 +122,10 @@ class AbstractMemory : public MemObject
 
     std::list<LockedAddr> lockedAddrList;
 
+    // Backdoor to the host memory of this memory, handed out to masters
+    // that access the memory directly in atomic mode
+    MemBackdoor backdoor;
+
     // helper function for checkLockedAddrs(): we really want to
     // inline a quick check for an empty locked addr list (hopefully
     // the common case), and do the full list search (if necessary) in
@@ -195,7 +200,7 @@ class AbstractMemory : public MemObject
     typedef AbstractMemoryParams Params;
 
     AbstractMemory(const Params* p);
-    virtual ~AbstractMemory() {}
+    virtual ~AbstractMemory();
 
     /**
      * Initialise this memory.
@@ -218,6 +223,16 @@ class AbstractMemory : public MemObject
      */
     void setBackingStore(uint8_t* pmem_addr);
 
+    /**
+     * Get a backdoor to the host memory backing this memory. The backdoor
+     * is only provided if the memory has a backing store, is not
+     * interleaved and no load-locked addresses are tracked, because
+     * accesses through the backdoor bypass the LL/SC bookkeeping.
+     *
+     * @param bd_ptr Set to the backdoor, if available
+     */
+    void getBackdoor(MemBackdoorPtr &bd_ptr);
+
     /**
      * Get the list of locked addresses to allow checkpointing.
      */
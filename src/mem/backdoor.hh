@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2016, Nils Asmussen
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#ifndef __MEM_BACKDOOR_HH__
+#define __MEM_BACKDOOR_HH__
+
+#include <cstdint>
+#include <functional>
+#include <list>
+
+#include "base/addr_range.hh"
+
+/**
+ * A memory backdoor describes a contiguous range of host memory that backs
+ * a range of simulated physical memory. A master that obtained a backdoor
+ * via MasterPort::sendAtomicBackdoor can access this range directly with
+ * memcpy instead of sending a packet per access. The backdoor does not update
+ * any state or statistics of the memory and must therefore only be used in
+ * atomic mode.
+ *
+ * The owner of the backdoor invalidates it if the mapping is no longer valid
+ * (e.g., because a load-locked has been recorded in the memory). Users that
+ * cache a backdoor have to register an invalidation callback to drop it.
+ */
+class MemBackdoor
+{
+  public:
+
+    typedef std::function<void(const MemBackdoor &backdoor)> CallbackType;
+
+    enum Flags
+    {
+        NoAccess    = 0,
+        Readable    = 1 << 0,
+        Writeable   = 1 << 1,
+        ReadWrite   = Readable | Writeable,
+    };
+
+    MemBackdoor(const AddrRange &r = AddrRange(), uint8_t *p = nullptr,
+                Flags flags = NoAccess)
+        : _range(r), _ptr(p), _flags(flags), invalidationCallbacks()
+    {}
+
+    MemBackdoor(const MemBackdoor &) = delete;
+    MemBackdoor &operator=(const MemBackdoor &) = delete;
+
+    const AddrRange &range() const { return _range; }
+    void range(const AddrRange &r) { _range = r; }
+
+    uint8_t *ptr() const { return _ptr; }
+    void ptr(uint8_t *p) { _ptr = p; }
+
+    Flags flags() const { return _flags; }
+    void flags(Flags f) { _flags = f; }
+
+    bool readable() const { return _flags & Readable; }
+    bool writeable() const { return _flags & Writeable; }
+
+    /**
+     * Checks whether the given access can be performed through this backdoor.
+     *
+     * @param addr the physical start address
+     * @param size the number of bytes
+     * @param write whether it is a write access
+     * @return true if the access is fully covered and allowed
+     */
+    bool
+    covers(Addr addr, Addr size, bool write) const
+    {
+        if (!_ptr || size == 0)
+            return false;
+        if (!(write ? writeable() : readable()))
+            return false;
+        return _range.contains(addr) && _range.contains(addr + size - 1);
+    }
+
+    /**
+     * Returns the host address for the given physical address.
+     * The address has to be covered by this backdoor.
+     */
+    uint8_t *
+    hostAddr(Addr addr) const
+    {
+        return _ptr + (addr - _range.start());
+    }
+
+    void
+    addInvalidationCallback(CallbackType func)
+    {
+        invalidationCallbacks.push_back(std::move(func));
+    }
+
+    /**
+     * Notifies all users that this backdoor is no longer valid. All
+     * registered callbacks are removed afterwards, so that users have to
+     * request the backdoor again.
+     */
+    void
+    invalidate()
+    {
+        // move the list away first, because callbacks might register new
+        // callbacks or drop their references
+        std::list<CallbackType> callbacks;
+        callbacks.swap(invalidationCallbacks);
+        for (auto &func : callbacks)
+            func(*this);
+    }
+
+  private:
+
+    AddrRange _range;
+    uint8_t *_ptr;
+    Flags _flags;
+
+    std::list<CallbackType> invalidationCallbacks;
+};
+
+typedef MemBackdoor *MemBackdoorPtr;
+
+#endif // __MEM_BACKDOOR_HH__
@@ -55,6 +55,7 @@
 #include "debug/CacheRepl.hh"
 #include "debug/CacheVerbose.hh"
 #include "mem/cache/mshr.hh"
+#include "mem/coherent_xbar.hh"
 #include "mem/cache/prefetch/base.hh"
 #include "mem/cache/queue_entry.hh"
 #include "params/BaseCache.hh"
@@ -627,6 +628,10 @@ BaseCache::functionalAccess(PacketPtr pkt, bool from_cpu_side)
 {
     Addr blk_addr = pkt->getBlockAddr(blkSize);
     bool is_secure = pkt->isSecure();
+
+    // a functional warmer might update the tags concurrently
+    std::unique_lock<std::mutex> warm_lock(warmLock);
+
     CacheBlk *blk = tags->findBlock(pkt->getAddr(), is_secure);
     MSHR *mshr = mshrQueue.findMatch(blk_addr, is_secure);
 
@@ -640,7 +645,7 @@ BaseCache::functionalAccess(PacketPtr pkt, bool from_cpu_side)
     // we have it, but only declare it satisfied if we are the owner.
 
     // see if we have data at all (owned or otherwise)
-    bool have_data = blk && blk->isValid()
+    bool have_data = blk && blk->isValid() && !(blk->status & BlkWarmed)
         && pkt->trySatisfyFunctional(&cbpw, blk_addr, is_secure, blkSize,
                                      blk->data);
 
@@ -663,6 +668,8 @@ BaseCache::functionalAccess(PacketPtr pkt, bool from_cpu_side)
     // We're leaving the cache, so pop cache->name() label
     pkt->popLabel();
 
+    warm_lock.unlock();
+
     if (done) {
         pkt->makeResponse();
     } else {
@@ -1393,15 +1400,83 @@ BaseCache::writecleanBlk(CacheBlk *blk, Request::Flags dest, PacketId id)
 void
 BaseCache::memWriteback()
 {
+    std::lock_guard<std::mutex> warm_lock(warmLock);
     tags->forEachBlk([this](CacheBlk &blk) { writebackVisitor(blk); });
 }
 
 void
 BaseCache::memInvalidate()
 {
+    std::lock_guard<std::mutex> warm_lock(warmLock);
     tags->forEachBlk([this](CacheBlk &blk) { invalidateVisitor(blk); });
 }
 
+bool
+BaseCache::warmAccess(Addr addr, bool is_secure)
+{
+    std::lock_guard<std::mutex> warm_lock(warmLock);
+
+    Cycles lat;
+    CacheBlk *blk = tags->accessBlock(addr, is_secure, lat);
+    if (blk)
+        return true;
+
+    std::vector<CacheBlk*> evict_blks;
+    blk = tags->findVictim(addr, is_secure, evict_blks);
+    if (!blk)
+        return false;
+
+    for (auto evict : evict_blks) {
+        if (evict->isValid()) {
+            // the caches are bypassed during warming, so nothing can be
+            // dirty here
+            panic_if(evict->isDirty(), "Cannot warm over dirty block\n");
+            tags->invalidate(evict);
+        }
+    }
+
+    tags->insertBlock(addr, is_secure, Request::funcMasterId, 0, blk);
+    // the block is not readable until its data has been fetched
+    blk->status |= BlkWarmed;
+    return false;
+}
+
+void
+BaseCache::fillWarmedBlocks(const std::vector<BaseCache*> &below)
+{
+    tags->forEachBlk([this, &below](CacheBlk &blk) {
+        if (!(blk.status & BlkWarmed))
+            return;
+
+        Addr addr = regenerateBlkAddr(&blk);
+        RequestPtr request = std::make_shared<Request>(
+            addr, blkSize, 0, Request::funcMasterId);
+        if (blk.isSecure())
+            request->setFlags(Request::SECURE);
+
+        Packet packet(request, MemCmd::ReadReq);
+        packet.dataStatic(blk.data);
+        memSidePort.sendFunctional(&packet);
+
+        blk.status &= ~BlkWarmed;
+        blk.status |= BlkReadable;
+
+        // remote writes have to find the block to invalidate it
+        warmSnoopFilter(addr, blk.isSecure());
+        for (auto cache : below)
+            cache->warmSnoopFilter(addr, blk.isSecure());
+    });
+}
+
+void
+BaseCache::warmSnoopFilter(Addr addr, bool is_secure)
+{
+    BaseSlavePort &peer = memSidePort.getSlavePort();
+    CoherentXBar *xbar = dynamic_cast<CoherentXBar*>(&peer.getOwner());
+    if (xbar)
+        xbar->warmSnoopFilter(addr, is_secure, peer.getId());
+}
+
 bool
 BaseCache::isDirty() const
 {
@@ -54,6 +54,7 @@
 
 #include <cassert>
 #include <cstdint>
+#include <mutex>
 #include <string>
 
 #include "base/addr_range.hh"
@@ -765,6 +766,42 @@ public:
      */
     virtual void memInvalidate() override;
 
+    /**
+     * Updates the tags and the replacement state for an access to the
+     * given address without moving any data (functional warming). On a
+     * miss, a block is allocated and marked as BlkWarmed; its data is
+     * fetched later by fillWarmedBlocks(). This may be called from a
+     * different host thread than the simulation, but only while the
+     * system bypasses the caches. Functional accesses, writebacks and
+     * invalidations of the simulation thread are excluded meanwhile.
+     *
+     * @param addr the accessed address
+     * @param is_secure whether the access is secure
+     * @return true if the access hit
+     */
+    bool warmAccess(Addr addr, bool is_secure);
+
+    /**
+     * Fetches the data of all blocks allocated by warmAccess() from the
+     * memory below using functional accesses. The blocks end up clean and
+     * readable, but not writable. Since no request passes the crossbars,
+     * their snoop filters are told about the blocks explicitly: the one
+     * below this cache and the ones below the given caches, which lie
+     * between this cache and the memory.
+     *
+     * @param below the caches below this one
+     */
+    void fillWarmedBlocks(const std::vector<BaseCache*> &below);
+
+    /**
+     * Tells the snoop filter of the crossbar below this cache, if any,
+     * that the caches above it hold the given line.
+     *
+     * @param addr the address of the line
+     * @param is_secure whether the line is secure
+     */
+    void warmSnoopFilter(Addr addr, bool is_secure);
+
 protected:
     /**
      * Determine if there are any dirty blocks in the cache.
@@ -869,6 +906,13 @@ protected:
      * Normally this is all possible memory addresses. */
     const AddrRangeList addrRanges;
 
+    /**
+     * Serializes warmAccess(), which may run on the thread of a
+     * functional warmer, with the simulation thread's accesses to the
+     * tags while the caches are bypassed.
+     */
+    std::mutex warmLock;
+
   public:
     /** System we are currently operating in. */
     System *system;
@@ -76,6 +76,8 @@ enum CacheBlkStatusBits : unsigned {
     BlkHWPrefetched =   0x20,
     /** block holds data from the secure memory space */
     BlkSecure =         0x40,
+    /** tag and replacement state were warmed, but the data is missing */
+    BlkWarmed =         0x80,
 };
 
 /**
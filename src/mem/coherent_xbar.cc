@@ -69,8 +69,7 @@ CoherentXBar::CoherentXBar(const CoherentXBarParams *p)
         std::string portName = csprintf("%s.master[%d]", name(), i);
         MasterPort* bp = new CoherentXBarMasterPort(portName, *this, i);
         masterPorts.push_back(bp);
-        reqLayers.push_back(new ReqLayer(*bp, *this,
-                                         csprintf(".reqLayer%d", i)));
+        createLayers(reqLayers, *bp, ".reqLayer", i);
         snoopLayers.push_back(new SnoopRespLayer(*bp, *this,
                                                  csprintf(".snoopLayer%d", i)));
     }
@@ -83,8 +82,7 @@ CoherentXBar::CoherentXBar(const CoherentXBarParams *p)
         MasterPort* bp = new CoherentXBarMasterPort(portName, *this,
                                                    defaultPortID);
         masterPorts.push_back(bp);
-        reqLayers.push_back(new ReqLayer(*bp, *this, csprintf(".reqLayer%d",
-                                             defaultPortID)));
+        createLayers(reqLayers, *bp, ".reqLayer", defaultPortID);
         snoopLayers.push_back(new SnoopRespLayer(*bp, *this,
                                                  csprintf(".snoopLayer%d",
                                                           defaultPortID)));
@@ -95,8 +93,7 @@ CoherentXBar::CoherentXBar(const CoherentXBarParams *p)
         std::string portName = csprintf("%s.slave[%d]", name(), i);
         QueuedSlavePort* bp = new CoherentXBarSlavePort(portName, *this, i);
         slavePorts.push_back(bp);
-        respLayers.push_back(new RespLayer(*bp, *this,
-                                           csprintf(".respLayer%d", i)));
+        createLayers(respLayers, *bp, ".respLayer", i);
         snoopRespPorts.push_back(new SnoopRespPort(*bp, *this));
     }
 }
@@ -157,7 +154,8 @@ CoherentXBar::recvTimingReq(PacketPtr pkt, PortID slave_port_id)
 
     // test if the crossbar should be considered occupied for the current
     // port, and exclude express snoops from the check
-    if (!is_express_snoop && !reqLayers[master_port_id]->tryTiming(src_port)) {
+    ReqLayer *layer = selectLayer(reqLayers, master_port_id, pkt->getAddr());
+    if (!is_express_snoop && !layer->tryTiming(src_port)) {
         DPRINTF(CoherentXBar, "%s: src %s packet %s BUSY\n", __func__,
                 src_port->name(), pkt->print());
         return false;
@@ -203,8 +201,7 @@ CoherentXBar::recvTimingReq(PacketPtr pkt, PortID slave_port_id)
                         src_port->name(), pkt->print());
 
                 // update the layer state and schedule an idle event
-                reqLayers[master_port_id]->failedTiming(src_port,
-                                                        clockEdge(Cycles(1)));
+                layer->failedTiming(src_port, clockEdge(Cycles(1)));
                 return false;
             }
         }
@@ -312,8 +309,7 @@ CoherentXBar::recvTimingReq(PacketPtr pkt, PortID slave_port_id)
                 src_port->name(), pkt->print());
 
         // update the layer state and schedule an idle event
-        reqLayers[master_port_id]->failedTiming(src_port,
-                                                clockEdge(Cycles(1)));
+        layer->failedTiming(src_port, clockEdge(Cycles(1)));
     } else {
         // express snoops currently bypass the crossbar state entirely
         if (!is_express_snoop) {
@@ -340,7 +336,7 @@ CoherentXBar::recvTimingReq(PacketPtr pkt, PortID slave_port_id)
             }
 
             // update the layer state and schedule an idle event
-            reqLayers[master_port_id]->succeededTiming(packetFinishTime);
+            layer->succeededTiming(packetFinishTime);
         }
 
         // stats updates only consider packets that were successfully sent
@@ -390,7 +386,7 @@ CoherentXBar::recvTimingReq(PacketPtr pkt, PortID slave_port_id)
                 assert(route_lookup != routeTo.end());
                 rsp_port_id = route_lookup->second;
                 assert(rsp_port_id != InvalidPortID);
-                assert(rsp_port_id < respLayers.size());
+                assert(rsp_port_id < slavePorts.size());
                 // remove the request from the routing table
                 routeTo.erase(route_lookup);
             }
@@ -444,11 +440,13 @@ CoherentXBar::recvTimingResp(PacketPtr pkt, PortID master_port_id)
     assert(route_lookup != routeTo.end());
     const PortID slave_port_id = route_lookup->second;
     assert(slave_port_id != InvalidPortID);
-    assert(slave_port_id < respLayers.size());
+    assert(slave_port_id < slavePorts.size());
 
     // test if the crossbar should be considered occupied for the
     // current port
-    if (!respLayers[slave_port_id]->tryTiming(src_port)) {
+    RespLayer *layer = selectLayer(respLayers, slave_port_id,
+                                   pkt->getAddr());
+    if (!layer->tryTiming(src_port)) {
         DPRINTF(CoherentXBar, "%s: src %s packet %s BUSY\n", __func__,
                 src_port->name(), pkt->print());
         return false;
@@ -485,7 +483,7 @@ CoherentXBar::recvTimingResp(PacketPtr pkt, PortID master_port_id)
     // remove the request from the routing table
     routeTo.erase(route_lookup);
 
-    respLayers[slave_port_id]->succeededTiming(packetFinishTime);
+    layer->succeededTiming(packetFinishTime);
 
     // stats updates
     pktCount[slave_port_id][master_port_id]++;
@@ -580,6 +578,7 @@ CoherentXBar::recvTimingSnoopResp(PacketPtr pkt, PortID slave_port_id)
     // current port, note that the check is bypassed if the response
     // is being passed on as a normal response since this is occupying
     // the response layer rather than the snoop response layer
+    RespLayer *resp_layer = nullptr;
     if (forwardAsSnoop) {
         assert(dest_port_id < snoopLayers.size());
         if (!snoopLayers[dest_port_id]->tryTiming(src_port)) {
@@ -590,8 +589,9 @@ CoherentXBar::recvTimingSnoopResp(PacketPtr pkt, PortID slave_port_id)
     } else {
         // get the master port that mirrors this slave port internally
         MasterPort* snoop_port = snoopRespPorts[slave_port_id];
-        assert(dest_port_id < respLayers.size());
-        if (!respLayers[dest_port_id]->tryTiming(snoop_port)) {
+        assert(dest_port_id < slavePorts.size());
+        resp_layer = selectLayer(respLayers, dest_port_id, pkt->getAddr());
+        if (!resp_layer->tryTiming(snoop_port)) {
             DPRINTF(CoherentXBar, "%s: src %s packet %s BUSY\n", __func__,
                     snoop_port->name(), pkt->print());
             return false;
@@ -668,7 +668,7 @@ CoherentXBar::recvTimingSnoopResp(PacketPtr pkt, PortID slave_port_id)
         pkt->headerDelay = 0;
         slavePorts[dest_port_id]->schedTimingResp(pkt, curTick() + latency);
 
-        respLayers[dest_port_id]->succeededTiming(packetFinishTime);
+        resp_layer->succeededTiming(packetFinishTime);
     }
 
     // remove the request from the routing table
@@ -717,11 +717,12 @@ CoherentXBar::recvReqRetry(PortID master_port_id)
     // responses and snoop responses never block on forwarding them,
     // so the retry will always be coming from a port to which we
     // tried to forward a request
-    reqLayers[master_port_id]->recvRetry();
+    retryLayer(reqLayers, master_port_id);
 }
 
 Tick
-CoherentXBar::recvAtomic(PacketPtr pkt, PortID slave_port_id)
+CoherentXBar::recvAtomicBackdoor(PacketPtr pkt, PortID slave_port_id,
+                                 MemBackdoorPtr *backdoor)
 {
     DPRINTF(CoherentXBar, "%s: src %s packet %s\n", __func__,
             slavePorts[slave_port_id]->name(), pkt->print());
@@ -799,8 +800,14 @@ CoherentXBar::recvAtomic(PacketPtr pkt, PortID slave_port_id)
                 pkt->clearWriteThrough();
             }
 
-            // forward the request to the appropriate destination
-            response_latency = masterPorts[master_port_id]->sendAtomic(pkt);
+            // forward the request to the appropriate destination. a
+            // backdoor is only passed on if there is nobody that could
+            // hold a more recent copy of the data
+            auto master = masterPorts[master_port_id];
+            if (backdoor && (!snoop_caches || snoopPorts.empty()))
+                response_latency = master->sendAtomicBackdoor(pkt, *backdoor);
+            else
+                response_latency = master->sendAtomic(pkt);
         } else {
             // if it does not need a response we sink the packet above
             assert(pkt->needsResponse());
@@ -1097,6 +1104,13 @@ CoherentXBar::forwardPacket(const PacketPtr pkt)
 }
 
 
+void
+CoherentXBar::warmSnoopFilter(Addr addr, bool is_secure, PortID slave_port_id)
+{
+    if (snoopFilter)
+        snoopFilter->insertHolder(addr, is_secure, *slavePorts[slave_port_id]);
+}
+
 void
 CoherentXBar::regStats()
 {
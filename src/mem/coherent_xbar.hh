@@ -126,6 +126,14 @@ class CoherentXBar : public BaseXBar
         virtual Tick recvAtomic(PacketPtr pkt)
         { return xbar.recvAtomic(pkt, id); }
 
+        /**
+         * When receiving an atomic request with a backdoor request, pass
+         * it to the crossbar.
+         */
+        virtual Tick recvAtomicBackdoor(PacketPtr pkt,
+                                        MemBackdoorPtr &backdoor)
+        { return xbar.recvAtomicBackdoor(pkt, id, &backdoor); }
+
         /**
          * When receiving a functional request, pass it to the crossbar.
          */
@@ -341,7 +349,14 @@ class CoherentXBar : public BaseXBar
 
     /** Function called by the port when the crossbar is recieving a Atomic
       transaction.*/
-    Tick recvAtomic(PacketPtr pkt, PortID slave_port_id);
+    Tick recvAtomic(PacketPtr pkt, PortID slave_port_id)
+    { return recvAtomicBackdoor(pkt, slave_port_id); }
+
+    /** Function called by the port when the crossbar is recieving a Atomic
+      transaction that asks for a backdoor. The backdoor is only requested
+      from the destination if backdoor is not null.*/
+    Tick recvAtomicBackdoor(PacketPtr pkt, PortID slave_port_id,
+                            MemBackdoorPtr *backdoor = nullptr);
 
     /** Function called by the port when the crossbar is recieving an
         atomic snoop transaction.*/
@@ -441,6 +456,12 @@ class CoherentXBar : public BaseXBar
 
     virtual ~CoherentXBar();
 
+    /**
+     * Tell the snoop filter that the caches behind the given slave port
+     * hold a line that was allocated by functional warming.
+     */
+    void warmSnoopFilter(Addr addr, bool is_secure, PortID slave_port_id);
+
     virtual void regStats();
 };
 
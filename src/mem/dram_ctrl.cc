@@ -2957,6 +2957,15 @@ DRAMCtrl::MemoryPort::recvAtomic(PacketPtr pkt)
     return memory.recvAtomic(pkt);
 }
 
+Tick
+DRAMCtrl::MemoryPort::recvAtomicBackdoor(PacketPtr pkt,
+                                         MemBackdoorPtr &backdoor)
+{
+    Tick latency = memory.recvAtomic(pkt);
+    memory.getBackdoor(backdoor);
+    return latency;
+}
+
 bool
 DRAMCtrl::MemoryPort::recvTimingReq(PacketPtr pkt)
 {
@@ -116,6 +116,8 @@ class DRAMCtrl : public QoS::MemCtrl
 
         Tick recvAtomic(PacketPtr pkt);
 
+        Tick recvAtomicBackdoor(PacketPtr pkt, MemBackdoorPtr &backdoor);
+
         void recvFunctional(PacketPtr pkt);
 
         bool recvTimingReq(PacketPtr);
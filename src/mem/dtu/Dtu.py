@@ -31,6 +31,8 @@ from Connector import BaseConnector
 from m5.params import *
 from m5.proxy import *
 
+class DtuSnoopFilter(Enum): vals = ['disabled', 'h3', 'counting']
+
 class BaseDtu(MemObject):
     type = 'BaseDtu'
     abstract = True
@@ -52,6 +54,12 @@ class BaseDtu(MemObject):
 
     coherent = Param.Bool(False, "Whether the DTU should keep the caches coherent")
 
+    snoop_filter = Param.DtuSnoopFilter('disabled', "The filter that drops snoops for lines not in the caches (only if coherent)")
+    snoop_filter_size = Param.Unsigned(4096, "The number of entries of the snoop filter (power of 2)")
+    snoop_filter_hashes = Param.Unsigned(4, "The number of hash functions of the H3 snoop filter")
+    snoop_filter_max_count = Param.Unsigned(15, "The maximum value of a counter of the counting snoop filter")
+    cache_line_size = Param.Unsigned(Parent.cache_line_size, "The cache line size in bytes")
+
     mmio_region = Param.AddrRange(AddrRange(0xF0000000, 0xF0001FFF), "MMIO region of the DTU")
 
     core_id = Param.Unsigned("ID of the core this DTU belongs to")
@@ -62,6 +70,8 @@ class BaseDtu(MemObject):
     tlb_entries = Param.Unsigned(512, "The number of TLB entries")
     pt_walker = Param.Bool(True, "Whether the DTU has a PT walker")
 
+    mem_backdoor = Param.Bool(True, "Whether the DTU accesses the local memory via a backdoor in atomic mode, if available")
+
 class Dtu(BaseDtu):
     type = 'Dtu'
     cxx_header = "mem/dtu/dtu.hh"
@@ -83,6 +93,12 @@ class Dtu(BaseDtu):
 
     register_access_latency = Param.Cycles(1, "Latency for CPU register accesses")
 
+    spin_poll_threshold = Param.Unsigned(16, "Number of unchanged reads of MSG_CNT or COMMAND after which the core is suspended (0 = disabled)")
+    spin_poll_window = Param.Cycles(256, "Maximum number of cycles between two reads to count them as a polling loop")
+    spin_poll_timeout = Param.Cycles(1000000, "Number of cycles after which a suspended polling core is woken up again (0 = never)")
+
+    cmd_trace = Param.Bool(False, "Record the executed commands to <name>.cmdtrace in the output directory")
+
     cpu_to_cache_latency = Param.Cycles(1, "Latency for cache access for the CPU (for the DTU's address translation)")
 
     command_to_noc_request_latency = Param.Cycles(1, "Number of cycles passed from writing a command to the register to starting the command")
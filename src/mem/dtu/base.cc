@@ -33,6 +33,7 @@
 #include "debug/Dtu.hh"
 #include "mem/dtu/base.hh"
 #include "mem/dtu/noc_addr.hh"
+#include "mem/dtu/snoop_filter.hh"
 
 BaseDtu::DtuMasterPort::DtuMasterPort(const std::string& _name, BaseDtu& _dtu)
   : QueuedMasterPort(_name, &_dtu, reqQueue, snoopRespQueue),
@@ -65,15 +66,28 @@ BaseDtu::NocMasterPort::completeRequest(PacketPtr pkt)
 void
 BaseDtu::NocMasterPort::recvFunctionalSnoop(PacketPtr pkt)
 {
-    if (dtu.cacheMemSlavePort.isConnected())
+    if (dtu.cacheMemSlavePort.isConnected() &&
+        dtu.snoopFilterMayContain(pkt->getAddr()))
         dtu.cacheMemSlavePort.sendFunctionalSnoop(pkt);
 }
 
 void
 BaseDtu::NocMasterPort::recvTimingSnoopReq(PacketPtr pkt)
 {
-    if (dtu.cacheMemSlavePort.isConnected())
-        dtu.cacheMemSlavePort.sendTimingSnoopReq(pkt);
+    if (!dtu.cacheMemSlavePort.isConnected())
+        return;
+
+    // if none of our caches has the line, they would not respond anyway
+    if (!dtu.snoopFilterMayContain(pkt->getAddr()))
+    {
+        DPRINTF(DtuMasterPort, "Filtered snoop %s at %#x\n",
+                pkt->cmd.toString(), pkt->getAddr());
+        dtu.snoopsFiltered++;
+        return;
+    }
+
+    dtu.snoopsForwarded++;
+    dtu.cacheMemSlavePort.sendTimingSnoopReq(pkt);
 }
 
 void
@@ -306,11 +320,46 @@ BaseDtu::BaseDtu(BaseDtuParams* p)
     cacheMemSlavePort(*this),
     caches(p->caches),
     nocReqFinishedEvent(*this),
+    snoopFilter(),
     coreId(p->core_id),
     mmioRegion(p->mmio_region),
     slaveRegion(p->slave_region),
-    coherent(p->coherent)
+    coherent(p->coherent),
+    useMemBackdoor(p->mem_backdoor)
+{
+    if (p->snoop_filter != Enums::disabled)
+    {
+        snoopFilter = new DtuSnoopFilter(p->snoop_filter,
+                                         p->snoop_filter_size,
+                                         p->snoop_filter_hashes,
+                                         p->snoop_filter_max_count,
+                                         p->cache_line_size);
+    }
+}
+
+BaseDtu::~BaseDtu()
+{
+    delete snoopFilter;
+}
+
+void
+BaseDtu::regStats()
 {
+    MemObject::regStats();
+
+    memBackdoorAccesses
+        .name(name() + ".memBackdoorAccesses")
+        .desc("Number of local memory accesses performed via a backdoor");
+    memBackdoorBytes
+        .name(name() + ".memBackdoorBytes")
+        .desc("Number of bytes transferred via a backdoor");
+
+    snoopsForwarded
+        .name(name() + ".snoopsForwarded")
+        .desc("Number of snoops forwarded to the caches");
+    snoopsFiltered
+        .name(name() + ".snoopsFiltered")
+        .desc("Number of snoops dropped by the snoop filter");
 }
 
 void
@@ -351,6 +400,10 @@ BaseDtu::CacheMemSlavePort::handleRequest(PacketPtr pkt,
                                           bool *busy,
                                           bool functional)
 {
+    // functional requests don't change the contents of the caches
+    if (!functional)
+        dtu.updateSnoopFilter(pkt);
+
     // if that failed, it was an invalid request (probably due to speculative
     // execution)
     if (!dtu.handleCacheMemRequest(pkt, functional))
@@ -360,6 +413,21 @@ BaseDtu::CacheMemSlavePort::handleRequest(PacketPtr pkt,
     return true;
 }
 
+void
+BaseDtu::updateSnoopFilter(PacketPtr pkt)
+{
+    if (snoopFilter && coherent)
+        snoopFilter->update(pkt);
+}
+
+bool
+BaseDtu::snoopFilterMayContain(Addr addr)
+{
+    if (!snoopFilter || !coherent)
+        return true;
+    return snoopFilter->mayContain(addr);
+}
+
 void
 BaseDtu::sendDummyResponse(DtuSlavePort &port, PacketPtr pkt, bool functional)
 {
@@ -498,5 +566,100 @@ BaseDtu::printNocRequest(PacketPtr pkt, const char *type)
 void
 BaseDtu::sendAtomicMemRequest(PacketPtr pkt)
 {
-    dcacheMasterPort.sendAtomic(pkt);
+    if (!useMemBackdoor)
+    {
+        dcacheMasterPort.sendAtomic(pkt);
+        return;
+    }
+
+    bool write = pkt->isWrite();
+    assert(write || pkt->isRead());
+
+    const CachedBackdoor *cbd = findMemBackdoor(pkt->getAddr(),
+                                                pkt->getSize(),
+                                                write);
+    if (cbd)
+    {
+        MemBackdoorPtr bd = cbd->backdoor;
+        if (write)
+            pkt->writeData(bd->hostAddr(pkt->getAddr()));
+        else
+            pkt->setData(bd->hostAddr(pkt->getAddr()));
+        pkt->makeResponse();
+
+        memBackdoorAccesses++;
+        memBackdoorBytes += pkt->getSize();
+        return;
+    }
+
+    MemBackdoorPtr bd = nullptr;
+    Tick latency = dcacheMasterPort.sendAtomicBackdoor(pkt, bd);
+    if (bd)
+        addMemBackdoor(bd, latency);
+}
+
+bool
+BaseDtu::accessMemBackdoor(Addr addr, uint8_t *data, Addr size, bool write,
+                           Tick &latency)
+{
+    if (!useMemBackdoor)
+        return false;
+
+    const CachedBackdoor *cbd = findMemBackdoor(addr, size, write);
+    if (!cbd)
+        return false;
+
+    DPRINTF(DtuMasterPort, "%s %lu bytes @ %#x via backdoor\n",
+            write ? "Writing" : "Reading", size, addr);
+
+    MemBackdoorPtr bd = cbd->backdoor;
+    if (write)
+        memcpy(bd->hostAddr(addr), data, size);
+    else
+        memcpy(data, bd->hostAddr(addr), size);
+
+    // the latency of a single access; the caller decides how many
+    // accesses the copy corresponds to
+    latency = cbd->latency;
+
+    memBackdoorAccesses++;
+    memBackdoorBytes += size;
+    return true;
+}
+
+const BaseDtu::CachedBackdoor *
+BaseDtu::findMemBackdoor(Addr addr, Addr size, bool write) const
+{
+    for (auto &cbd : memBackdoors)
+    {
+        if (cbd.backdoor->covers(addr, size, write))
+            return &cbd;
+    }
+    return nullptr;
+}
+
+void
+BaseDtu::addMemBackdoor(MemBackdoorPtr backdoor, Tick latency)
+{
+    for (auto &cbd : memBackdoors)
+    {
+        if (cbd.backdoor == backdoor)
+            return;
+    }
+
+    DPRINTF(DtuMasterPort, "Got backdoor for %s (latency %lu)\n",
+            backdoor->range().to_string(), latency);
+
+    memBackdoors.push_back(CachedBackdoor{backdoor, latency});
+    backdoor->addInvalidationCallback(
+        [this](const MemBackdoor &bd)
+        {
+            DPRINTF(DtuMasterPort, "Backdoor for %s invalidated\n",
+                    bd.range().to_string());
+            memBackdoors.remove_if(
+                [&bd](const CachedBackdoor &cbd)
+                {
+                    return cbd.backdoor == &bd;
+                });
+        });
 }
@@ -31,12 +31,14 @@
 #ifndef __MEM_DTU_BASE_HH__
 #define __MEM_DTU_BASE_HH__
 
+#include <list>
 #include <queue>
 
 #include "mem/mem_object.hh"
 #include "mem/qport.hh"
 #include "params/BaseDtu.hh"
 #include "mem/dtu/tlb.hh"
+#include "mem/dtu/snoop_filter.hh"
 #include "mem/dtu/pt_unit.hh"
 
 class BaseDtu : public MemObject
@@ -236,8 +238,12 @@ class BaseDtu : public MemObject
 
     BaseDtu(BaseDtuParams* p);
 
+    ~BaseDtu();
+
     void init() override;
 
+    void regStats() override;
+
     BaseSlavePort& getSlavePort(const std::string &n, PortID idx) override;
 
     BaseMasterPort& getMasterPort(const std::string &n, PortID idx) override;
@@ -258,6 +264,9 @@ class BaseDtu : public MemObject
 
     void sendAtomicMemRequest(PacketPtr pkt);
 
+    bool accessMemBackdoor(Addr addr, uint8_t *data, Addr size, bool write,
+                           Tick &latency);
+
     void sendCacheMemResponse(PacketPtr pkt, bool success);
 
     virtual void completeNocRequest(PacketPtr pkt) = 0;
@@ -287,6 +296,22 @@ class BaseDtu : public MemObject
 
     void printNocRequest(PacketPtr pkt, const char *type);
 
+    struct CachedBackdoor
+    {
+        MemBackdoorPtr backdoor;
+        // the latency of the access that handed out the backdoor
+        Tick latency;
+    };
+
+    void addMemBackdoor(MemBackdoorPtr backdoor, Tick latency);
+
+    const CachedBackdoor *findMemBackdoor(Addr addr, Addr size,
+                                          bool write) const;
+
+    void updateSnoopFilter(PacketPtr pkt);
+
+    bool snoopFilterMayContain(Addr addr);
+
     NocMasterPort  nocMasterPort;
 
     NocSlavePort   nocSlavePort;
@@ -305,6 +330,15 @@ class BaseDtu : public MemObject
 
     EventWrapper<BaseDtu, &BaseDtu::nocRequestFinished> nocReqFinishedEvent;
 
+    std::list<CachedBackdoor> memBackdoors;
+
+    /**
+     * Tracks the lines that the caches have fetched via the DTU, so that
+     * snoops from the NoC for other lines are not forwarded to the caches.
+     * nullptr if the filter is disabled; only used if the DTU is coherent.
+     */
+    DtuSnoopFilter *snoopFilter;
+
   public:
 
     const unsigned coreId;
@@ -315,6 +349,14 @@ class BaseDtu : public MemObject
 
     bool coherent;
 
+    const bool useMemBackdoor;
+
+    Stats::Scalar memBackdoorAccesses;
+    Stats::Scalar memBackdoorBytes;
+
+    Stats::Scalar snoopsForwarded;
+    Stats::Scalar snoopsFiltered;
+
 };
 
 #endif // __MEM_DTU_BASE_HH__
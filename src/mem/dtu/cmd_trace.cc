@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) 2016, Nils Asmussen
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#include "mem/dtu/cmd_trace.hh"
+
+#include <sstream>
+
+#include "base/logging.hh"
+#include "mem/dtu/dtu.hh"
+
+static const RegFile::reg_t RECV_DYN_MASK =
+    (static_cast<RegFile::reg_t>(0xFFF) << 48) |    // rdPos and wrPos
+    (static_cast<RegFile::reg_t>(0x3F) << 0);       // msgCount
+
+/**
+ * Clears the parts of the endpoint registers that change while the
+ * endpoint is used, so that only configuration changes are recorded.
+ */
+static std::vector<RegFile::reg_t>
+configOf(const std::vector<RegFile::reg_t> &regs)
+{
+    std::vector<RegFile::reg_t> cfg(regs);
+    EpType type = static_cast<EpType>(cfg[0] >> 61);
+    if (type == EpType::RECEIVE)
+    {
+        cfg[0] &= ~RECV_DYN_MASK;
+        cfg[2] = 0;
+    }
+    else if (type == EpType::SEND)
+    {
+        // start with full credits
+        RegFile::reg_t maxcrd = (cfg[1] >> 16) & 0xFFFF;
+        cfg[1] = (cfg[1] & ~static_cast<RegFile::reg_t>(0xFFFF)) | maxcrd;
+    }
+    return cfg;
+}
+
+CmdTraceRecorder::CmdTraceRecorder(Dtu &_dtu, const std::string &file)
+    : dtu(_dtu),
+      os(simout.create(file)),
+      eps(dtu.numEndpoints, std::vector<RegFile::reg_t>(numEpRegs)),
+      fetched(),
+      cur(),
+      pending(false),
+      issue(0),
+      polling(false),
+      pollStart(0),
+      lastEnd(0),
+      seq(0)
+{
+    *os->stream() << "# DTU command trace of " << dtu.name()
+                  << " (core " << dtu.coreId << ")\n";
+}
+
+CmdTraceRecorder::~CmdTraceRecorder()
+{
+    simout.close(os);
+}
+
+void
+CmdTraceRecorder::startCommand(RegFile::reg_t cmdValue)
+{
+    Dtu::Command::Bits cmd = cmdValue;
+
+    pending = false;
+    switch (cmd.opcode)
+    {
+        case Dtu::Command::SEND:
+        case Dtu::Command::REPLY:
+        case Dtu::Command::READ:
+        case Dtu::Command::WRITE:
+        case Dtu::Command::FETCH_MSG:
+        case Dtu::Command::ACK_MSG:
+            break;
+        default:
+            return;
+    }
+
+    cur.type = CmdTraceRecord::CMD;
+    cur.ep = cmd.epid;
+    cur.opcode = cmd.opcode;
+    cur.flags = cmd.flags;
+    cur.arg = cmd.arg;
+    cur.data = dtu.regs().getDataReg();
+    cur.offset = dtu.regs().get(CmdReg::OFFSET);
+    cur.label = dtu.regs().get(CmdReg::REPLY_LABEL);
+    cur.dep = -1;
+    issue = dtu.curCycle();
+    pending = true;
+
+    // we only know whether a FETCH_MSG was successful afterwards
+    if (cmd.opcode != Dtu::Command::FETCH_MSG)
+        writeCommand();
+}
+
+void
+CmdTraceRecorder::fetchedMessage(Addr msg)
+{
+    if (!pending)
+        return;
+
+    if (msg == 0)
+    {
+        if (!polling)
+        {
+            polling = true;
+            pollStart = dtu.curCycle();
+        }
+        pending = false;
+        return;
+    }
+
+    if (polling)
+        issue = pollStart;
+    fetched[msg] = seq;
+    writeCommand();
+}
+
+void
+CmdTraceRecorder::finishCommand()
+{
+    if (pending)
+    {
+        lastEnd = dtu.curCycle();
+        pending = false;
+    }
+}
+
+void
+CmdTraceRecorder::writeEps()
+{
+    for (unsigned ep = 0; ep < dtu.numEndpoints; ++ep)
+    {
+        std::vector<RegFile::reg_t> cfg = configOf(dtu.regs().getEpRegs(ep));
+        if (cfg == eps[ep])
+            continue;
+
+        *os->stream() << "E " << ep << std::hex
+                      << " " << cfg[0]
+                      << " " << cfg[1]
+                      << " " << cfg[2]
+                      << std::dec << "\n";
+        eps[ep] = cfg;
+    }
+}
+
+void
+CmdTraceRecorder::writeCommand()
+{
+    cur.gap = issue > lastEnd ? Cycles(issue - lastEnd) : Cycles(0);
+    polling = false;
+
+    if (cur.opcode == Dtu::Command::REPLY ||
+        cur.opcode == Dtu::Command::ACK_MSG)
+    {
+        auto it = fetched.find(cur.arg);
+        if (it != fetched.end())
+        {
+            cur.dep = it->second;
+            fetched.erase(it);
+        }
+    }
+
+    writeEps();
+
+    *os->stream() << "C " << seq
+                  << " " << cur.gap
+                  << " " << cur.opcode
+                  << " " << cur.ep
+                  << " " << cur.flags
+                  << std::hex
+                  << " " << cur.arg
+                  << " " << cur.data.addr
+                  << std::dec
+                  << " " << cur.data.size
+                  << std::hex
+                  << " " << cur.offset
+                  << " " << cur.label
+                  << std::dec
+                  << " " << cur.dep
+                  << "\n";
+    seq++;
+}
+
+CmdTraceReader::CmdTraceReader(const std::string &_file)
+    : file(_file),
+      is(_file),
+      line(0)
+{
+    fatal_if(!is, "Unable to open DTU command trace '%s'", file);
+}
+
+bool
+CmdTraceReader::next(CmdTraceRecord &rec)
+{
+    std::string str;
+    while (std::getline(is, str))
+    {
+        line++;
+        if (str.empty() || str[0] == '#')
+            continue;
+
+        std::istringstream ss(str);
+        char type;
+        ss >> type;
+        if (type == 'E')
+        {
+            rec.type = CmdTraceRecord::EP;
+            ss >> rec.ep >> std::hex
+               >> rec.regs[0] >> rec.regs[1] >> rec.regs[2];
+        }
+        else if (type == 'C')
+        {
+            uint64_t gap;
+            rec.type = CmdTraceRecord::CMD;
+            ss >> rec.seq >> gap >> rec.opcode >> rec.ep >> rec.flags
+               >> std::hex >> rec.arg >> rec.data.addr
+               >> std::dec >> rec.data.size
+               >> std::hex >> rec.offset >> rec.label
+               >> std::dec >> rec.dep;
+            rec.gap = Cycles(gap);
+        }
+        else
+            ss.setstate(std::ios::failbit);
+
+        fatal_if(ss.fail(), "%s:%u: invalid record '%s'", file, line, str);
+        return true;
+    }
+    return false;
+}
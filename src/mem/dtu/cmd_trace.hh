@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2016, Nils Asmussen
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#ifndef __MEM_DTU_CMD_TRACE_HH__
+#define __MEM_DTU_CMD_TRACE_HH__
+
+#include <fstream>
+#include <unordered_map>
+#include <vector>
+
+#include "base/output.hh"
+#include "mem/dtu/regfile.hh"
+
+class Dtu;
+
+/**
+ * A record of a DTU command trace. The trace is a text file with one
+ * record per line; lines starting with '#' are comments:
+ *
+ *   E <ep> <reg0> <reg1> <reg2>
+ *     The endpoint has been (re)configured with the given registers. The
+ *     dynamic parts (buffer positions, message counts and credits) are
+ *     reset.
+ *
+ *   C <seq> <gap> <opcode> <ep> <flags> <arg> <data> <size> <offset>
+ *     <label> <dep>
+ *     A command was issued <gap> cycles after the previous one finished,
+ *     using the given values for the COMMAND, DATA, OFFSET and REPLY_LABEL
+ *     registers. For REPLY and ACK_MSG, <dep> is the sequence number of
+ *     the FETCH_MSG command that fetched the message (-1 if unknown).
+ *
+ * Only successful FETCH_MSG commands are recorded; the time spent polling
+ * for the message is not part of the gap, so that the replay waits for the
+ * message instead.
+ */
+struct CmdTraceRecord
+{
+    enum Type
+    {
+        EP,
+        CMD,
+    };
+
+    Type type;
+    unsigned ep;
+
+    // EP records
+    RegFile::reg_t regs[numEpRegs];
+
+    // CMD records
+    uint64_t seq;
+    Cycles gap;
+    unsigned opcode;
+    unsigned flags;
+    uint64_t arg;
+    DataReg data;
+    RegFile::reg_t offset;
+    RegFile::reg_t label;
+    int64_t dep;
+};
+
+/**
+ * Records the commands a DTU executes into a command trace in the output
+ * directory, which can be replayed by DtuTraceReplay.
+ */
+class CmdTraceRecorder
+{
+  public:
+
+    CmdTraceRecorder(Dtu &dtu, const std::string &file);
+
+    ~CmdTraceRecorder();
+
+    /// called when the DTU starts the given command
+    void startCommand(RegFile::reg_t cmd);
+
+    /// called with the result of a FETCH_MSG command
+    void fetchedMessage(Addr msg);
+
+    /// called when the DTU has finished the current command
+    void finishCommand();
+
+  private:
+
+    void writeEps();
+
+    void writeCommand();
+
+    Dtu &dtu;
+
+    OutputStream *os;
+
+    /// the endpoint registers as of the last EP record
+    std::vector<std::vector<RegFile::reg_t>> eps;
+
+    /// the sequence numbers of the FETCH_MSGs by message address
+    std::unordered_map<Addr, uint64_t> fetched;
+
+    /// the current command and the cycle it was issued
+    CmdTraceRecord cur;
+    bool pending;
+    Cycles issue;
+
+    /// the cycle of the first unsuccessful FETCH_MSG, if polling
+    bool polling;
+    Cycles pollStart;
+
+    /// the cycle the last recorded command finished
+    Cycles lastEnd;
+
+    uint64_t seq;
+};
+
+/**
+ * Reads a command trace record by record.
+ */
+class CmdTraceReader
+{
+  public:
+
+    explicit CmdTraceReader(const std::string &file);
+
+    /**
+     * Reads the next record.
+     *
+     * @return false at the end of the trace
+     */
+    bool next(CmdTraceRecord &rec);
+
+  private:
+
+    const std::string file;
+
+    std::ifstream is;
+
+    unsigned line;
+};
+
+#endif
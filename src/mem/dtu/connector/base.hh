@@ -45,7 +45,10 @@ class BaseConnector : public MemObject
     virtual void wakeup() {};
     virtual void suspend() {};
 
-    virtual void reset(Addr entry, Addr rootpt) {};
+    virtual void reset(Addr entry, Addr rootpt, uint16_t vpeId) {};
+
+    // the core does not snoop the DTU's writes to the memory behind it
+    virtual void memWritten(Addr addr, Addr size) {};
 
     virtual void setIrq() {};
 
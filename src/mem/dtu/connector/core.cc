@@ -30,6 +30,7 @@
 #include "debug/DtuConnector.hh"
 #include "mem/dtu/connector/core.hh"
 #include "mem/dtu/dtu.hh"
+#include "cpu/simple/atomic.hh"
 #include "cpu/simple/base.hh"
 #include "sim/process.hh"
 
@@ -66,13 +67,17 @@ CoreConnector::suspend()
 }
 
 void
-CoreConnector::reset(Addr entry, Addr rootpt)
+CoreConnector::reset(Addr entry, Addr rootpt, uint16_t)
 {
     if (system->threadContexts.size() == 0)
         return;
 
     DPRINTF(DtuConnector, "Setting PC=%p, rootpt=%p\n", entry, rootpt);
 
+    // the DTU has probably loaded new code, potentially at the same addresses
+    if (auto cpu = atomicCpu())
+        cpu->bbCacheFlush();
+
     auto ctx = system->threadContexts[0];
     ctx->pcState(entry);
 #if THE_ISA == X86_ISA
@@ -84,6 +89,25 @@ CoreConnector::reset(Addr entry, Addr rootpt)
 #endif
 }
 
+void
+CoreConnector::memWritten(Addr addr, Addr size)
+{
+    // drop the basic blocks the core might have cached from there
+    if (auto cpu = atomicCpu())
+        cpu->bbCacheInvalidate(addr, size);
+}
+
+AtomicSimpleCPU *
+CoreConnector::atomicCpu() const
+{
+    if (system->threadContexts.size() == 0)
+        return nullptr;
+
+    // the CPU changes when switching CPUs
+    BaseCPU *cpu = system->threadContexts[0]->getCpuPtr();
+    return dynamic_cast<AtomicSimpleCPU*>(cpu);
+}
+
 CoreConnector*
 CoreConnectorParams::create()
 {
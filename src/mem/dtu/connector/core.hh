@@ -34,6 +34,8 @@
 #include "mem/dtu/connector/base.hh"
 #include "sim/system.hh"
 
+class AtomicSimpleCPU;
+
 class CoreConnector : public BaseConnector
 {
   public:
@@ -44,10 +46,14 @@ class CoreConnector : public BaseConnector
 
     void suspend() override;
 
-    void reset(Addr entry, Addr rootpt) override;
+    void reset(Addr entry, Addr rootpt, uint16_t vpeId) override;
+
+    void memWritten(Addr addr, Addr size) override;
 
   protected:
 
+    AtomicSimpleCPU *atomicCpu() const;
+
     System *system;
 };
 
@@ -40,6 +40,7 @@
 #include "debug/DtuCpuReq.hh"
 #include "debug/DtuXlate.hh"
 #include "mem/dtu/dtu.hh"
+#include "mem/dtu/cmd_trace.hh"
 #include "mem/dtu/msg_unit.hh"
 #include "mem/dtu/mem_unit.hh"
 #include "mem/dtu/xfer_unit.hh"
@@ -88,9 +89,19 @@ Dtu::Dtu(DtuParams* p)
     memUnit(new MemoryUnit(*this)),
     xferUnit(new XferUnit(*this, p->block_size, p->buf_count, p->buf_size)),
     ptUnit(p->pt_walker ? new PtUnit(*this) : NULL),
+    cmdTrace(p->cmd_trace ? new CmdTraceRecorder(*this, name() + ".cmdtrace")
+                          : NULL),
     abortCommandEvent(*this),
     completeTranslateEvent(*this),
+    spinPollEvent(*this),
     sleepStart(0),
+    spinOnCmd(),
+    spinSuspended(),
+    spinCount(0),
+    spinValue(),
+    spinLastRead(0),
+    spinStart(0),
+    spinPkt(),
     cmdPkt(),
     cmdFinish(),
     cmdId(0),
@@ -110,6 +121,9 @@ Dtu::Dtu(DtuParams* p)
     reqCount(p->req_count),
     cacheBlocksPerCycle(p->cache_blocks_per_cycle),
     registerAccessLatency(p->register_access_latency),
+    spinPollThreshold(p->spin_poll_threshold),
+    spinPollWindow(p->spin_poll_window),
+    spinPollMaxCycles(p->spin_poll_timeout),
     cpuToCacheLatency(p->cpu_to_cache_latency),
     commandToNocRequestLatency(p->command_to_noc_request_latency),
     startMsgTransferDelay(p->start_msg_transfer_delay),
@@ -140,6 +154,7 @@ Dtu::Dtu(DtuParams* p)
 
 Dtu::~Dtu()
 {
+    delete cmdTrace;
     delete ptUnit;
     delete xferUnit;
     delete memUnit;
@@ -178,6 +193,16 @@ Dtu::regStats()
         .name(name() + ".resets")
         .desc("Number of resets");
 
+    spinPollSuspends
+        .name(name() + ".spinPollSuspends")
+        .desc("Number of times the core was suspended in a polling loop");
+    spinPollTimeouts
+        .name(name() + ".spinPollTimeouts")
+        .desc("Number of polling suspends ended by the timeout");
+    spinPollCycles
+        .name(name() + ".spinPollCycles")
+        .desc("Number of cycles the core was suspended in polling loops");
+
     commands
         .init(sizeof(cmdNames) / sizeof(cmdNames[0]))
         .name(name() + ".commands")
@@ -267,6 +292,9 @@ Dtu::executeCommand(PacketPtr pkt)
             cmdNames[static_cast<size_t>(cmd.opcode)], cmd.epid,
             cmd.flags, cmd.arg, cmdId);
 
+    if (cmdTrace)
+        cmdTrace->startCommand(cmd);
+
     switch (cmd.opcode)
     {
         case Command::SEND:
@@ -280,9 +308,14 @@ Dtu::executeCommand(PacketPtr pkt)
             memUnit->startWrite(cmd);
             break;
         case Command::FETCH_MSG:
-            regs().set(CmdReg::OFFSET, msgUnit->fetchMessage(cmd.epid));
+        {
+            Addr msg = msgUnit->fetchMessage(cmd.epid);
+            regs().set(CmdReg::OFFSET, msg);
+            if (cmdTrace)
+                cmdTrace->fetchedMessage(msg);
             finishCommand(Error::NONE);
-            break;
+        }
+        break;
         case Command::ACK_MSG:
             msgUnit->ackMessage(cmd.epid, cmd.arg);
             finishCommand(Error::NONE);
@@ -442,6 +475,9 @@ Dtu::finishCommand(Error error)
     if (cmd.opcode == Command::SLEEP)
         stopSleep();
 
+    if (cmdTrace)
+        cmdTrace->finishCommand();
+
     DPRINTF(DtuCmd, "Finished command %s with EP=%u, flags=%#x (id=%llu) -> %u\n",
             cmdNames[static_cast<size_t>(cmd.opcode)], cmd.epid, cmd.flags,
             cmdId, static_cast<uint>(error));
@@ -584,10 +620,137 @@ Dtu::wakeupCore()
         val &= ~static_cast<RegFile::reg_t>(Features::IRQ_WAKEUP);
         regs().set(DtuReg::FEATURES, val);
 
+        stopSpinPoll();
         connector->wakeup();
     }
 }
 
+bool
+Dtu::detectSpinPoll(PacketPtr pkt, Addr regAddr)
+{
+    if (spinPollThreshold == 0)
+        return false;
+
+    const Addr msgCntAddr = sizeof(RegFile::reg_t) *
+                            static_cast<Addr>(DtuReg::MSG_CNT);
+    const Addr cmdAddr = sizeof(RegFile::reg_t) *
+                         (numDtuRegs + static_cast<Addr>(CmdReg::COMMAND));
+
+    // every other register access breaks the polling loop
+    if (!pkt->isRead() || pkt->getSize() != sizeof(RegFile::reg_t) ||
+        (regAddr != msgCntAddr && regAddr != cmdAddr))
+    {
+        spinCount = 0;
+        return false;
+    }
+
+    bool onCmd = regAddr == cmdAddr;
+    RegFile::reg_t value = *pkt->getConstPtr<RegFile::reg_t>();
+    Cycles now = curCycle();
+
+    if (spinCount == 0 || onCmd != spinOnCmd || value != spinValue ||
+        now - spinLastRead > spinPollWindow)
+    {
+        spinOnCmd = onCmd;
+        spinValue = value;
+        spinCount = 1;
+        spinLastRead = now;
+        return false;
+    }
+
+    spinLastRead = now;
+    if (++spinCount < spinPollThreshold)
+        return false;
+
+    // don't suspend if there is a request for the core pending
+    if (regFile.get(ReqReg::EXT_REQ) != 0 ||
+        regFile.get(ReqReg::XLATE_REQ) != 0)
+        return false;
+
+    return true;
+}
+
+RegFile::reg_t
+Dtu::spinPollValue()
+{
+    if (spinOnCmd)
+        return regFile.get(CmdReg::COMMAND);
+    return regFile.get(DtuReg::MSG_CNT);
+}
+
+void
+Dtu::startSpinPoll(PacketPtr pkt)
+{
+    assert(!spinSuspended);
+
+    spinSuspended = true;
+    spinStart = curCycle();
+    // in timing mode, the read blocks until the register changes
+    spinPkt = pkt;
+
+    spinPollSuspends++;
+
+    DPRINTF(Dtu, "Suspending CU after %u reads of %s=%#llx\n",
+        spinCount, spinOnCmd ? "COMMAND" : "MSG_CNT", spinValue);
+    connector->suspend();
+
+    if (spinPollMaxCycles != 0)
+        schedule(spinPollEvent, clockEdge(spinPollMaxCycles));
+}
+
+void
+Dtu::checkSpinPoll()
+{
+    // the register has changed, so let the core see the new value
+    if (spinSuspended && spinPollValue() != spinValue)
+        reschedule(spinPollEvent, clockEdge(Cycles(1)), true);
+}
+
+void
+Dtu::spinPollTimeout()
+{
+    if (spinPollValue() == spinValue)
+        spinPollTimeouts++;
+
+    stopSpinPoll();
+}
+
+void
+Dtu::stopSpinPoll()
+{
+    if (!spinSuspended)
+        return;
+
+    Cycles cycles = curCycle() - spinStart;
+    PacketPtr pkt = spinPkt;
+    cancelSpinPoll();
+
+    DPRINTF(Dtu, "Waking up CU after %llu polling cycles\n",
+        static_cast<uint64_t>(cycles));
+    connector->wakeup();
+
+    if (pkt)
+    {
+        *pkt->getPtr<RegFile::reg_t>() = spinPollValue();
+        schedCpuResponse(pkt, clockEdge(registerAccessLatency));
+    }
+}
+
+void
+Dtu::cancelSpinPoll()
+{
+    spinCount = 0;
+    if (!spinSuspended)
+        return;
+
+    if (spinPollEvent.scheduled())
+        deschedule(spinPollEvent);
+
+    spinPollCycles += curCycle() - spinStart;
+    spinSuspended = false;
+    spinPkt = nullptr;
+}
+
 Cycles
 Dtu::reset(Addr entry, bool flushInval)
 {
@@ -603,10 +766,14 @@ Dtu::reset(Addr entry, bool flushInval)
     if (tlb())
         tlb()->clear();
 
+    // the core starts from scratch and does not wait for the response to
+    // the register read it was suspended in
+    cancelSpinPoll();
+
     regs().resetHeader();
 
     Addr rootpt = ptUnit ? 0 : nocToPhys(regs().get(DtuReg::ROOT_PT));
-    connector->reset(entry, rootpt);
+    connector->reset(entry, rootpt, regs().get(DtuReg::VPE_ID));
 
     // since we did a reset & suspend, restart the sleep
     sleepStart = curCycle();
@@ -719,6 +886,11 @@ Dtu::sendMemRequest(PacketPtr pkt,
 
     pkt->pushSenderState(senderState);
 
+    // the core only caches code in atomic mode, so that it's enough to tell
+    // it about the write when issuing the request
+    if (pkt->isWrite())
+        memWritten(pkt->getAddr(), pkt->getSize());
+
     if (atomicMode)
     {
         sendAtomicMemRequest(pkt);
@@ -1293,6 +1465,26 @@ Dtu::translate(PtUnit::Translation *trans,
     }
 }
 
+void
+Dtu::warmTlb(Addr virt, uint access)
+{
+    if (!ptUnit || !tlb())
+        return;
+
+    NocAddr phys;
+    DtuTlb::Result res = tlb()->lookup(virt, access, &phys);
+    if (res != DtuTlb::MISS)
+        return;
+
+    uint flags;
+    if (ptUnit->translateFunctional(virt, access, &phys, &flags))
+    {
+        tlb()->insert(virt & ~DtuTlb::PAGE_MASK, phys, flags);
+        // insert does not touch the LRU state
+        tlb()->lookup(virt, access, &phys);
+    }
+}
+
 void
 Dtu::forwardRequestToRegFile(PacketPtr pkt, bool isCpuRequest)
 {
@@ -1305,6 +1497,8 @@ Dtu::forwardRequestToRegFile(PacketPtr pkt, bool isCpuRequest)
 
     regFileReqs++;
 
+    bool spinning = isCpuRequest && detectSpinPoll(pkt, pkt->getAddr());
+
     // restore old address
     pkt->setAddr(oldAddr);
 
@@ -1330,7 +1524,9 @@ Dtu::forwardRequestToRegFile(PacketPtr pkt, bool isCpuRequest)
             pkt->headerDelay = 0;
             pkt->payloadDelay = 0;
 
-            if (isCpuRequest && (~result & RegFile::WROTE_CMD))
+            if (spinning)
+                startSpinPoll(pkt);
+            else if (isCpuRequest && (~result & RegFile::WROTE_CMD))
                 schedCpuResponse(pkt, when);
             else if(!isCpuRequest)
                 schedNocResponse(pkt, when);
@@ -1363,6 +1559,9 @@ Dtu::forwardRequestToRegFile(PacketPtr pkt, bool isCpuRequest)
             setIrq();
         if (result & RegFile::WROTE_CLEAR_IRQ)
             clearIrq();
+        // the core has already got the old value and polls again on wakeup
+        if (spinning)
+            startSpinPoll(nullptr);
     }
 }
 
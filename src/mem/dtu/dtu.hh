@@ -41,6 +41,7 @@
 class MessageUnit;
 class MemoryUnit;
 class XferUnit;
+class CmdTraceRecorder;
 
 class Dtu : public BaseDtu
 {
@@ -201,6 +202,15 @@ class Dtu : public BaseDtu
 
     DtuTlb *tlb() { return tlBuf; }
 
+    /**
+     * Makes sure that the TLB holds the translation for the given page and
+     * marks it as most recently used (functional warming).
+     *
+     * @param virt the virtual address
+     * @param access the required access permissions (DtuTlb::Flag)
+     */
+    void warmTlb(Addr virt, uint access);
+
     bool isMemPE(unsigned pe) const;
 
     PacketPtr generateRequest(Addr addr, Addr size, MemCmd cmd);
@@ -214,6 +224,8 @@ class Dtu : public BaseDtu
 
     void wakeupCore();
 
+    void checkSpinPoll();
+
     Cycles reset(Addr entry, bool flushInval);
 
     Cycles flushInvalCaches(bool invalidate);
@@ -229,9 +241,18 @@ class Dtu : public BaseDtu
         // set our master id (it might be from a different PE)
         pkt->req->setMasterId(masterId);
 
+        if (pkt->isWrite())
+            memWritten(pkt->getAddr(), pkt->getSize());
+
         dcacheMasterPort.sendFunctional(pkt);
     }
 
+    // the core can't snoop our writes to its memory, so tell it explicitly
+    void memWritten(Addr addr, Addr size)
+    {
+        connector->memWritten(addr, size);
+    }
+
     void scheduleFinishOp(Cycles delay, Error error = Error::NONE);
 
     void sendMemRequest(PacketPtr pkt,
@@ -284,6 +305,18 @@ class Dtu : public BaseDtu
 
     void finishCommand(Error error);
 
+    bool detectSpinPoll(PacketPtr pkt, Addr regAddr);
+
+    RegFile::reg_t spinPollValue();
+
+    void startSpinPoll(PacketPtr pkt);
+
+    void stopSpinPoll();
+
+    void cancelSpinPoll();
+
+    void spinPollTimeout();
+
     void completeNocRequest(PacketPtr pkt) override;
 
     void completeMemRequest(PacketPtr pkt) override;
@@ -327,10 +360,14 @@ class Dtu : public BaseDtu
 
     PtUnit *ptUnit;
 
+    CmdTraceRecorder *cmdTrace;
+
     EventWrapper<Dtu, &Dtu::abortCommand> abortCommandEvent;
 
     EventWrapper<Dtu, &Dtu::completeTranslate> completeTranslateEvent;
 
+    EventWrapper<Dtu, &Dtu::spinPollTimeout> spinPollEvent;
+
     struct DtuEvent : public Event
     {
         Dtu& dtu;
@@ -426,6 +463,16 @@ class Dtu : public BaseDtu
     };
 
     Cycles sleepStart;
+
+    // state of the spin-poll detection
+    bool spinOnCmd;
+    bool spinSuspended;
+    unsigned spinCount;
+    RegFile::reg_t spinValue;
+    Cycles spinLastRead;
+    Cycles spinStart;
+    PacketPtr spinPkt;
+
     PacketPtr cmdPkt;
     FinishCommandEvent *cmdFinish;
     uint64_t cmdId;
@@ -460,6 +507,10 @@ class Dtu : public BaseDtu
 
     const Cycles registerAccessLatency;
 
+    const unsigned spinPollThreshold;
+    const Cycles spinPollWindow;
+    const Cycles spinPollMaxCycles;
+
     const Cycles cpuToCacheLatency;
 
     const Cycles commandToNocRequestLatency;
@@ -481,6 +532,11 @@ class Dtu : public BaseDtu
     Stats::Scalar irqInjects;
     Stats::Scalar resets;
 
+    // spin-poll detection
+    Stats::Scalar spinPollSuspends;
+    Stats::Scalar spinPollTimeouts;
+    Stats::Scalar spinPollCycles;
+
     // core translations
     Stats::Scalar xlateReqs;
     Stats::Scalar xlateDelays;
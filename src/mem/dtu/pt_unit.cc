@@ -166,9 +166,11 @@ PtUnit::TranslateEvent::finish(bool success, const NocAddr &addr)
 }
 
 bool
-PtUnit::translateFunctional(Addr virt, uint access, NocAddr *phys)
+PtUnit::translateFunctional(Addr virt, uint access, NocAddr *phys,
+                            uint *flags)
 {
     Addr ptePhys;
+    uint pteFlags = access;
     Addr ptAddr = dtu.regs().get(DtuReg::ROOT_PT);
     for (int level = DtuTlb::LEVEL_CNT - 1; level >= 0; --level)
     {
@@ -178,13 +180,15 @@ PtUnit::translateFunctional(Addr virt, uint access, NocAddr *phys)
 
         dtu.sendFunctionalMemRequest(pkt);
 
-        uint acccopy = access;
-        if (!finishTranslate(pkt, virt, level, &acccopy, &ptePhys))
+        pteFlags = access;
+        if (!finishTranslate(pkt, virt, level, &pteFlags, &ptePhys))
             return false;
 
         ptAddr = ptePhys;
     }
     *phys = NocAddr(ptePhys + (virt & DtuTlb::PAGE_MASK));
+    if (flags)
+        *flags = pteFlags;
     return true;
 }
 
@@ -134,7 +134,8 @@ class PtUnit
 
     void regStats();
 
-    bool translateFunctional(Addr virt, uint access, NocAddr *phys);
+    bool translateFunctional(Addr virt, uint access, NocAddr *phys,
+                             uint *flags = nullptr);
 
     void startTranslate(Addr virt, uint access, Translation *trans);
 
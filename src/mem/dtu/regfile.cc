@@ -159,6 +159,9 @@ RegFile::set(DtuReg reg, reg_t value, RegAccess access)
                          value);
 
     dtuRegs[static_cast<Addr>(reg)] = value;
+
+    if (reg == DtuReg::MSG_CNT)
+        dtu.checkSpinPoll();
 }
 
 RegFile::reg_t
@@ -207,6 +210,9 @@ RegFile::set(CmdReg reg, reg_t value, RegAccess access)
                          value);
 
     cmdRegs[static_cast<Addr>(reg)] = value;
+
+    if (reg == CmdReg::COMMAND)
+        dtu.checkSpinPoll();
 }
 
 EpType
@@ -309,6 +309,11 @@ class RegFile
 
     MemEp getMemEp(unsigned epId, bool print = true) const;
 
+    const std::vector<reg_t> &getEpRegs(unsigned epId) const
+    {
+        return epRegs[epId];
+    }
+
     const ReplyHeader &getHeader(size_t idx, RegAccess access) const;
 
     void setHeader(size_t idx, RegAccess access, const ReplyHeader &hd);
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2015, Christian Menard
+ * Copyright (c) 2015, Nils Asmussen
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#include "mem/dtu/snoop_filter.hh"
+
+#include "base/intmath.hh"
+#include "base/logging.hh"
+#include "mem/ruby/filters/H3BloomFilter.hh"
+#include "mem/ruby/filters/LSB_CountingBloomFilter.hh"
+#include "mem/ruby/system/RubySystem.hh"
+
+DtuSnoopFilter::DtuSnoopFilter(Enums::DtuSnoopFilter type,
+                               unsigned size,
+                               unsigned hashes,
+                               unsigned max_count,
+                               unsigned line_size)
+    : filter(),
+      counting(type == Enums::counting),
+      maxCount(max_count),
+      lineSizeBits(floorLog2(line_size))
+{
+    if (counting)
+        filter = new LSB_CountingBloomFilter(size, maxCount);
+    else
+    {
+        assert(type == Enums::h3);
+        fatal_if(hashes > 16, "The H3 snoop filter supports at most 16 hashes");
+        filter = new H3BloomFilter(size, hashes, false);
+    }
+}
+
+DtuSnoopFilter::~DtuSnoopFilter()
+{
+    delete filter;
+}
+
+bool
+DtuSnoopFilter::allocatesLine(PacketPtr pkt)
+{
+    // the caches allocate lines when they receive the response. thus, every
+    // cacheable request with a response can give a cache a copy of the line:
+    // reads, ReadEx and SCUpgradeFail (also for prefetches) as well as
+    // whole-line writes, which the caches send as InvalidateReq or
+    // WriteLineReq. upgrades don't, because a cache already holds the line,
+    // and neither does cache maintenance. inserting too many lines only
+    // leaves stale positives, which are safe.
+    return pkt->needsResponse() &&
+           !pkt->req->isUncacheable() &&
+           !pkt->isUpgrade() &&
+           !pkt->isClean();
+}
+
+Addr
+DtuSnoopFilter::key(Addr addr) const
+{
+    // the Ruby filters ignore the lowest RubySystem::getBlockSizeBits() bits
+    // (0 without Ruby). thus, we pass them our line number, shifted by these
+    // bits, so that our line size decides which lines share an entry.
+    return (addr >> lineSizeBits) << RubySystem::getBlockSizeBits();
+}
+
+void
+DtuSnoopFilter::update(PacketPtr pkt)
+{
+    Addr line = key(pkt->getAddr());
+
+    // note that we insert the line even if the request fails, because the
+    // cache receives a dummy response in this case.
+    if (allocatesLine(pkt))
+    {
+        if (counting)
+            filter->increment(line);
+        else
+            filter->set(line);
+    }
+    // the line leaves the cache hierarchy, unless a cache above still has it
+    else if (pkt->isEviction() && !pkt->isBlockCached() && counting)
+    {
+        // saturated counters stay set, because we lost track of how many
+        // lines they represent
+        if (filter->getCount(line) < maxCount)
+            filter->decrement(line);
+    }
+}
+
+bool
+DtuSnoopFilter::mayContain(Addr addr)
+{
+    return filter->getCount(key(addr)) > 0;
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2015, Christian Menard
+ * Copyright (c) 2015, Nils Asmussen
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#ifndef __MEM_DTU_SNOOP_FILTER_HH__
+#define __MEM_DTU_SNOOP_FILTER_HH__
+
+#include "base/types.hh"
+#include "enums/DtuSnoopFilter.hh"
+#include "mem/packet.hh"
+#include "mem/ruby/filters/AbstractBloomFilter.hh"
+
+/**
+ * Tracks the lines that the caches of a PE have fetched via the DTU, so that
+ * snoops from the NoC for other lines don't need to be forwarded to the
+ * caches. The filter may report lines that are no longer cached, but never
+ * misses a cached line.
+ */
+class DtuSnoopFilter
+{
+  public:
+
+    /**
+     * @param type the filter to use (h3 or counting)
+     * @param size the number of entries (power of 2)
+     * @param hashes the number of hash functions (h3 only)
+     * @param max_count the maximum value of a counter (counting only)
+     * @param line_size the cache line size in bytes
+     */
+    DtuSnoopFilter(Enums::DtuSnoopFilter type,
+                   unsigned size,
+                   unsigned hashes,
+                   unsigned max_count,
+                   unsigned line_size);
+
+    ~DtuSnoopFilter();
+
+    /**
+     * Updates the filter for a request that the caches sent to memory.
+     */
+    void update(PacketPtr pkt);
+
+    /**
+     * @return false if the line of <addr> is definitely not cached
+     */
+    bool mayContain(Addr addr);
+
+  private:
+
+    static bool allocatesLine(PacketPtr pkt);
+
+    Addr key(Addr addr) const;
+
+    AbstractBloomFilter *filter;
+
+    const bool counting;
+
+    const int maxCount;
+
+    const unsigned lineSizeBits;
+};
+
+#endif // __MEM_DTU_SNOOP_FILTER_HH__
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2015, Christian Menard
+ * Copyright (c) 2015, Nils Asmussen
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+#include "mem/dtu/snoop_filter.hh"
+#include "mem/ruby/system/RubySystem.hh"
+
+// there is no RubySystem in this test, but the filters use its block size.
+// choose one that differs from the cache line size, because the filter has
+// to work independent of it.
+uint32_t RubySystem::m_block_size_bytes = 128;
+uint32_t RubySystem::m_block_size_bits = 7;
+
+static const unsigned LINE_SIZE = 64;
+
+// passes a request of the caches for the line at <addr> to the filter
+static void
+request(DtuSnoopFilter &sf, MemCmd cmd, Addr addr,
+        Request::Flags flags = 0, bool block_cached = false)
+{
+    auto req = std::make_shared<Request>(addr, LINE_SIZE, flags, 0, 0);
+    Packet pkt(req, cmd);
+    if (block_cached)
+        pkt.setBlockCached();
+    sf.update(&pkt);
+}
+
+// A whole-line write allocates the line without reading it. Snoops of
+// remote reads for it have to reach the cache that holds the dirty line.
+TEST(DtuSnoopFilterTest, WholeLineWriteH3)
+{
+    DtuSnoopFilter sf(Enums::h3, 4096, 4, 0, LINE_SIZE);
+    EXPECT_FALSE(sf.mayContain(0x1000));
+
+    request(sf, MemCmd::InvalidateReq, 0x1000);
+    EXPECT_TRUE(sf.mayContain(0x1000));
+    EXPECT_TRUE(sf.mayContain(0x1020));
+}
+
+TEST(DtuSnoopFilterTest, WholeLineWriteCounting)
+{
+    DtuSnoopFilter sf(Enums::counting, 4096, 0, 15, LINE_SIZE);
+    EXPECT_FALSE(sf.mayContain(0x1000));
+
+    request(sf, MemCmd::InvalidateReq, 0x1000);
+    EXPECT_TRUE(sf.mayContain(0x1000));
+
+    request(sf, MemCmd::WritebackDirty, 0x1000);
+    EXPECT_FALSE(sf.mayContain(0x1000));
+}
+
+// The eviction of a line must not hide another line with the same counter
+TEST(DtuSnoopFilterTest, AliasedEviction)
+{
+    DtuSnoopFilter sf(Enums::counting, 16, 0, 15, LINE_SIZE);
+    const Addr a = 0x1000, b = a + 16 * LINE_SIZE;
+
+    request(sf, MemCmd::ReadSharedReq, a);
+    request(sf, MemCmd::InvalidateReq, b);
+    request(sf, MemCmd::WritebackDirty, b);
+    EXPECT_TRUE(sf.mayContain(a));
+
+    request(sf, MemCmd::WritebackClean, a);
+    EXPECT_FALSE(sf.mayContain(b));
+}
+
+// All requests that give a cache a copy of the line insert it
+TEST(DtuSnoopFilterTest, Allocating)
+{
+    MemCmd::Command cmds[] = {
+        MemCmd::ReadSharedReq, MemCmd::ReadCleanReq, MemCmd::ReadExReq,
+        MemCmd::SCUpgradeFailReq, MemCmd::HardPFReq, MemCmd::WriteLineReq,
+        MemCmd::InvalidateReq,
+    };
+    for (auto cmd : cmds)
+    {
+        DtuSnoopFilter sf(Enums::counting, 4096, 0, 15, LINE_SIZE);
+        request(sf, cmd, 0x1000);
+        EXPECT_TRUE(sf.mayContain(0x1000)) << MemCmd(cmd).toString();
+    }
+}
+
+TEST(DtuSnoopFilterTest, NonAllocating)
+{
+    MemCmd::Command cmds[] = {
+        MemCmd::UpgradeReq, MemCmd::CleanSharedReq, MemCmd::CleanInvalidReq,
+        MemCmd::WriteClean, MemCmd::CleanEvict,
+    };
+    for (auto cmd : cmds)
+    {
+        DtuSnoopFilter sf(Enums::counting, 4096, 0, 15, LINE_SIZE);
+        request(sf, cmd, 0x1000);
+        EXPECT_FALSE(sf.mayContain(0x1000)) << MemCmd(cmd).toString();
+    }
+
+    DtuSnoopFilter sf(Enums::counting, 4096, 0, 15, LINE_SIZE);
+    request(sf, MemCmd::ReadReq, 0x1000, Request::UNCACHEABLE);
+    EXPECT_FALSE(sf.mayContain(0x1000));
+}
+
+// An eviction doesn't remove the line if a cache above still has it
+TEST(DtuSnoopFilterTest, BlockCached)
+{
+    DtuSnoopFilter sf(Enums::counting, 4096, 0, 15, LINE_SIZE);
+    request(sf, MemCmd::ReadSharedReq, 0x1000);
+    request(sf, MemCmd::WritebackClean, 0x1000, 0, true);
+    EXPECT_TRUE(sf.mayContain(0x1000));
+}
+
+// Adjacent lines get their own entries, although they are in the same block
+// of the RubySystem
+TEST(DtuSnoopFilterTest, AdjacentLines)
+{
+    DtuSnoopFilter h3(Enums::h3, 4096, 4, 0, LINE_SIZE);
+    DtuSnoopFilter counting(Enums::counting, 4096, 0, 15, LINE_SIZE);
+
+    request(h3, MemCmd::ReadSharedReq, 0x1000);
+    request(counting, MemCmd::ReadSharedReq, 0x1000);
+    EXPECT_FALSE(h3.mayContain(0x1040));
+    EXPECT_FALSE(counting.mayContain(0x1040));
+}
@@ -128,6 +128,8 @@ class DtuTlb
 
     void clear();
 
+    size_t capacity() const { return num; }
+
   private:
 
     DtuTlb::Result do_lookup(Addr virt, uint access, NocAddr *phys, bool xlate);
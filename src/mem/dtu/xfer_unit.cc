@@ -28,6 +28,7 @@
  * policies, either expressed or implied, of the FreeBSD Project.
  */
 
+#include "base/intmath.hh"
 #include "debug/Dtu.hh"
 #include "debug/DtuBuf.hh"
 #include "debug/DtuPackets.hh"
@@ -171,6 +172,13 @@ XferUnit::TransferEvent::process()
         return;
     }
 
+    // the last part has been transferred via a backdoor
+    if (remaining == 0)
+    {
+        xfer->recvMemResponse(id, NULL);
+        return;
+    }
+
     NocAddr phys(local);
     if (xfer->dtu.tlb() && !(flags() & NOXLATE))
     {
@@ -235,6 +243,50 @@ XferUnit::TransferEvent::translateDone(bool success, const NocAddr &phys)
     physAddr = xfer->dtu.nocToPhys(physAddr);
     physAddr += local & DtuTlb::PAGE_MASK;
 
+    // in atomic mode, we can transfer the whole page at once if the local
+    // memory provides a backdoor. we only do that if no memory request is
+    // in flight, because these complete in order.
+    if (xfer->dtu.atomicMode && freeSlots == xfer->dtu.reqCount)
+    {
+        uint8_t *bufData = buf->bytes + buf->offset;
+        assert(buf->offset + pageRemaining <= xfer->bufSize);
+
+        Tick memLat;
+        if (xfer->dtu.accessMemBackdoor(physAddr, bufData,
+                                        pageRemaining, isWrite(), memLat))
+        {
+            if (isWrite())
+                xfer->dtu.memWritten(physAddr, pageRemaining);
+
+            // charge the same time as one memory request per block, issued
+            // one after another
+            Addr localOff = local & (xfer->blockSize - 1);
+            Addr blocks = divCeil(localOff + pageRemaining, xfer->blockSize);
+            Cycles perBlock = xfer->dtu.transferToMemRequestLatency +
+                              xfer->dtu.ticksToCycles(memLat);
+            Cycles delay(blocks * perBlock);
+
+            DPRINTFS(DtuXfers, (&xfer->dtu),
+                "buf%d: %s %lu bytes @ %p->%p in local memory via backdoor "
+                "(%lu cycles)\n",
+                buf->id,
+                isWrite() ? "Wrote" : "Read",
+                pageRemaining,
+                local,
+                physAddr,
+                (uint64_t)delay);
+
+            local += pageRemaining;
+            buf->offset += pageRemaining;
+            remaining -= pageRemaining;
+
+            // continue with the next page or finish the transfer after
+            // the delay (see process())
+            xfer->dtu.schedule(this, xfer->dtu.clockEdge(delay));
+            return;
+        }
+    }
+
     while(freeSlots > 0 && pageRemaining > 0)
     {
         Addr localOff = local & (xfer->blockSize - 1);
@@ -53,7 +53,8 @@ bool HMCController::recvTimingReq(PacketPtr pkt, PortID slave_port_id)
 
     // test if the layer should be considered occupied for the current
     // port
-    if (!reqLayers[master_port_id]->tryTiming(src_port)) {
+    ReqLayer *layer = selectLayer(reqLayers, master_port_id, pkt->getAddr());
+    if (!layer->tryTiming(src_port)) {
         DPRINTF(HMCController, "recvTimingReq: src %s %s 0x%x BUSY\n",
                 src_port->name(), pkt->cmdString(), pkt->getAddr());
         return false;
@@ -95,8 +96,7 @@ bool HMCController::recvTimingReq(PacketPtr pkt, PortID slave_port_id)
         pkt->headerDelay = old_header_delay;
 
         // occupy until the header is sent
-        reqLayers[master_port_id]->failedTiming(src_port,
-                                                clockEdge(Cycles(1)));
+        layer->failedTiming(src_port, clockEdge(Cycles(1)));
 
         return false;
     }
@@ -107,7 +107,7 @@ bool HMCController::recvTimingReq(PacketPtr pkt, PortID slave_port_id)
         routeTo[pkt->req] = slave_port_id;
     }
 
-    reqLayers[master_port_id]->succeededTiming(packetFinishTime);
+    layer->succeededTiming(packetFinishTime);
 
     // stats updates
     pktCount[slave_port_id][master_port_id]++;
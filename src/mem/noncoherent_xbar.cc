@@ -64,8 +64,7 @@ NoncoherentXBar::NoncoherentXBar(const NoncoherentXBarParams *p)
         std::string portName = csprintf("%s.master[%d]", name(), i);
         MasterPort* bp = new NoncoherentXBarMasterPort(portName, *this, i);
         masterPorts.push_back(bp);
-        reqLayers.push_back(new ReqLayer(*bp, *this,
-                                         csprintf(".reqLayer%d", i)));
+        createLayers(reqLayers, *bp, ".reqLayer", i);
     }
 
     // see if we have a default slave device connected and if so add
@@ -76,8 +75,7 @@ NoncoherentXBar::NoncoherentXBar(const NoncoherentXBarParams *p)
         MasterPort* bp = new NoncoherentXBarMasterPort(portName, *this,
                                                       defaultPortID);
         masterPorts.push_back(bp);
-        reqLayers.push_back(new ReqLayer(*bp, *this, csprintf(".reqLayer%d",
-                                                              defaultPortID)));
+        createLayers(reqLayers, *bp, ".reqLayer", defaultPortID);
     }
 
     // create the slave ports, once again starting at zero
@@ -85,8 +83,7 @@ NoncoherentXBar::NoncoherentXBar(const NoncoherentXBarParams *p)
         std::string portName = csprintf("%s.slave[%d]", name(), i);
         QueuedSlavePort* bp = new NoncoherentXBarSlavePort(portName, *this, i);
         slavePorts.push_back(bp);
-        respLayers.push_back(new RespLayer(*bp, *this,
-                                           csprintf(".respLayer%d", i)));
+        createLayers(respLayers, *bp, ".respLayer", i);
     }
 }
 
@@ -113,7 +110,9 @@ NoncoherentXBar::recvTimingReq(PacketPtr pkt, PortID slave_port_id)
 
     // test if the layer should be considered occupied for the current
     // port
-    if (!reqLayers[master_port_id]->tryTiming(src_port)) {
+    ReqLayer *layer = selectLayer(reqLayers, master_port_id,
+                                  pkt->getAddr());
+    if (!layer->tryTiming(src_port)) {
         DPRINTF(NoncoherentXBar, "recvTimingReq: src %s %s 0x%x BUSY\n",
                 src_port->name(), pkt->cmdString(), pkt->getAddr());
         return false;
@@ -155,8 +154,7 @@ NoncoherentXBar::recvTimingReq(PacketPtr pkt, PortID slave_port_id)
         pkt->headerDelay = old_header_delay;
 
         // occupy until the header is sent
-        reqLayers[master_port_id]->failedTiming(src_port,
-                                                clockEdge(Cycles(1)));
+        layer->failedTiming(src_port, clockEdge(Cycles(1)));
 
         return false;
     }
@@ -167,7 +165,7 @@ NoncoherentXBar::recvTimingReq(PacketPtr pkt, PortID slave_port_id)
         routeTo[pkt->req] = slave_port_id;
     }
 
-    reqLayers[master_port_id]->succeededTiming(packetFinishTime);
+    layer->succeededTiming(packetFinishTime);
 
     // stats updates
     pktCount[slave_port_id][master_port_id]++;
@@ -188,11 +186,13 @@ NoncoherentXBar::recvTimingResp(PacketPtr pkt, PortID master_port_id)
     assert(route_lookup != routeTo.end());
     const PortID slave_port_id = route_lookup->second;
     assert(slave_port_id != InvalidPortID);
-    assert(slave_port_id < respLayers.size());
+    assert(slave_port_id < slavePorts.size());
 
     // test if the layer should be considered occupied for the current
     // port
-    if (!respLayers[slave_port_id]->tryTiming(src_port)) {
+    RespLayer *layer = selectLayer(respLayers, slave_port_id,
+                                   pkt->getAddr());
+    if (!layer->tryTiming(src_port)) {
         DPRINTF(NoncoherentXBar, "recvTimingResp: src %s %s 0x%x BUSY\n",
                 src_port->name(), pkt->cmdString(), pkt->getAddr());
         return false;
@@ -224,7 +224,7 @@ NoncoherentXBar::recvTimingResp(PacketPtr pkt, PortID master_port_id)
     // remove the request from the routing table
     routeTo.erase(route_lookup);
 
-    respLayers[slave_port_id]->succeededTiming(packetFinishTime);
+    layer->succeededTiming(packetFinishTime);
 
     // stats updates
     pktCount[slave_port_id][master_port_id]++;
@@ -240,11 +240,12 @@ NoncoherentXBar::recvReqRetry(PortID master_port_id)
     // responses never block on forwarding them, so the retry will
     // always be coming from a port to which we tried to forward a
     // request
-    reqLayers[master_port_id]->recvRetry();
+    retryLayer(reqLayers, master_port_id);
 }
 
 Tick
-NoncoherentXBar::recvAtomic(PacketPtr pkt, PortID slave_port_id)
+NoncoherentXBar::recvAtomicBackdoor(PacketPtr pkt, PortID slave_port_id,
+                                    MemBackdoorPtr *backdoor)
 {
     DPRINTF(NoncoherentXBar, "recvAtomic: packet src %s addr 0x%x cmd %s\n",
             slavePorts[slave_port_id]->name(), pkt->getAddr(),
@@ -263,7 +264,9 @@ NoncoherentXBar::recvAtomic(PacketPtr pkt, PortID slave_port_id)
     transDist[pkt_cmd]++;
 
     // forward the request to the appropriate destination
-    Tick response_latency = masterPorts[master_port_id]->sendAtomic(pkt);
+    auto master = masterPorts[master_port_id];
+    Tick response_latency = backdoor ?
+        master->sendAtomicBackdoor(pkt, *backdoor) : master->sendAtomic(pkt);
 
     // add the response data
     if (pkt->isResponse()) {
@@ -51,6 +51,7 @@
 #define __MEM_PORT_HH__
 
 #include "base/addr_range.hh"
+#include "mem/backdoor.hh"
 #include "mem/packet.hh"
 
 class MemObject;
@@ -101,6 +102,9 @@ class Port
     /** Get the port id. */
     PortID getId() const { return id; }
 
+    /** Get the MemObject that owns this port. */
+    MemObject& getOwner() const { return owner; }
+
 };
 
 /** Forward declaration */
@@ -201,6 +205,19 @@ class MasterPort : public BaseMasterPort
      */
     Tick sendAtomic(PacketPtr pkt);
 
+    /**
+     * Send an atomic request packet like sendAtomic, but additionally ask
+     * the memory for a backdoor to the accessed memory range. If the
+     * memory and all components on the way support it, backdoor is set
+     * to a valid backdoor. Otherwise, it is left untouched.
+     *
+     * @param pkt Packet to send.
+     * @param backdoor Can be set to a backdoor for the accessed range.
+     *
+     * @return Estimated latency of access.
+     */
+    Tick sendAtomicBackdoor(PacketPtr pkt, MemBackdoorPtr &backdoor);
+
     /**
      * Send a functional request packet, where the data is instantly
      * updated everywhere in the memory system, without affecting the
@@ -454,6 +471,18 @@ class SlavePort : public BaseSlavePort
      */
     virtual Tick recvAtomic(PacketPtr pkt) = 0;
 
+    /**
+     * Receive an atomic request packet from the master port and
+     * optionally provide a backdoor to the accessed memory range. By
+     * default, no backdoor is provided and the request is handled as a
+     * normal atomic request.
+     */
+    virtual Tick
+    recvAtomicBackdoor(PacketPtr pkt, MemBackdoorPtr &backdoor)
+    {
+        return recvAtomic(pkt);
+    }
+
     /**
      * Receive a functional request packet from the master port.
      */
@@ -0,0 +1,58 @@
+# Copyright (c) 2015 Nils Asmussen
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#
+# 1. Redistributions of source code must retain the above copyright notice, this
+#    list of conditions and the following disclaimer.
+# 2. Redistributions in binary form must reproduce the above copyright notice,
+#    this list of conditions and the following disclaimer in the documentation
+#    and/or other materials provided with the distribution.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+# ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+# DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+# ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+# (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+# LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+# ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+# SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+# The views and conclusions contained in the software and documentation are those
+# of the authors and should not be interpreted as representing official policies,
+# either expressed or implied, of the FreeBSD Project.
+
+from m5.params import *
+from m5.proxy import *
+from m5.SimObject import SimObject
+
+class HotAddressProbe(SimObject):
+    type = 'HotAddressProbe'
+    cxx_header = "mem/probes/hot_addr.hh"
+
+    # Both the classic caches and the Ruby sequencers provide the probe
+    # points "Hit" and "Miss" with the accessed packet
+    manager = VectorParam.SimObject(Parent.any,
+                                    "Probe manager(s) to instrument")
+    hit_probe_name = Param.String("Hit", "Probe point for hits "
+                                  "(empty = none)")
+    miss_probe_name = Param.String("Miss", "Probe point for misses "
+                                   "(empty = none)")
+
+    line_size = Param.Unsigned(Parent.cache_line_size,
+                               "Granularity of the tracked addresses")
+
+    # The memory consumption is fixed: sketch_width * sketch_depth
+    # counters per sketch (lines and PCs) plus top_k entries per heap
+    sketch_width = Param.Unsigned(4096, "Counters per row of the sketches")
+    sketch_depth = Param.Unsigned(4, "Rows of the sketches")
+    top_k = Param.Unsigned(32, "Number of hot lines and PCs to report")
+
+    dump_interval = Param.Latency('0ns', "Time between two dumps "
+                                  "(0 = only at exit)")
+    reset_on_dump = Param.Bool(False, "Start with empty sketches after "
+                               "each dump")
+    output_file = Param.String("", "Output file (default: <name>.hot)")
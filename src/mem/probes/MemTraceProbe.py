@@ -46,6 +46,13 @@ class MemTraceProbe(BaseMemProbe):
     # Boolean to compress the trace or not.
     trace_compress = Param.Bool(True, "Enable trace compression")
 
+    # The trace is written in batches by a background thread; the
+    # simulation stalls if more than trace_max_batches are pending
+    trace_batch_size = Param.MemorySize('1MB', "Size of a trace batch")
+    trace_max_batches = Param.Unsigned(8, "Maximum number of pending trace "
+                                       "batches (0 = write on the "
+                                       "simulation thread)")
+
     # For requests with a valid PC, include the PC in the trace
     with_pc = Param.Bool(False, "Include PC info in the trace")
 
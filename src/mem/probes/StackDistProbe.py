@@ -62,3 +62,14 @@ class StackDistProbe(BaseMemProbe):
     # logarithmic histogram bins and enable/disable
     log_hist_bins = Param.Unsigned('32', "Bins in logarithmic histograms")
     disable_log_hists = Param.Bool(False, "Disable logarithmic histograms")
+
+    # spatially hashed sampling (SHARDS) with bounded memory
+    sample_rate = Param.Float(1.0, "Initial rate of the spatially hashed "
+                              "sampling (1.0 calculates exact distances)")
+    max_samples = Param.Unsigned(0, "Maximum number of lines tracked by the "
+                                 "sampling; the sampling rate is lowered "
+                                 "accordingly (0 = unlimited)")
+
+    # miss-ratio curve for fully-associative LRU caches of 2^i lines
+    mrc_bins = Param.Unsigned(24, "Number of cache sizes (powers of two in "
+                              "lines) in the miss-ratio curve")
@@ -0,0 +1,227 @@
+/*
+ * Copyright (c) 2015, Nils Asmussen
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#include "mem/probes/hot_addr.hh"
+
+#include <iomanip>
+
+#include "base/bitfield.hh"
+#include "base/callback.hh"
+#include "base/intmath.hh"
+#include "params/HotAddressProbe.hh"
+
+HotAddressProbe::HotAddressProbe(HotAddressProbeParams *p)
+    : SimObject(p),
+      lineMask(~static_cast<Addr>(p->line_size - 1)),
+      dumpInterval(p->dump_interval),
+      resetOnDump(p->reset_on_dump),
+      lineSketch(p->sketch_width, p->sketch_depth),
+      pcSketch(p->sketch_width, p->sketch_depth),
+      hotLines(p->top_k),
+      hotPCs(p->top_k),
+      curSamples(0),
+      os(simout.create(p->output_file.empty() ? name() + ".hot"
+                                              : p->output_file)),
+      dumpEvent([this]{ processDumpEvent(); }, name())
+{
+    fatal_if(!isPowerOf2(p->line_size),
+             "%s: line_size has to be a power of 2\n", name());
+
+    // the destructor is not called at exit, so dump from an exit callback
+    registerExitCallback(
+        new MakeCallback<HotAddressProbe, &HotAddressProbe::closeOutput>(
+            this));
+}
+
+HotAddressProbe::~HotAddressProbe()
+{
+    closeOutput();
+}
+
+void
+HotAddressProbe::regProbeListeners()
+{
+    const HotAddressProbeParams *p(
+        dynamic_cast<const HotAddressProbeParams *>(params()));
+    assert(p);
+
+    for (int i = 0; i < p->manager.size(); i++) {
+        ProbeManager *const mgr(p->manager[i]->getProbeManager());
+        if (!p->hit_probe_name.empty()) {
+            listeners.emplace_back(
+                new PacketListener(*this, mgr, p->hit_probe_name, false));
+        }
+        if (!p->miss_probe_name.empty()) {
+            listeners.emplace_back(
+                new PacketListener(*this, mgr, p->miss_probe_name, true));
+        }
+    }
+}
+
+void
+HotAddressProbe::regStats()
+{
+    SimObject::regStats();
+
+    samples
+        .name(name() + ".samples")
+        .desc("Number of accesses seen by the probe");
+    sampledMisses
+        .name(name() + ".sampledMisses")
+        .desc("Number of misses seen by the probe");
+    dumps
+        .name(name() + ".dumps")
+        .desc("Number of dumps of the hot lines and PCs");
+}
+
+void
+HotAddressProbe::startup()
+{
+    if (dumpInterval)
+        schedule(dumpEvent, curTick() + dumpInterval);
+}
+
+void
+HotAddressProbe::resetStats()
+{
+    SimObject::resetStats();
+
+    // forget the warmup phase
+    clear();
+}
+
+void
+HotAddressProbe::clear()
+{
+    lineSketch.clear();
+    pcSketch.clear();
+    hotLines.clear();
+    hotPCs.clear();
+    curSamples = 0;
+}
+
+void
+HotAddressProbe::handleAccess(const PacketPtr &pkt, bool miss)
+{
+    samples++;
+    curSamples++;
+    if (miss)
+        sampledMisses++;
+
+    Addr line = pkt->getAddr() & lineMask;
+    auto *lentry = hotLines.update(line, lineSketch.add(line));
+    if (lentry) {
+        LineInfo &info = lentry->info;
+        if (miss)
+            info.misses++;
+        if (pkt->isWrite())
+            info.writes++;
+        else if (pkt->isRead())
+            info.reads++;
+        MasterID master = pkt->req->masterId();
+        if (master != Request::invldMasterId)
+            info.sharers |= static_cast<uint64_t>(1) << (master % 64);
+    }
+
+    if (pkt->req->hasPC()) {
+        Addr pc = pkt->req->getPC();
+        auto *pentry = hotPCs.update(pc, pcSketch.add(pc));
+        if (pentry && miss)
+            pentry->info.misses++;
+    }
+}
+
+const char *
+HotAddressProbe::sharingPattern(const LineInfo &info)
+{
+    if (popCount(info.sharers) <= 1)
+        return "private";
+    return info.writes ? "write-shared" : "read-shared";
+}
+
+void
+HotAddressProbe::dump()
+{
+    if (!os)
+        return;
+
+    std::ostream &out = *os->stream();
+    out << "# tick " << curTick() << ", " << curSamples << " samples\n";
+    // the details are only counted since the line entered the top K
+    out << "# hot lines (address accesses misses reads writes sharers "
+        << "pattern)\n";
+    for (auto &e : hotLines.sorted()) {
+        out << "line 0x" << std::hex << std::setw(16) << std::setfill('0')
+            << e.key << std::dec << std::setfill(' ')
+            << " " << std::setw(10) << e.count
+            << " " << std::setw(10) << e.info.misses
+            << " " << std::setw(10) << e.info.reads
+            << " " << std::setw(10) << e.info.writes
+            << " " << std::setw(2) << popCount(e.info.sharers)
+            << " " << sharingPattern(e.info) << "\n";
+    }
+
+    out << "# hot PCs (pc accesses misses)\n";
+    for (auto &e : hotPCs.sorted()) {
+        out << "pc   0x" << std::hex << std::setw(16) << std::setfill('0')
+            << e.key << std::dec << std::setfill(' ')
+            << " " << std::setw(10) << e.count
+            << " " << std::setw(10) << e.info.misses << "\n";
+    }
+    out << "\n";
+    out.flush();
+
+    dumps++;
+    if (resetOnDump)
+        clear();
+}
+
+void
+HotAddressProbe::processDumpEvent()
+{
+    dump();
+    schedule(dumpEvent, curTick() + dumpInterval);
+}
+
+void
+HotAddressProbe::closeOutput()
+{
+    if (os) {
+        dump();
+        simout.close(os);
+        os = nullptr;
+    }
+}
+
+
+HotAddressProbe *
+HotAddressProbeParams::create()
+{
+    return new HotAddressProbe(this);
+}
@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2015, Nils Asmussen
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#ifndef __MEM_PROBES_HOT_ADDR_HH__
+#define __MEM_PROBES_HOT_ADDR_HH__
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/output.hh"
+#include "base/sketch.hh"
+#include "base/statistics.hh"
+#include "mem/packet.hh"
+#include "sim/eventq.hh"
+#include "sim/probe/probe.hh"
+#include "sim/sim_object.hh"
+
+struct HotAddressProbeParams;
+
+/**
+ * Probe that finds the most frequently accessed cache lines and PCs with
+ * a bounded amount of memory. In contrast to the AddressProfiler of Ruby,
+ * which keeps exact per-address maps, the access counts are estimated by
+ * count-min sketches and only the top K lines and PCs are remembered.
+ * Thus, the probe is cheap enough to stay enabled for long runs.
+ *
+ * The probe listens to PacketPtr probe points (like the "Hit" and "Miss"
+ * points of the classic caches and the Ruby sequencers) of any number of
+ * probe managers. For the hot lines, it additionally records the reads,
+ * writes and accessing masters to classify the sharing pattern. The
+ * results are written to a text file periodically and at exit.
+ */
+class HotAddressProbe : public SimObject
+{
+  public:
+    HotAddressProbe(HotAddressProbeParams *params);
+    ~HotAddressProbe();
+
+    void regProbeListeners() override;
+    void regStats() override;
+    void startup() override;
+    void resetStats() override;
+
+    /** Writes the current hot lines and PCs to the output file */
+    void dump();
+
+  private:
+    struct LineInfo
+    {
+        uint64_t misses;
+        uint64_t reads;
+        uint64_t writes;
+        /** bitmask of the accessing masters (modulo 64) */
+        uint64_t sharers;
+    };
+
+    struct PCInfo
+    {
+        uint64_t misses;
+    };
+
+    class PacketListener : public ProbeListenerArgBase<PacketPtr>
+    {
+      public:
+        PacketListener(HotAddressProbe &_parent, ProbeManager *pm,
+                       const std::string &name, bool _miss)
+            : ProbeListenerArgBase(pm, name),
+              parent(_parent),
+              miss(_miss) {}
+
+        void notify(const PacketPtr &pkt) override {
+            parent.handleAccess(pkt, miss);
+        }
+
+      protected:
+        HotAddressProbe &parent;
+        const bool miss;
+    };
+
+    void handleAccess(const PacketPtr &pkt, bool miss);
+    void clear();
+    void processDumpEvent();
+    void closeOutput();
+
+    static const char *sharingPattern(const LineInfo &info);
+
+    const Addr lineMask;
+    const Tick dumpInterval;
+    const bool resetOnDump;
+
+    CountMinSketch lineSketch;
+    CountMinSketch pcSketch;
+    TopK<LineInfo> hotLines;
+    TopK<PCInfo> hotPCs;
+    /** samples since the last reset */
+    uint64_t curSamples;
+
+    OutputStream *os;
+    EventFunctionWrapper dumpEvent;
+
+    std::vector<std::unique_ptr<PacketListener>> listeners;
+
+    Stats::Scalar samples;
+    Stats::Scalar sampledMisses;
+    Stats::Scalar dumps;
+};
+
+#endif //__MEM_PROBES_HOT_ADDR_HH__
@@ -72,7 +72,9 @@ MemTraceProbe::MemTraceProbe(MemTraceProbeParams *p)
                                   (p->trace_compress ? ".gz" : ""));
     }
 
-    traceStream = new ProtoOutputStream(filename);
+    traceStream = new ThreadedProtoOutputStream(filename,
+                                                p->trace_batch_size,
+                                                p->trace_max_batches);
 
     // Register a callback to compensate for the destructor not
     // being called. The callback forces the stream to flush and
@@ -102,8 +104,10 @@ MemTraceProbe::startup()
 void
 MemTraceProbe::closeStreams()
 {
-    if (traceStream != NULL)
+    if (traceStream != NULL) {
         delete traceStream;
+        traceStream = NULL;
+    }
 }
 
 void
@@ -65,8 +65,11 @@ class MemTraceProbe : public BaseMemProbe
 
   protected:
 
-    /** Trace output stream */
-    ProtoOutputStream *traceStream;
+    /**
+     * Trace output stream, which compresses and writes the trace in a
+     * background thread
+     */
+    ThreadedProtoOutputStream *traceStream;
 
     System *system;
 
@@ -39,6 +39,10 @@
 
 #include "mem/probes/stack_dist.hh"
 
+#include <algorithm>
+#include <string>
+
+#include "base/intmath.hh"
 #include "params/StackDistProbe.hh"
 #include "sim/system.hh"
 
@@ -47,11 +51,25 @@ StackDistProbe::StackDistProbe(StackDistProbeParams *p)
       lineSize(p->line_size),
       disableLinearHists(p->disable_linear_hists),
       disableLogHists(p->disable_log_hists),
-      calc(p->verify)
+      calc(p->verify),
+      sampledCalc(),
+      mrcBins(p->mrc_bins),
+      mrcWeights(p->mrc_bins + 1),
+      mrcRequests(0)
 {
     fatal_if(p->system->cacheLineSize() > p->line_size,
              "The stack distance probe must use a cache line size that is "
              "larger or equal to the system's cahce line size.");
+    fatal_if(p->sample_rate <= 0 || p->sample_rate > 1,
+             "The sampling rate has to be in (0, 1].");
+    fatal_if(p->mrc_bins == 0 || p->mrc_bins > 63,
+             "The number of MRC bins has to be in [1, 63].");
+
+    if (p->sample_rate < 1 || p->max_samples > 0) {
+        fatal_if(p->verify, "Verification is not supported with sampling.");
+        sampledCalc.reset(new SampledStackDistCalc(p->sample_rate,
+                                                   p->max_samples));
+    }
 }
 
 void
@@ -93,6 +111,83 @@ StackDistProbe::regStats()
         .name(name() + ".infinity")
         .desc("Number of requests with infinite stack distance")
         .flags(nozero);
+
+    mrc
+        .init(mrcBins)
+        .name(name() + ".mrc")
+        .desc("Miss ratio of a fully-associative LRU cache with the given "
+              "number of lines")
+        .flags(nozero);
+    for (unsigned i = 0; i < mrcBins; ++i)
+        mrc.subname(i, std::to_string(1ULL << i));
+
+    requests
+        .name(name() + ".requests")
+        .desc("Number of read and write requests");
+
+    sampledRequests
+        .name(name() + ".sampledRequests")
+        .desc("Number of requests for which the stack distance was "
+              "calculated");
+
+    samplingRate
+        .name(name() + ".samplingRate")
+        .desc("Current rate of the spatially hashed sampling");
+
+    trackedLines
+        .name(name() + ".trackedLines")
+        .desc("Number of lines tracked by the sampling")
+        .flags(nozero);
+
+    registerDumpCallback(
+        new MakeCallback<StackDistProbe, &StackDistProbe::computeMrc>(this));
+    registerResetCallback(
+        new MakeCallback<StackDistProbe, &StackDistProbe::statReset>(this));
+}
+
+void
+StackDistProbe::recordDistance(uint64_t sd, double weight)
+{
+    unsigned bin;
+    if (sd == StackDistCalc::Infinity)
+        bin = mrcBins;
+    else
+        bin = std::min<unsigned>(sd == 0 ? 0 : floorLog2(sd) + 1, mrcBins);
+    mrcWeights[bin] += weight;
+}
+
+void
+StackDistProbe::computeMrc()
+{
+    if (mrcRequests == 0)
+        return;
+
+    // with sampling, the total weight of the samples deviates from the
+    // number of requests. as in SHARDS_adj, we account the difference as
+    // reuses with distance 0, which only affects the smallest cache size.
+    double total = mrcRequests;
+
+    // a cache with 2^i lines misses on all distances >= 2^i, which are the
+    // bins i+1 and above
+    double misses = 0;
+    for (unsigned i = mrcBins; i > 0; --i) {
+        misses += mrcWeights[i];
+        mrc[i - 1] = std::min(1.0, misses / total);
+    }
+
+    if (sampledCalc) {
+        samplingRate = sampledCalc->rate();
+        trackedLines = sampledCalc->tracked();
+    } else {
+        samplingRate = 1;
+    }
+}
+
+void
+StackDistProbe::statReset()
+{
+    std::fill(mrcWeights.begin(), mrcWeights.end(), 0);
+    mrcRequests = 0;
 }
 
 void
@@ -106,8 +201,24 @@ StackDistProbe::handleRequest(const ProbePoints::PacketInfo &pkt_info)
     // Align the address to a cache line size
     const Addr aligned_addr(roundDown(pkt_info.addr, lineSize));
 
+    requests++;
+    mrcRequests++;
+
     // Calculate the stack distance
-    const uint64_t sd(calc.calcStackDistAndUpdate(aligned_addr).first);
+    uint64_t sd;
+    if (sampledCalc) {
+        const auto res(sampledCalc->calcStackDistAndUpdate(aligned_addr));
+        if (!res.sampled)
+            return;
+
+        sd = res.distance;
+        recordDistance(sd, res.weight);
+    } else {
+        sd = calc.calcStackDistAndUpdate(aligned_addr).first;
+        recordDistance(sd, 1);
+    }
+
+    sampledRequests++;
     if (sd == StackDistCalc::Infinity) {
         infiniteSD++;
         return;
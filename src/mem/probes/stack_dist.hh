@@ -40,8 +40,12 @@
 #ifndef __MEM_PROBES_STACK_DIST_HH__
 #define __MEM_PROBES_STACK_DIST_HH__
 
+#include <memory>
+#include <vector>
+
 #include "mem/packet.hh"
 #include "mem/probes/base.hh"
+#include "mem/sampled_stack_dist_calc.hh"
 #include "mem/stack_dist_calc.hh"
 #include "sim/stats.hh"
 
@@ -57,6 +61,15 @@ class StackDistProbe : public BaseMemProbe
   protected:
     void handleRequest(const ProbePoints::PacketInfo &pkt_info) override;
 
+    /** Accounts the given (scaled) stack distance in the MRC */
+    void recordDistance(uint64_t sd, double weight);
+
+    /** Computes the miss-ratio curve before the stats are dumped */
+    void computeMrc();
+
+    /** Clears the recorded distances on stats reset */
+    void statReset();
+
   protected:
     // Cache line size to simulate
     const unsigned lineSize;
@@ -83,8 +96,36 @@ class StackDistProbe : public BaseMemProbe
     // Writes logarithmic histogram
     Stats::Scalar infiniteSD;
 
+    // Miss ratio of fully-associative LRU caches with 2^i lines
+    Stats::Vector mrc;
+
+    // Number of read and write requests
+    Stats::Scalar requests;
+
+    // Number of sampled requests
+    Stats::Scalar sampledRequests;
+
+    // Current sampling rate
+    Stats::Scalar samplingRate;
+
+    // Number of lines tracked by the sampling
+    Stats::Scalar trackedLines;
+
   protected:
     StackDistCalc calc;
+
+    // The calculator used if sampling is enabled
+    std::unique_ptr<SampledStackDistCalc> sampledCalc;
+
+    // Number of cache sizes in the MRC
+    const unsigned mrcBins;
+
+    // Weighted number of distances per log2 bin; the last bin holds all
+    // larger and infinite distances
+    std::vector<double> mrcWeights;
+
+    // Number of requests (read/write) since the last reset
+    uint64_t mrcRequests;
 };
 
 
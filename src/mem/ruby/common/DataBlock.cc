@@ -28,12 +28,19 @@
 
 #include "mem/ruby/common/DataBlock.hh"
 
+#include "base/slab_allocator.hh"
 #include "mem/ruby/common/WriteMask.hh"
 #include "mem/ruby/system/RubySystem.hh"
 
+static SlabAllocator &
+blockSlab()
+{
+    return SlabAllocator::forSize(RubySystem::getBlockSizeBytes());
+}
+
 DataBlock::DataBlock(const DataBlock &cp)
 {
-    m_data = new uint8_t[RubySystem::getBlockSizeBytes()];
+    m_data = static_cast<uint8_t*>(blockSlab().allocate());
     memcpy(m_data, cp.m_data, RubySystem::getBlockSizeBytes());
     m_alloc = true;
 }
@@ -41,11 +48,17 @@ DataBlock::DataBlock(const DataBlock &cp)
 void
 DataBlock::alloc()
 {
-    m_data = new uint8_t[RubySystem::getBlockSizeBytes()];
+    m_data = static_cast<uint8_t*>(blockSlab().allocate());
     m_alloc = true;
     clear();
 }
 
+void
+DataBlock::free()
+{
+    blockSlab().deallocate(m_data);
+}
+
 void
 DataBlock::clear()
 {
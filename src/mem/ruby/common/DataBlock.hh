@@ -50,7 +50,7 @@ class DataBlock
     ~DataBlock()
     {
         if (m_alloc)
-            delete [] m_data;
+            free();
     }
 
     DataBlock& operator=(const DataBlock& obj);
@@ -70,7 +70,9 @@ class DataBlock
     void print(std::ostream& out) const;
 
   private:
+    // The data is taken from a slab of equally sized blocks
     void alloc();
+    void free();
     uint8_t *m_data;
     bool m_alloc;
 };
@@ -80,7 +82,7 @@ DataBlock::assign(uint8_t *data)
 {
     assert(data != NULL);
     if (m_alloc) {
-        delete [] m_data;
+        free();
     }
     m_data = data;
     m_alloc = false;
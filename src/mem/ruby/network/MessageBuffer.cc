@@ -64,6 +64,20 @@ MessageBuffer::MessageBuffer(const Params *p)
     m_dequeue_callback = nullptr;
 }
 
+MessageBuffer::~MessageBuffer()
+{
+    // release the references held by the stall lists
+    for (auto &stalled : m_stall_msg_map) {
+        Message *m = stalled.second.head;
+        while (m) {
+            Message *next = m->m_next_stalled;
+            m->m_next_stalled = nullptr;
+            m->decref();
+            m = next;
+        }
+    }
+}
+
 unsigned int
 MessageBuffer::getSize(Tick curTime)
 {
@@ -294,28 +308,34 @@ MessageBuffer::recycle(Tick current_time, Tick recycle_latency)
 }
 
 void
-MessageBuffer::reanalyzeList(list<MsgPtr> &lt, Tick schdTick)
+MessageBuffer::reanalyzeList(StallList &lt, Tick schdTick)
 {
-    while (!lt.empty()) {
+    while (lt.head) {
         m_msg_counter++;
-        MsgPtr m = lt.front();
+        Message *m = lt.head;
+        lt.head = m->m_next_stalled;
+        m->m_next_stalled = nullptr;
         m->setLastEnqueueTime(schdTick);
         m->setMsgCounter(m_msg_counter);
 
-        m_prio_heap.push_back(m);
+        m_prio_heap.push_back(MsgPtr(m));
         push_heap(m_prio_heap.begin(), m_prio_heap.end(),
                   greater<MsgPtr>());
+        // the heap holds a reference now
+        m->decref();
 
         m_consumer->scheduleEventAbsolute(schdTick);
-        lt.pop_front();
     }
+    lt.tail = nullptr;
+    lt.size = 0;
 }
 
 void
 MessageBuffer::reanalyzeMessages(Addr addr, Tick current_time)
 {
     DPRINTF(RubyQueue, "ReanalyzeMessages %#x\n", addr);
-    assert(m_stall_msg_map.count(addr) > 0);
+    auto it = m_stall_msg_map.find(addr);
+    assert(it != m_stall_msg_map.end());
 
     //
     // Put all stalled messages associated with this address back on the
@@ -323,10 +343,10 @@ MessageBuffer::reanalyzeMessages(Addr addr, Tick current_time)
     // scheduled for the current cycle so that the previously stalled messages
     // will be observed before any younger messages that may arrive this cycle
     //
-    m_stall_map_size -= m_stall_msg_map[addr].size();
+    m_stall_map_size -= it->second.size;
     assert(m_stall_map_size >= 0);
-    reanalyzeList(m_stall_msg_map[addr], current_time);
-    m_stall_msg_map.erase(addr);
+    reanalyzeList(it->second, current_time);
+    m_stall_msg_map.erase(it);
 }
 
 void
@@ -340,11 +360,17 @@ MessageBuffer::reanalyzeAllMessages(Tick current_time)
     // scheduled for the current cycle so that the previously stalled messages
     // will be observed before any younger messages that may arrive this cycle.
     //
-    for (StallMsgMapType::iterator map_iter = m_stall_msg_map.begin();
-         map_iter != m_stall_msg_map.end(); ++map_iter) {
-        m_stall_map_size -= map_iter->second.size();
+    vector<Addr> addrs;
+    addrs.reserve(m_stall_msg_map.size());
+    for (auto &stalled : m_stall_msg_map)
+        addrs.push_back(stalled.first);
+    sort(addrs.begin(), addrs.end());
+
+    for (Addr addr : addrs) {
+        StallList &lt = m_stall_msg_map[addr];
+        m_stall_map_size -= lt.size;
         assert(m_stall_map_size >= 0);
-        reanalyzeList(map_iter->second, current_time);
+        reanalyzeList(lt, current_time);
     }
     m_stall_msg_map.clear();
 }
@@ -366,7 +392,14 @@ MessageBuffer::stallMessage(Addr addr, Tick current_time)
     // Instead the controller is responsible to call reanalyzeMessages when
     // these addresses change state.
     //
-    (m_stall_msg_map[addr]).push_back(message);
+    StallList &lt = m_stall_msg_map[addr];
+    message->incref();
+    if (lt.tail)
+        lt.tail->m_next_stalled = message.get();
+    else
+        lt.head = message.get();
+    lt.tail = message.get();
+    lt.size++;
     m_stall_map_size++;
     m_stall_count++;
 }
@@ -442,14 +475,9 @@ MessageBuffer::functionalWrite(Packet *pkt)
 
     // Check the stall queue and write any messages that may
     // correspond to the address in the packet.
-    for (StallMsgMapType::iterator map_iter = m_stall_msg_map.begin();
-         map_iter != m_stall_msg_map.end();
-         ++map_iter) {
-
-        for (std::list<MsgPtr>::iterator it = (map_iter->second).begin();
-            it != (map_iter->second).end(); ++it) {
-
-            Message *msg = (*it).get();
+    for (auto &stalled : m_stall_msg_map) {
+        for (Message *msg = stalled.second.head; msg;
+             msg = msg->m_next_stalled) {
             if (msg->functionalWrite(pkt)) {
                 num_functional_writes++;
             }
@@ -39,6 +39,7 @@
 #include <functional>
 #include <iostream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "base/trace.hh"
@@ -55,6 +56,7 @@ class MessageBuffer : public SimObject
   public:
     typedef MessageBufferParams Params;
     MessageBuffer(const Params *p);
+    ~MessageBuffer();
 
     void reanalyzeMessages(Addr addr, Tick current_time);
     void reanalyzeAllMessages(Tick current_time);
@@ -129,7 +131,18 @@ class MessageBuffer : public SimObject
     uint32_t functionalWrite(Packet *pkt);
 
   private:
-    void reanalyzeList(std::list<MsgPtr> &, Tick);
+    // Stalled messages of one line, linked through the messages
+    // themselves. The list holds a reference to each message.
+    struct StallList
+    {
+        StallList() : head(nullptr), tail(nullptr), size(0) {}
+
+        Message *head;
+        Message *tail;
+        int size;
+    };
+
+    void reanalyzeList(StallList &, Tick);
 
   private:
     // Data Members (m_ prefix)
@@ -139,9 +152,9 @@ class MessageBuffer : public SimObject
 
     std::function<void()> m_dequeue_callback;
 
-    // use a std::map for the stalled messages as this container is
-    // sorted and ensures a well-defined iteration order
-    typedef std::map<Addr, std::list<MsgPtr> > StallMsgMapType;
+    // use a hash table for the stalled messages. reanalyzeAllMessages
+    // visits the lines in address order to ensure a well-defined order
+    typedef std::unordered_map<Addr, StallList> StallMsgMapType;
 
     /**
      * A map from line addresses to lists of stalled messages for that line.
@@ -44,6 +44,7 @@ enum VNET_type {CTRL_VNET_, DATA_VNET_, NULL_VNET_, NUM_VNET_TYPE_};
 enum flit_stage {I_, VA_, SA_, ST_, LT_, NUM_FLIT_STAGE_};
 enum link_type { EXT_IN_, EXT_OUT_, INT_, NUM_LINK_TYPES_ };
 enum RoutingAlgorithm { TABLE_ = 0, XY_ = 1, CUSTOM_ = 2,
+                        WEST_FIRST_ = 3, ODD_EVEN_ = 4, ADAPTIVE_ = 5,
                         NUM_ROUTING_ALGORITHM_};
 
 struct RouteInfo
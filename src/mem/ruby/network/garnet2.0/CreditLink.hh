@@ -41,7 +41,8 @@ class CreditLink : public NetworkLink
 {
   public:
     typedef CreditLinkParams Params;
-    CreditLink(const Params *p) : NetworkLink(p) {}
+    // Credits fit into a single phit, but go through the SerDes as well
+    CreditLink(const Params *p) : NetworkLink(p) { m_phits_per_flit = 1; }
 };
 
 #endif // __MEM_RUBY_NETWORK_GARNET2_0_CREDITLINK_HH__
@@ -46,6 +46,7 @@ CrossbarSwitch::CrossbarSwitch(Router *router)
     m_router = router;
     m_num_vcs = m_router->get_num_vcs();
     m_crossbar_activity = 0;
+    m_num_buffered_flits = 0;
 }
 
 CrossbarSwitch::~CrossbarSwitch()
@@ -78,6 +79,10 @@ CrossbarSwitch::wakeup()
             "at time: %lld\n",
             m_router->get_id(), m_router->curCycle());
 
+    // nothing has won the switch since the last traversal
+    if (m_num_buffered_flits == 0)
+        return;
+
     for (int inport = 0; inport < m_num_inports; inport++) {
         if (!m_switch_buffer[inport]->isReady(m_router->curCycle()))
             continue;
@@ -94,6 +99,7 @@ CrossbarSwitch::wakeup()
             // in the next cycle
             m_output_unit[outport]->insert_flit(t_flit);
             m_switch_buffer[inport]->getTopFlit();
+            m_num_buffered_flits--;
             m_crossbar_activity++;
         }
     }
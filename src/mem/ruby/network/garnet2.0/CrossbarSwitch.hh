@@ -54,7 +54,10 @@ class CrossbarSwitch : public Consumer
     void print(std::ostream& out) const {};
 
     inline void update_sw_winner(int inport, flit *t_flit)
-    { m_switch_buffer[inport]->insert(t_flit); }
+    {
+        m_switch_buffer[inport]->insert(t_flit);
+        m_num_buffered_flits++;
+    }
 
     inline double get_crossbar_activity() { return m_crossbar_activity; }
 
@@ -65,6 +68,8 @@ class CrossbarSwitch : public Consumer
     int m_num_vcs;
     int m_num_inports;
     double m_crossbar_activity;
+    // Number of flits in all switch buffers
+    int m_num_buffered_flits;
     Router *m_router;
     std::vector<flitBuffer *> m_switch_buffer;
     std::vector<OutputUnit *> m_output_unit;
@@ -42,6 +42,10 @@ class NetworkLink(ClockedObject):
                               "virtual channels per virtual network")
     virt_nets = Param.Int(Parent.number_of_virtual_networks,
                           "number of virtual networks")
+    flit_size = Param.UInt32(Parent.ni_flit_size, "flit size in bytes")
+    width = Param.UInt32(Parent.width, "link width in bytes")
+    serdes_latency = Param.Cycles(Parent.serdes_latency,
+                                  "latency of the SerDes units (in cycles)")
 
 class CreditLink(NetworkLink):
     type = 'CreditLink'
@@ -51,6 +55,12 @@ class CreditLink(NetworkLink):
 class GarnetIntLink(BasicIntLink):
     type = 'GarnetIntLink'
     cxx_header = "mem/ruby/network/garnet2.0/GarnetLink.hh"
+    # Links that are narrower or wider than a flit get SerDes units at
+    # both ends, which split flits into phits and reassemble them.
+    # Links can also run in their own clock domain (e.g., off-chip links)
+    width = Param.UInt32(Parent.ni_flit_size, "link width in bytes")
+    serdes_latency = Param.Cycles(1, "latency of the SerDes units (in cycles)")
+    clk_domain = Param.ClockDomain(Parent.clk_domain, "link clock domain")
     # The internal link includes one forward link (for flit)
     # and one backward flow-control link (for credit)
     network_link = Param.NetworkLink(NetworkLink(), "forward link")
@@ -60,6 +70,9 @@ class GarnetIntLink(BasicIntLink):
 class GarnetExtLink(BasicExtLink):
     type = 'GarnetExtLink'
     cxx_header = "mem/ruby/network/garnet2.0/GarnetLink.hh"
+    width = Param.UInt32(Parent.ni_flit_size, "link width in bytes")
+    serdes_latency = Param.Cycles(1, "latency of the SerDes units (in cycles)")
+    clk_domain = Param.ClockDomain(Parent.clk_domain, "link clock domain")
     # The external link is bi-directional.
     # It includes two forward links (for flits)
     # and two backward flow-control links (for credits),
@@ -36,6 +36,7 @@
 #include <cassert>
 
 #include "base/cast.hh"
+#include "base/cprintf.hh"
 #include "base/stl_helpers.hh"
 #include "mem/ruby/common/NetDest.hh"
 #include "mem/ruby/network/MessageBuffer.hh"
@@ -125,6 +126,15 @@ GarnetNetwork::init()
         m_num_cols = -1;
     }
 
+    if (m_routing_algorithm == WEST_FIRST_ ||
+        m_routing_algorithm == ODD_EVEN_ ||
+        m_routing_algorithm == ADAPTIVE_) {
+        fatal_if(m_num_rows <= 0,
+                 "Adaptive routing is only supported on a Mesh\n");
+        fatal_if(m_routing_algorithm == ADAPTIVE_ && m_vcs_per_vnet < 2,
+                 "Adaptive routing requires at least 2 VCs per vnet\n");
+    }
+
     // FaultModel: declare each router to the fault model
     if (isFaultModelEnabled()) {
         for (vector<Router*>::const_iterator i= m_routers.begin();
@@ -173,6 +183,7 @@ GarnetNetwork::makeExtInLink(NodeID src, SwitchID dest, BasicLink* link,
 
     m_networklinks.push_back(net_link);
     m_creditlinks.push_back(credit_link);
+    m_link_names.push_back(csprintf("ni%d_r%d", src, dest));
 
     PortDirection dst_inport_dirn = "Local";
     m_routers[dest]->addInPort(dst_inport_dirn, net_link, credit_link);
@@ -202,6 +213,7 @@ GarnetNetwork::makeExtOutLink(SwitchID src, NodeID dest, BasicLink* link,
 
     m_networklinks.push_back(net_link);
     m_creditlinks.push_back(credit_link);
+    m_link_names.push_back(csprintf("r%d_ni%d", src, dest));
 
     PortDirection src_outport_dirn = "Local";
     m_routers[src]->addOutPort(src_outport_dirn, net_link,
@@ -230,6 +242,7 @@ GarnetNetwork::makeInternalLink(SwitchID src, SwitchID dest, BasicLink* link,
 
     m_networklinks.push_back(net_link);
     m_creditlinks.push_back(credit_link);
+    m_link_names.push_back(csprintf("r%d_%s", src, src_outport_dirn));
 
     m_routers[dest]->addInPort(dst_inport_dirn, net_link, credit_link);
     m_routers[src]->addOutPort(src_outport_dirn, net_link,
@@ -393,6 +406,29 @@ GarnetNetwork::regStats()
         .name(name() + ".avg_vc_load")
         .flags(Stats::pdf | Stats::total | Stats::nozero | Stats::oneline)
         ;
+
+    m_link_utilization
+        .init(m_networklinks.size())
+        .name(name() + ".link_utilization")
+        .flags(Stats::nozero)
+        ;
+    m_link_bandwidth
+        .init(m_networklinks.size())
+        .name(name() + ".link_bandwidth")
+        .desc("bytes per cycle")
+        .flags(Stats::nozero)
+        ;
+    m_link_occupancy
+        .init(m_networklinks.size())
+        .name(name() + ".link_occupancy")
+        .desc("fraction of link cycles spent sending flits")
+        .flags(Stats::nozero)
+        ;
+    for (int i = 0; i < m_networklinks.size(); i++) {
+        m_link_utilization.subname(i, m_link_names[i]);
+        m_link_bandwidth.subname(i, m_link_names[i]);
+        m_link_occupancy.subname(i, m_link_names[i]);
+    }
 }
 
 void
@@ -414,6 +450,15 @@ GarnetNetwork::collateStats()
 
         m_average_link_utilization +=
             (double(activity) / time_delta);
+        m_link_utilization[i] = (double(activity) / time_delta);
+        m_link_bandwidth[i] = double(activity) *
+            m_networklinks[i]->getFlitSize() / time_delta;
+
+        // the link might run in a different clock domain
+        double link_cycles = time_delta * clockPeriod() /
+            m_networklinks[i]->clockPeriod();
+        m_link_occupancy[i] =
+            double(m_networklinks[i]->getBusyCycles()) / link_cycles;
 
         vector<unsigned int> vc_load = m_networklinks[i]->getVcLoad();
         for (int j = 0; j < vc_load.size(); j++) {
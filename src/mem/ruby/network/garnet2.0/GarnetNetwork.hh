@@ -182,6 +182,11 @@ class GarnetNetwork : public Network
     Stats::Scalar m_total_int_link_utilization;
     Stats::Scalar m_average_link_utilization;
     Stats::Vector m_average_vc_load;
+    // Utilization of each link, e.g., to plot a heatmap of the mesh
+    Stats::Vector m_link_utilization;
+    // Bytes per cycle and fraction of busy link cycles of each link
+    Stats::Vector m_link_bandwidth;
+    Stats::Vector m_link_occupancy;
 
     Stats::Scalar  m_total_hops;
     Stats::Formula m_avg_hops;
@@ -193,6 +198,7 @@ class GarnetNetwork : public Network
     std::vector<VNET_type > m_vnet_type;
     std::vector<Router *> m_routers;   // All Routers in Network
     std::vector<NetworkLink *> m_networklinks; // All flit links in the network
+    std::vector<std::string> m_link_names; // Stat names of the flit links
     std::vector<CreditLink *> m_creditlinks; // All credit links in the network
     std::vector<NetworkInterface *> m_nis;   // All NI's in Network
 };
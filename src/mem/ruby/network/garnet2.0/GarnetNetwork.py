@@ -43,7 +43,8 @@ class GarnetNetwork(RubyNetwork):
     buffers_per_data_vc = Param.UInt32(4, "buffers per data virtual channel");
     buffers_per_ctrl_vc = Param.UInt32(1, "buffers per ctrl virtual channel");
     routing_algorithm = Param.Int(0,
-        "0: Weight-based Table, 1: XY, 2: Custom");
+        "0: Weight-based Table, 1: XY, 2: Custom, 3: West-first, "
+        "4: Odd-even, 5: Fully adaptive with escape VCs");
     enable_fault_model = Param.Bool(False, "enable network fault model");
     fault_model = Param.FaultModel(NULL, "network fault model");
     garnet_deadlock_threshold = Param.UInt32(50000,
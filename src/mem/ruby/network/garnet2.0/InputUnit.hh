@@ -109,9 +109,19 @@ class InputUnit : public Consumer
     inline flit*
     getTopFlit(int vc)
     {
+        assert(m_num_buffered_flits > 0);
+        m_num_buffered_flits--;
         return m_vcs[vc]->getTopFlit();
     }
 
+    // True if any input VC holds a flit. Ports without flits can be
+    // skipped by the SwitchAllocator.
+    inline bool
+    has_buffered_flits() const
+    {
+        return m_num_buffered_flits > 0;
+    }
+
     inline bool
     need_stage(int vc, flit_stage stage, Cycles time)
     {
@@ -161,6 +171,8 @@ class InputUnit : public Consumer
 
     // Input Virtual channels
     std::vector<VirtualChannel *> m_vcs;
+    // Number of flits in all input VCs
+    int m_num_buffered_flits;
 
     // Statistical variables
     std::vector<double> m_num_buffer_writes;
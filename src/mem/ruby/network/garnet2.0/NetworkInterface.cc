@@ -95,9 +95,9 @@ NetworkInterface::addInPort(NetworkLink *in_link,
                               CreditLink *credit_link)
 {
     inNetLink = in_link;
-    in_link->setLinkConsumer(this);
+    in_link->setLinkConsumer(this, this);
     outCreditLink = credit_link;
-    credit_link->setSourceQueue(outCreditQueue);
+    credit_link->setSourceQueue(outCreditQueue, this);
 }
 
 void
@@ -106,11 +106,11 @@ NetworkInterface::addOutPort(NetworkLink *out_link,
                              SwitchID router_id)
 {
     inCreditLink = credit_link;
-    credit_link->setLinkConsumer(this);
+    credit_link->setLinkConsumer(this, this);
 
     outNetLink = out_link;
     outFlitQueue = new flitBuffer();
-    out_link->setSourceQueue(outFlitQueue);
+    out_link->setSourceQueue(outFlitQueue, this);
 
     m_router_id = router_id;
 }
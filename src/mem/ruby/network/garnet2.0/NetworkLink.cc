@@ -33,16 +33,36 @@
 
 #include "mem/ruby/network/garnet2.0/NetworkLink.hh"
 
+#include <algorithm>
+
+#include "base/intmath.hh"
 #include "mem/ruby/network/garnet2.0/CreditLink.hh"
 
 NetworkLink::NetworkLink(const Params *p)
-    : ClockedObject(p), Consumer(this), m_id(p->link_id),
+    : ClockedObject(p), Consumer(this),
+      m_flits_per_cycle(1), m_phits_per_flit(1),
+      m_id(p->link_id),
       m_type(NUM_LINK_TYPES_),
       m_latency(p->link_latency),
+      m_flit_size(p->flit_size), m_serdes_latency(0),
       linkBuffer(new flitBuffer()), link_consumer(nullptr),
-      link_srcQueue(nullptr), m_link_utilized(0),
+      link_consumer_clk(nullptr), link_srcQueue(nullptr),
+      link_src_clk(nullptr), m_slot(0), m_slot_flits(0), m_free_at(0),
+      m_link_utilized(0), m_busy_cycles(0),
       m_vc_load(p->vcs_per_vnet * p->virt_nets)
 {
+    fatal_if(p->width == 0, "%s: link width must not be 0\n", name());
+
+    // A link that is narrower than a flit sends it as multiple phits in
+    // consecutive cycles, a wider link sends multiple flits per cycle.
+    // Either way, SerDes units at both ends convert between flits and
+    // phits, which adds to the latency.
+    if (p->width < m_flit_size)
+        m_phits_per_flit = divCeil(m_flit_size, p->width);
+    else
+        m_flits_per_cycle = p->width / m_flit_size;
+    if (p->width != m_flit_size)
+        m_serdes_latency = p->serdes_latency;
 }
 
 NetworkLink::~NetworkLink()
@@ -51,27 +71,63 @@ NetworkLink::~NetworkLink()
 }
 
 void
-NetworkLink::setLinkConsumer(Consumer *consumer)
+NetworkLink::setLinkConsumer(Consumer *consumer, ClockedObject *consumer_clk)
 {
     link_consumer = consumer;
+    link_consumer_clk = consumer_clk;
 }
 
 void
-NetworkLink::setSourceQueue(flitBuffer *srcQueue)
+NetworkLink::setSourceQueue(flitBuffer *srcQueue, ClockedObject *src_clk)
 {
     link_srcQueue = srcQueue;
+    link_src_clk = src_clk;
+}
+
+// Flit times are in cycles of the object that reads them, which might be
+// in a different clock domain than the link. Returns the number of
+// consumer cycles until its first clock edge at or after 'when'.
+Cycles
+NetworkLink::consumerDelay(Tick when) const
+{
+    Tick edge = link_consumer_clk->clockEdge();
+    if (when <= edge)
+        return Cycles(0);
+    return link_consumer_clk->ticksToCycles(when - edge);
 }
 
 void
 NetworkLink::wakeup()
 {
-    if (link_srcQueue->isReady(curCycle())) {
+    while (link_srcQueue->isReady(link_src_clk->curCycle())) {
+        // still busy with the phits or flits of a previous cycle
+        if (m_free_at > clockEdge()) {
+            scheduleEventAbsolute(m_free_at);
+            return;
+        }
+
+        if (m_slot != clockEdge()) {
+            m_slot = clockEdge();
+            m_slot_flits = 0;
+            m_busy_cycles += m_phits_per_flit;
+        }
+
         flit *t_flit = link_srcQueue->getTopFlit();
-        t_flit->set_time(curCycle() + m_latency);
+
+        // the flit is complete at the other end once its last phit
+        // arrived and went through the deserializer
+        Tick arrival = clockEdge(m_latency + m_serdes_latency +
+                                 Cycles(m_phits_per_flit - 1));
+        Cycles delay = consumerDelay(arrival);
+        t_flit->set_time(link_consumer_clk->curCycle() + delay);
         linkBuffer->insert(t_flit);
-        link_consumer->scheduleEventAbsolute(clockEdge(m_latency));
+        link_consumer->scheduleEventAbsolute(
+            link_consumer_clk->clockEdge(delay));
         m_link_utilized++;
         m_vc_load[t_flit->get_vc()]++;
+
+        if (++m_slot_flits == m_flits_per_cycle)
+            m_free_at = clockEdge(Cycles(m_phits_per_flit));
     }
 }
 
@@ -83,6 +139,7 @@ NetworkLink::resetStats()
     }
 
     m_link_utilized = 0;
+    m_busy_cycles = 0;
 }
 
 NetworkLink *
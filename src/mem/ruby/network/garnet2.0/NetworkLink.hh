@@ -52,8 +52,8 @@ class NetworkLink : public ClockedObject, public Consumer
     NetworkLink(const Params *p);
     ~NetworkLink();
 
-    void setLinkConsumer(Consumer *consumer);
-    void setSourceQueue(flitBuffer *srcQueue);
+    void setLinkConsumer(Consumer *consumer, ClockedObject *consumer_clk);
+    void setSourceQueue(flitBuffer *srcQueue, ClockedObject *src_clk);
     void setType(link_type type) { m_type = type; }
     link_type getType() { return m_type; }
     void print(std::ostream& out) const {}
@@ -61,6 +61,8 @@ class NetworkLink : public ClockedObject, public Consumer
     void wakeup();
 
     unsigned int getLinkUtilization() const { return m_link_utilized; }
+    unsigned int getBusyCycles() const { return m_busy_cycles; }
+    uint32_t getFlitSize() const { return m_flit_size; }
     const std::vector<unsigned int> & getVcLoad() const { return m_vc_load; }
 
     inline bool isReady(Cycles curTime)
@@ -72,17 +74,36 @@ class NetworkLink : public ClockedObject, public Consumer
     uint32_t functionalWrite(Packet *);
     void resetStats();
 
+  protected:
+    // Flits per link cycle (links at least as wide as a flit)
+    int m_flits_per_cycle;
+    // Link cycles per flit (links narrower than a flit)
+    int m_phits_per_flit;
+
   private:
+    Cycles consumerDelay(Tick when) const;
+
     const int m_id;
     link_type m_type;
     const Cycles m_latency;
+    const uint32_t m_flit_size;
+    Cycles m_serdes_latency;
 
     flitBuffer *linkBuffer;
     Consumer *link_consumer;
+    ClockedObject *link_consumer_clk;
     flitBuffer *link_srcQueue;
+    ClockedObject *link_src_clk;
+
+    // Link cycle that is currently filled with flits, the number of
+    // flits in it and the time at which the link is free again
+    Tick m_slot;
+    int m_slot_flits;
+    Tick m_free_at;
 
     // Statistical variables
     unsigned int m_link_utilized;
+    unsigned int m_busy_cycles;
     std::vector<unsigned int> m_vc_load;
 };
 
@@ -94,11 +94,13 @@ OutputUnit::has_credit(int out_vc)
 
 
 // Check if the output port (i.e., input port at next router) has free VCs.
+// The first VC of each vnet is the escape VC of adaptive routing.
 bool
-OutputUnit::has_free_vc(int vnet)
+OutputUnit::has_free_vc(int vnet, bool use_escape_vc)
 {
     int vc_base = vnet*m_vc_per_vnet;
-    for (int vc = vc_base; vc < vc_base + m_vc_per_vnet; vc++) {
+    int vc_first = use_escape_vc ? vc_base : vc_base + 1;
+    for (int vc = vc_first; vc < vc_base + m_vc_per_vnet; vc++) {
         if (is_vc_idle(vc, m_router->curCycle()))
             return true;
     }
@@ -108,10 +110,11 @@ OutputUnit::has_free_vc(int vnet)
 
 // Assign a free output VC to the winner of Switch Allocation
 int
-OutputUnit::select_free_vc(int vnet)
+OutputUnit::select_free_vc(int vnet, bool use_escape_vc)
 {
     int vc_base = vnet*m_vc_per_vnet;
-    for (int vc = vc_base; vc < vc_base + m_vc_per_vnet; vc++) {
+    int vc_first = use_escape_vc ? vc_base : vc_base + 1;
+    for (int vc = vc_first; vc < vc_base + m_vc_per_vnet; vc++) {
         if (is_vc_idle(vc, m_router->curCycle())) {
             m_outvc_state[vc]->setState(ACTIVE_, m_router->curCycle());
             return vc;
@@ -121,6 +124,18 @@ OutputUnit::select_free_vc(int vnet)
     return -1;
 }
 
+// Free buffer slots in all downstream VCs of a vnet.
+// Used as congestion metric by adaptive routing.
+int
+OutputUnit::get_free_credits(int vnet)
+{
+    int credits = 0;
+    int vc_base = vnet*m_vc_per_vnet;
+    for (int vc = vc_base; vc < vc_base + m_vc_per_vnet; vc++)
+        credits += m_outvc_state[vc]->get_credit_count();
+    return credits;
+}
+
 /*
  * The wakeup function of the OutputUnit reads the credit signal from the
  * downstream router for the output VC (i.e., input VC at downstream router).
@@ -58,8 +58,9 @@ class OutputUnit : public Consumer
     void decrement_credit(int out_vc);
     void increment_credit(int out_vc);
     bool has_credit(int out_vc);
-    bool has_free_vc(int vnet);
-    int select_free_vc(int vnet);
+    bool has_free_vc(int vnet, bool use_escape_vc = true);
+    int select_free_vc(int vnet, bool use_escape_vc = true);
+    int get_free_credits(int vnet);
 
     inline PortDirection get_direction() { return m_direction; }
 
@@ -117,8 +117,8 @@ Router::addInPort(PortDirection inport_dirn,
 
     input_unit->set_in_link(in_link);
     input_unit->set_credit_link(credit_link);
-    in_link->setLinkConsumer(this);
-    credit_link->setSourceQueue(input_unit->getCreditQueue());
+    in_link->setLinkConsumer(this, this);
+    credit_link->setSourceQueue(input_unit->getCreditQueue(), this);
 
     m_input_unit.push_back(input_unit);
 
@@ -136,8 +136,8 @@ Router::addOutPort(PortDirection outport_dirn,
 
     output_unit->set_out_link(out_link);
     output_unit->set_credit_link(credit_link);
-    credit_link->setLinkConsumer(this);
-    out_link->setSourceQueue(output_unit->getOutQueue());
+    credit_link->setLinkConsumer(this, this);
+    out_link->setSourceQueue(output_unit->getOutQueue(), this);
 
     m_output_unit.push_back(output_unit);
 
@@ -164,6 +164,18 @@ Router::route_compute(RouteInfo route, int inport, PortDirection inport_dirn)
     return m_routing_unit->outportCompute(route, inport, inport_dirn);
 }
 
+bool
+Router::may_use_escape_vc(const RouteInfo &route, int outport)
+{
+    return m_routing_unit->mayUseEscapeVC(route, outport);
+}
+
+int
+Router::escape_outport(const RouteInfo &route)
+{
+    return m_routing_unit->escapeOutport(route);
+}
+
 void
 Router::grant_switch(int inport, flit *t_flit)
 {
@@ -216,6 +228,16 @@ Router::regStats()
         .name(name() + ".sw_output_arbiter_activity")
         .flags(Stats::nozero)
     ;
+
+    m_adaptive_routes
+        .name(name() + ".adaptive_routes")
+        .flags(Stats::nozero)
+    ;
+
+    m_escape_vc_fallbacks
+        .name(name() + ".escape_vc_fallbacks")
+        .flags(Stats::nozero)
+    ;
 }
 
 void
@@ -231,6 +253,8 @@ Router::collateStats()
     m_sw_input_arbiter_activity = m_sw_alloc->get_input_arbiter_activity();
     m_sw_output_arbiter_activity = m_sw_alloc->get_output_arbiter_activity();
     m_crossbar_activity = m_switch->get_crossbar_activity();
+    m_adaptive_routes = m_routing_unit->get_adaptive_routes();
+    m_escape_vc_fallbacks = m_sw_alloc->get_escape_vc_fallbacks();
 }
 
 void
@@ -244,6 +268,7 @@ Router::resetStats()
 
     m_switch->resetStats();
     m_sw_alloc->resetStats();
+    m_routing_unit->resetStats();
 }
 
 void
@@ -92,6 +92,8 @@ class Router : public BasicRouter, public Consumer
     PortDirection getInportDirection(int inport);
 
     int route_compute(RouteInfo route, int inport, PortDirection direction);
+    bool may_use_escape_vc(const RouteInfo &route, int outport);
+    int escape_outport(const RouteInfo &route);
     void grant_switch(int inport, flit *t_flit);
     void schedule_wakeup(Cycles time);
 
@@ -135,6 +137,9 @@ class Router : public BasicRouter, public Consumer
     Stats::Scalar m_sw_output_arbiter_activity;
 
     Stats::Scalar m_crossbar_activity;
+
+    Stats::Scalar m_adaptive_routes;
+    Stats::Scalar m_escape_vc_fallbacks;
 };
 
 #endif // __MEM_RUBY_NETWORK_GARNET2_0_ROUTER_HH__
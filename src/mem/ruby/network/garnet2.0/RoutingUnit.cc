@@ -36,6 +36,7 @@
 #include "base/cast.hh"
 #include "base/logging.hh"
 #include "mem/ruby/network/garnet2.0/InputUnit.hh"
+#include "mem/ruby/network/garnet2.0/OutputUnit.hh"
 #include "mem/ruby/network/garnet2.0/Router.hh"
 #include "mem/ruby/slicc_interface/Message.hh"
 
@@ -44,6 +45,7 @@ RoutingUnit::RoutingUnit(Router *router)
     m_router = router;
     m_routing_table.clear();
     m_weight_table.clear();
+    m_adaptive_routes = 0;
 }
 
 void
@@ -164,6 +166,12 @@ RoutingUnit::outportCompute(RouteInfo route, int inport,
         // any custom algorithm
         case CUSTOM_: outport =
             outportComputeCustom(route, inport, inport_dirn); break;
+        case WEST_FIRST_: outport =
+            outportComputeWestFirst(route, inport, inport_dirn); break;
+        case ODD_EVEN_: outport =
+            outportComputeOddEven(route, inport, inport_dirn); break;
+        case ADAPTIVE_: outport =
+            outportComputeAdaptive(route, inport, inport_dirn); break;
         default: outport =
             lookupRoutingTable(route.vnet, route.net_dest); break;
     }
@@ -240,3 +248,171 @@ RoutingUnit::outportComputeCustom(RouteInfo route,
 {
     panic("%s placeholder executed", __FUNCTION__);
 }
+
+// Among several minimal outports, select the one with the most free
+// buffer slots in the downstream VCs of this vnet (congestion-aware
+// selection). Ties are broken by the order of the candidates.
+int
+RoutingUnit::selectOutport(const std::vector<PortDirection> &candidates,
+                           int vnet)
+{
+    assert(!candidates.empty());
+    if (candidates.size() == 1)
+        return m_outports_dirn2idx[candidates[0]];
+
+    m_adaptive_routes++;
+
+    std::vector<OutputUnit *> &output_units = m_router->get_outputUnit_ref();
+    int best_outport = -1;
+    int best_credits = -1;
+    for (auto dirn : candidates) {
+        int outport = m_outports_dirn2idx[dirn];
+        int credits = output_units[outport]->get_free_credits(vnet);
+        if (credits > best_credits) {
+            best_outport = outport;
+            best_credits = credits;
+        }
+    }
+    return best_outport;
+}
+
+// West-first routing: packets that have to go west do so first. All
+// other packets are routed adaptively among the minimal directions.
+// Deadlock-free since no turn into the west direction is allowed.
+int
+RoutingUnit::outportComputeWestFirst(RouteInfo route,
+                                     int inport,
+                                     PortDirection inport_dirn)
+{
+    // keep point-to-point ordering
+    if (m_router->get_net_ptr()->isVNetOrdered(route.vnet))
+        return outportComputeXY(route, inport, inport_dirn);
+
+    int num_cols = m_router->get_net_ptr()->getNumCols();
+    int my_id = m_router->get_id();
+    int x_offset = (route.dest_router % num_cols) - (my_id % num_cols);
+    int y_offset = (route.dest_router / num_cols) - (my_id / num_cols);
+
+    std::vector<PortDirection> candidates;
+    if (x_offset < 0) {
+        candidates.push_back("West");
+    } else {
+        if (x_offset > 0)
+            candidates.push_back("East");
+        if (y_offset > 0)
+            candidates.push_back("North");
+        else if (y_offset < 0)
+            candidates.push_back("South");
+    }
+
+    return selectOutport(candidates, route.vnet);
+}
+
+// Odd-even routing (Chiu): east-north and east-south turns are not
+// allowed in even columns, north-west and south-west turns are not
+// allowed in odd columns. Deadlock-free without extra VCs.
+int
+RoutingUnit::outportComputeOddEven(RouteInfo route,
+                                   int inport,
+                                   PortDirection inport_dirn)
+{
+    // keep point-to-point ordering
+    if (m_router->get_net_ptr()->isVNetOrdered(route.vnet))
+        return outportComputeXY(route, inport, inport_dirn);
+
+    int num_cols = m_router->get_net_ptr()->getNumCols();
+    int my_id = m_router->get_id();
+    int my_x = my_id % num_cols;
+    int src_x = route.src_router % num_cols;
+    int dest_x = route.dest_router % num_cols;
+    int x_offset = dest_x - my_x;
+    int y_offset = (route.dest_router / num_cols) - (my_id / num_cols);
+    PortDirection y_dirn = (y_offset > 0) ? "North" : "South";
+
+    std::vector<PortDirection> candidates;
+    if (x_offset == 0) {
+        candidates.push_back(y_dirn);
+    } else if (x_offset > 0) {
+        if (y_offset == 0) {
+            candidates.push_back("East");
+        } else {
+            if ((my_x % 2) == 1 || my_x == src_x)
+                candidates.push_back(y_dirn);
+            if ((dest_x % 2) == 1 || x_offset != 1)
+                candidates.push_back("East");
+        }
+    } else {
+        candidates.push_back("West");
+        if ((my_x % 2) == 0 && y_offset != 0)
+            candidates.push_back(y_dirn);
+    }
+
+    return selectOutport(candidates, route.vnet);
+}
+
+// Fully adaptive minimal routing. Deadlock freedom is provided by the
+// escape VCs, which are only used along the XY route (see
+// mayUseEscapeVC). Requires at least two VCs per vnet.
+int
+RoutingUnit::outportComputeAdaptive(RouteInfo route,
+                                    int inport,
+                                    PortDirection inport_dirn)
+{
+    // keep point-to-point ordering
+    if (m_router->get_net_ptr()->isVNetOrdered(route.vnet))
+        return outportComputeXY(route, inport, inport_dirn);
+
+    int num_cols = m_router->get_net_ptr()->getNumCols();
+    int my_id = m_router->get_id();
+    int x_offset = (route.dest_router % num_cols) - (my_id % num_cols);
+    int y_offset = (route.dest_router / num_cols) - (my_id / num_cols);
+
+    std::vector<PortDirection> candidates;
+    if (x_offset > 0)
+        candidates.push_back("East");
+    else if (x_offset < 0)
+        candidates.push_back("West");
+    if (y_offset > 0)
+        candidates.push_back("North");
+    else if (y_offset < 0)
+        candidates.push_back("South");
+
+    return selectOutport(candidates, route.vnet);
+}
+
+// The XY outport towards the destination, independent of the inport
+int
+RoutingUnit::escapeOutport(const RouteInfo &route)
+{
+    int num_cols = m_router->get_net_ptr()->getNumCols();
+    int my_id = m_router->get_id();
+    int x_offset = (route.dest_router % num_cols) - (my_id % num_cols);
+    int y_offset = (route.dest_router / num_cols) - (my_id / num_cols);
+    assert(x_offset != 0 || y_offset != 0);
+
+    if (x_offset > 0)
+        return m_outports_dirn2idx["East"];
+    if (x_offset < 0)
+        return m_outports_dirn2idx["West"];
+    return m_outports_dirn2idx[(y_offset > 0) ? "North" : "South"];
+}
+
+bool
+RoutingUnit::mayUseEscapeVC(const RouteInfo &route, int outport)
+{
+    RoutingAlgorithm routing_algorithm =
+        (RoutingAlgorithm) m_router->get_net_ptr()->getRoutingAlgorithm();
+    if (routing_algorithm != ADAPTIVE_ ||
+        route.dest_router == m_router->get_id() ||
+        m_router->get_net_ptr()->isVNetOrdered(route.vnet)) {
+        return true;
+    }
+
+    return outport == escapeOutport(route);
+}
+
+void
+RoutingUnit::resetStats()
+{
+    m_adaptive_routes = 0;
+}
@@ -72,9 +72,35 @@ class RoutingUnit
                              int inport,
                              PortDirection inport_dirn);
 
+    // Minimal adaptive routing for Mesh
+    int outportComputeWestFirst(RouteInfo route,
+                                int inport,
+                                PortDirection inport_dirn);
+    int outportComputeOddEven(RouteInfo route,
+                              int inport,
+                              PortDirection inport_dirn);
+    int outportComputeAdaptive(RouteInfo route,
+                               int inport,
+                               PortDirection inport_dirn);
+
+    // VC classes for fully adaptive routing: the first VC of each vnet
+    // is an escape VC that may only be used along the XY route
+    bool mayUseEscapeVC(const RouteInfo &route, int outport);
+    int escapeOutport(const RouteInfo &route);
+
+    inline double get_adaptive_routes() { return m_adaptive_routes; }
+    void resetStats();
+
   private:
+    // Select the candidate whose downstream VCs have the most credits
+    int selectOutport(const std::vector<PortDirection> &candidates,
+                      int vnet);
+
     Router *m_router;
 
+    // Route computations with more than one candidate outport
+    double m_adaptive_routes;
+
     // Routing Table
     std::vector<NetDest> m_routing_table;
     std::vector<int> m_weight_table;
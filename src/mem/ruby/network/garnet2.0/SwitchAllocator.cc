@@ -38,6 +38,7 @@
 #include "mem/ruby/network/garnet2.0/InputUnit.hh"
 #include "mem/ruby/network/garnet2.0/OutputUnit.hh"
 #include "mem/ruby/network/garnet2.0/Router.hh"
+#include "mem/ruby/network/garnet2.0/flit.hh"
 
 SwitchAllocator::SwitchAllocator(Router *router)
     : Consumer(router)
@@ -48,6 +49,9 @@ SwitchAllocator::SwitchAllocator(Router *router)
 
     m_input_arbiter_activity = 0;
     m_output_arbiter_activity = 0;
+    m_escape_vc_fallbacks = 0;
+    m_num_requests = 0;
+    m_escape_vcs = false;
 }
 
 void
@@ -58,9 +62,12 @@ SwitchAllocator::init()
 
     m_num_inports = m_router->get_num_inports();
     m_num_outports = m_router->get_num_outports();
+    m_escape_vcs =
+        m_router->get_net_ptr()->getRoutingAlgorithm() == ADAPTIVE_;
     m_round_robin_inport.resize(m_num_outports);
     m_round_robin_invc.resize(m_num_inports);
     m_port_requests.resize(m_num_outports);
+    m_num_port_requests.resize(m_num_outports, 0);
     m_vc_winners.resize(m_num_outports);
 
     for (int i = 0; i < m_num_inports; i++) {
@@ -86,12 +93,20 @@ SwitchAllocator::init()
  * There is no separate VCAllocator stage like the one in garnet1.0.
  * At the end of this function, the router is rescheduled to wakeup
  * next cycle for peforming SA for any flits ready next cycle.
+ *
+ * If no input VC could place a request, all flits waiting for SA are
+ * blocked on a free output VC or on credits. Both can only change when
+ * a credit arrives, which wakes up the router anyway. Thus, the router
+ * is not rescheduled in this case and stays idle until then.
  */
 
 void
 SwitchAllocator::wakeup()
 {
     arbitrate_inports(); // First stage of allocation
+    if (m_num_requests == 0)
+        return;
+
     arbitrate_outports(); // Second stage of allocation
 
     clear_request_vector();
@@ -114,6 +129,10 @@ SwitchAllocator::arbitrate_inports()
     // Select a VC from each input in a round robin manner
     // Independent arbiter at each input port
     for (int inport = 0; inport < m_num_inports; inport++) {
+        // nothing to arbitrate for at this inport
+        if (!m_input_unit[inport]->has_buffered_flits())
+            continue;
+
         int invc = m_round_robin_invc[inport];
 
         for (int invc_iter = 0; invc_iter < m_num_vcs; invc_iter++) {
@@ -126,6 +145,9 @@ SwitchAllocator::arbitrate_inports()
                 int  outport = m_input_unit[inport]->get_outport(invc);
                 int  outvc   = m_input_unit[inport]->get_outvc(invc);
 
+                if (outvc == -1 && m_escape_vcs)
+                    outport = escape_fallback(inport, invc, outport);
+
                 // check if the flit in this InputVC is allowed to be sent
                 // send_allowed conditions described in that function.
                 bool make_request =
@@ -135,6 +157,8 @@ SwitchAllocator::arbitrate_inports()
                     m_input_arbiter_activity++;
                     m_port_requests[outport][inport] = true;
                     m_vc_winners[outport][inport]= invc;
+                    m_num_port_requests[outport]++;
+                    m_num_requests++;
 
                     // Update Round Robin pointer
                     m_round_robin_invc[inport]++;
@@ -173,6 +197,10 @@ SwitchAllocator::arbitrate_outports()
     // Again do round robin arbitration on these requests
     // Independent arbiter at each output port
     for (int outport = 0; outport < m_num_outports; outport++) {
+        // no inport requested this outport
+        if (m_num_port_requests[outport] == 0)
+            continue;
+
         int inport = m_round_robin_inport[outport];
 
         for (int inport_iter = 0; inport_iter < m_num_inports;
@@ -250,6 +278,8 @@ SwitchAllocator::arbitrate_outports()
 
                 // remove this request
                 m_port_requests[outport][inport] = false;
+                m_num_port_requests[outport]--;
+                m_num_requests--;
 
                 // Update Round Robin pointer
                 m_round_robin_inport[outport]++;
@@ -296,7 +326,8 @@ SwitchAllocator::send_allowed(int inport, int invc, int outport, int outvc)
         // needs outvc
         // this is only true for HEAD and HEAD_TAIL flits.
 
-        if (m_output_unit[outport]->has_free_vc(vnet)) {
+        bool use_escape_vc = may_use_escape_vc(inport, invc, outport);
+        if (m_output_unit[outport]->has_free_vc(vnet, use_escape_vc)) {
 
             has_outvc = true;
 
@@ -342,7 +373,9 @@ int
 SwitchAllocator::vc_allocate(int outport, int inport, int invc)
 {
     // Select a free VC from the output port
-    int outvc = m_output_unit[outport]->select_free_vc(get_vnet(invc));
+    bool use_escape_vc = may_use_escape_vc(inport, invc, outport);
+    int outvc = m_output_unit[outport]->select_free_vc(get_vnet(invc),
+                                                       use_escape_vc);
 
     // has to get a valid VC since it checked before performing SA
     assert(outvc != -1);
@@ -350,6 +383,40 @@ SwitchAllocator::vc_allocate(int outport, int inport, int invc)
     return outvc;
 }
 
+// With fully adaptive routing, the escape VC of a vnet may only be
+// used if the packet continues along its XY route.
+bool
+SwitchAllocator::may_use_escape_vc(int inport, int invc, int outport)
+{
+    if (!m_escape_vcs)
+        return true;
+
+    RouteInfo route = m_input_unit[inport]->peekTopFlit(invc)->get_route();
+    return m_router->may_use_escape_vc(route, outport);
+}
+
+// If all adaptive VCs at the selected outport are busy, reroute the
+// head flit to the XY outport, provided that a VC is free there.
+// This guarantees progress and thus deadlock freedom (Duato).
+int
+SwitchAllocator::escape_fallback(int inport, int invc, int outport)
+{
+    int vnet = get_vnet(invc);
+    if (may_use_escape_vc(inport, invc, outport) ||
+        m_output_unit[outport]->has_free_vc(vnet, false)) {
+        return outport;
+    }
+
+    RouteInfo route = m_input_unit[inport]->peekTopFlit(invc)->get_route();
+    int escape_outport = m_router->escape_outport(route);
+    if (!m_output_unit[escape_outport]->has_free_vc(vnet))
+        return outport;
+
+    m_input_unit[inport]->grant_outport(invc, escape_outport);
+    m_escape_vc_fallbacks++;
+    return escape_outport;
+}
+
 // Wakeup the router next cycle to perform SA again
 // if there are flits ready.
 void
@@ -358,6 +425,9 @@ SwitchAllocator::check_for_wakeup()
     Cycles nextCycle = m_router->curCycle() + Cycles(1);
 
     for (int i = 0; i < m_num_inports; i++) {
+        if (!m_input_unit[i]->has_buffered_flits())
+            continue;
+
         for (int j = 0; j < m_num_vcs; j++) {
             if (m_input_unit[i]->need_stage(j, SA_, nextCycle)) {
                 m_router->schedule_wakeup(Cycles(1));
@@ -382,10 +452,15 @@ void
 SwitchAllocator::clear_request_vector()
 {
     for (int i = 0; i < m_num_outports; i++) {
+        if (m_num_port_requests[i] == 0)
+            continue;
+
         for (int j = 0; j < m_num_inports; j++) {
             m_port_requests[i][j] = false;
         }
+        m_num_port_requests[i] = 0;
     }
+    m_num_requests = 0;
 }
 
 void
@@ -393,4 +468,5 @@ SwitchAllocator::resetStats()
 {
     m_input_arbiter_activity = 0;
     m_output_arbiter_activity = 0;
+    m_escape_vc_fallbacks = 0;
 }
\ No newline at end of file
@@ -58,6 +58,8 @@ class SwitchAllocator : public Consumer
     void arbitrate_outports();
     bool send_allowed(int inport, int invc, int outport, int outvc);
     int vc_allocate(int outport, int inport, int invc);
+    bool may_use_escape_vc(int inport, int invc, int outport);
+    int escape_fallback(int inport, int invc, int outport);
 
     inline double
     get_input_arbiter_activity()
@@ -69,6 +71,11 @@ class SwitchAllocator : public Consumer
     {
         return m_output_arbiter_activity;
     }
+    inline double
+    get_escape_vc_fallbacks()
+    {
+        return m_escape_vc_fallbacks;
+    }
 
     void resetStats();
 
@@ -77,11 +84,18 @@ class SwitchAllocator : public Consumer
     int m_num_vcs, m_vc_per_vnet;
 
     double m_input_arbiter_activity, m_output_arbiter_activity;
+    double m_escape_vc_fallbacks;
+
+    // Escape VCs are restricted to the XY route (fully adaptive routing)
+    bool m_escape_vcs;
 
     Router *m_router;
     std::vector<int> m_round_robin_invc;
     std::vector<int> m_round_robin_inport;
     std::vector<std::vector<bool>> m_port_requests;
+    // Number of pending requests per outport, and in total
+    std::vector<int> m_num_port_requests;
+    int m_num_requests;
     std::vector<std::vector<int>> m_vc_winners; // a list for each outport
     std::vector<InputUnit *> m_input_unit;
     std::vector<OutputUnit *> m_output_unit;
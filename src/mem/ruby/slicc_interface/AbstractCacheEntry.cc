@@ -28,6 +28,7 @@
 
 #include "mem/ruby/slicc_interface/AbstractCacheEntry.hh"
 
+#include "base/slab_allocator.hh"
 #include "base/trace.hh"
 #include "debug/RubyCache.hh"
 
@@ -42,6 +43,18 @@ AbstractCacheEntry::~AbstractCacheEntry()
 {
 }
 
+void *
+AbstractCacheEntry::operator new(size_t size)
+{
+    return SlabAllocator::forSize(size).allocate();
+}
+
+void
+AbstractCacheEntry::operator delete(void *ptr, size_t size)
+{
+    SlabAllocator::forSize(size).deallocate(ptr);
+}
+
 void
 AbstractCacheEntry::changePermission(AccessPermission new_perm)
 {
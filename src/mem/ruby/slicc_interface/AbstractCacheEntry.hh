@@ -48,6 +48,11 @@ class AbstractCacheEntry : public AbstractEntry
     AbstractCacheEntry();
     virtual ~AbstractCacheEntry() = 0;
 
+    // Cache entries are allocated from slabs, one per entry size, to
+    // avoid a heap allocation per entry and to keep them close together
+    static void *operator new(size_t size);
+    static void operator delete(void *ptr, size_t size);
+
     // Get/Set permission of the entry
     void changePermission(AccessPermission new_perm);
 
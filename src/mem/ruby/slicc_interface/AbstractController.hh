@@ -116,6 +116,20 @@ class AbstractController : public MemObject, public Consumer
     virtual void enqueuePrefetch(const Addr &, const RubyRequestType&)
     { fatal("Prefetches not implemented!");}
 
+    //! Functions for restoring the cache contents of a checkpoint by
+    //! installing the recorded lines directly in a stable state, instead
+    //! of replaying the accesses. installCacheLine is called on all
+    //! controllers for every recorded line. If test is set, it only
+    //! checks whether the line can be installed without conflicting with
+    //! the state of this controller.
+    virtual bool supportsCacheLineInstall() { return false; }
+    virtual bool installCacheLine(const Addr &addr,
+                                  const RubyRequestType &type,
+                                  const DataBlock &data,
+                                  const MachineID &requestor,
+                                  const bool &test)
+    { fatal("Cache line installation not implemented!"); }
+
     //! Function for collating statistics from all the controllers of this
     //! particular type. This function should only be called from the
     //! version 0 of this controller type.
@@ -195,6 +209,8 @@ class AbstractController : public MemObject, public Consumer
     const int m_transitions_per_cycle;
     const unsigned int m_buffer_size;
     Cycles m_recycle_latency;
+    //! Account the host time spent in each transition
+    const bool m_profile_transitions;
 
     //! Counter for the number of cycles when the transitions carried out
     //! were equal to the maximum allowed
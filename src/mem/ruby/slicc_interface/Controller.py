@@ -58,6 +58,8 @@ class RubyController(MemObject):
     buffer_size = Param.UInt32(0, "max buffer size 0 means infinite")
 
     recycle_latency = Param.Cycles(10, "")
+    profile_transitions = Param.Bool(False, "Account the host time spent "
+                                     "in each state machine transition")
     number_of_TBEs = Param.Int(256, "")
     ruby_system = Param.RubySystem("")
 
@@ -30,34 +30,46 @@
 #define __MEM_RUBY_SLICC_INTERFACE_MESSAGE_HH__
 
 #include <iostream>
-#include <memory>
 #include <stack>
 
+#include "base/refcnt.hh"
+#include "base/slab_allocator.hh"
 #include "mem/packet.hh"
 #include "mem/protocol/MessageSizeType.hh"
 #include "mem/ruby/common/NetDest.hh"
 
 class Message;
-typedef std::shared_ptr<Message> MsgPtr;
+typedef RefCountingPtr<Message> MsgPtr;
 
-class Message
+/**
+ * Messages are reference counted without atomic operations and are
+ * allocated from slabs, one per message size, to keep allocations off
+ * the hot path of the controllers.
+ */
+class Message : public RefCounted
 {
   public:
     Message(Tick curTime)
         : m_time(curTime),
           m_LastEnqueueTime(curTime),
-          m_DelayedTicks(0), m_msg_counter(0)
+          m_DelayedTicks(0), m_msg_counter(0),
+          m_next_stalled(nullptr)
     { }
 
     Message(const Message &other)
-        : m_time(other.m_time),
+        : RefCounted(),
+          m_time(other.m_time),
           m_LastEnqueueTime(other.m_LastEnqueueTime),
           m_DelayedTicks(other.m_DelayedTicks),
-          m_msg_counter(other.m_msg_counter)
+          m_msg_counter(other.m_msg_counter),
+          m_next_stalled(nullptr)
     { }
 
     virtual ~Message() { }
 
+    static void *operator new(size_t size);
+    static void operator delete(void *ptr, size_t size);
+
     virtual MsgPtr clone() const = 0;
     virtual void print(std::ostream& out) const = 0;
 
@@ -112,6 +124,10 @@ class Message
     // Variables for required network traversal
     int incoming_link;
     int vnet;
+
+    // Next message in the stall list of a MessageBuffer
+    friend class MessageBuffer;
+    Message *m_next_stalled;
 };
 
 inline bool
@@ -126,6 +142,18 @@ operator>(const MsgPtr &lhs, const MsgPtr &rhs)
     return l->getLastEnqueueTime() > r->getLastEnqueueTime();
 }
 
+inline void *
+Message::operator new(size_t size)
+{
+    return SlabAllocator::forSize(size).allocate();
+}
+
+inline void
+Message::operator delete(void *ptr, size_t size)
+{
+    SlabAllocator::forSize(size).deallocate(ptr);
+}
+
 inline std::ostream&
 operator<<(std::ostream& out, const Message& obj)
 {
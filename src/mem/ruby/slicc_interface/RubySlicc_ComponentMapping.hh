@@ -29,6 +29,7 @@
 #ifndef __MEM_RUBY_SLICC_INTERFACE_RUBYSLICC_COMPONENTMAPPINGS_HH__
 #define __MEM_RUBY_SLICC_INTERFACE_RUBYSLICC_COMPONENTMAPPINGS_HH__
 
+#include "base/intmath.hh"
 #include "mem/protocol/MachineType.hh"
 #include "mem/ruby/common/Address.hh"
 #include "mem/ruby/common/MachineID.hh"
@@ -59,6 +60,16 @@ mapAddressToRange(Addr addr, MachineType type, int low_bit,
     return mach;
 }
 
+// Maps addr to one of the banks of the given type, assuming that all of
+// them are interleaved at low_bit, as done by mapAddressToRange with
+// floorLog2(machineCount(type)) select bits.
+inline MachineID
+mapAddressToBank(Addr addr, MachineType type, int low_bit)
+{
+    return mapAddressToRange(addr, type, low_bit,
+                             floorLog2(MachineType_base_count(type)));
+}
+
 inline NodeID
 machineIDToNodeID(MachineID machID)
 {
@@ -85,6 +85,7 @@ CacheMemory::init()
 
     m_cache.resize(m_cache_num_sets,
                     std::vector<AbstractCacheEntry*>(m_cache_assoc, nullptr));
+    m_tags.resize(m_cache_num_sets * m_cache_assoc, MaxAddr);
 }
 
 CacheMemory::~CacheMemory()
@@ -112,13 +113,10 @@ CacheMemory::addressToCacheSet(Addr address) const
 int
 CacheMemory::findTagInSet(int64_t cacheSet, Addr tag) const
 {
-    assert(tag == makeLineAddress(tag));
-    // search the set for the tags
-    auto it = m_tag_index.find(tag);
-    if (it != m_tag_index.end())
-        if (m_cache[cacheSet][it->second]->m_Permission !=
-            AccessPermission_NotPresent)
-            return it->second;
+    int loc = findTagInSetIgnorePermissions(cacheSet, tag);
+    if (loc != -1 &&
+        m_cache[cacheSet][loc]->m_Permission != AccessPermission_NotPresent)
+        return loc;
     return -1; // Not found
 }
 
@@ -130,9 +128,11 @@ CacheMemory::findTagInSetIgnorePermissions(int64_t cacheSet,
 {
     assert(tag == makeLineAddress(tag));
     // search the set for the tags
-    auto it = m_tag_index.find(tag);
-    if (it != m_tag_index.end())
-        return it->second;
+    const Addr *tags = &m_tags[cacheSet * m_cache_assoc];
+    for (int i = 0; i < m_cache_assoc; i++) {
+        if (tags[i] == tag)
+            return i;
+    }
     return -1; // Not found
 }
 
@@ -277,7 +277,7 @@ CacheMemory::allocate(Addr address, AbstractCacheEntry *entry, bool touch)
             DPRINTF(RubyCache, "Allocate clearing lock for addr: %x\n",
                     address);
             set[i]->m_locked = -1;
-            m_tag_index[address] = i;
+            m_tags[cacheSet * m_cache_assoc + i] = address;
             entry->setSetIndex(cacheSet);
             entry->setWayIndex(i);
 
@@ -302,7 +302,7 @@ CacheMemory::deallocate(Addr address)
     if (loc != -1) {
         delete m_cache[cacheSet][loc];
         m_cache[cacheSet][loc] = NULL;
-        m_tag_index.erase(address);
+        m_tags[cacheSet * m_cache_assoc + loc] = MaxAddr;
     }
 }
 
@@ -30,6 +30,7 @@
 #include "mem/ruby/system/CacheRecorder.hh"
 
 #include "debug/RubyCacheTrace.hh"
+#include "mem/ruby/slicc_interface/AbstractController.hh"
 #include "mem/ruby/system/RubySystem.hh"
 #include "mem/ruby/system/Sequencer.hh"
 
@@ -148,6 +149,58 @@ CacheRecorder::enqueueNextFetchRequest()
     }
 }
 
+void
+CacheRecorder::installRecords(std::vector<AbstractController*>& cntrls)
+{
+    uint64_t record_size = sizeof(TraceRecord) + m_block_size_bytes;
+    uint64_t installed = 0;
+    uint64_t skipped = 0;
+    DataBlock data;
+
+    // The trace is sorted by descending time, so that the most recently
+    // used lines are installed first.
+    for (; m_bytes_read < m_uncompressed_trace_size;
+           m_bytes_read += record_size) {
+        TraceRecord* traceRecord = (TraceRecord*) (m_uncompressed_trace +
+                                                                m_bytes_read);
+        MachineID requestor =
+            cntrls[traceRecord->m_cntrl_id]->getMachineID();
+
+        for (int rec_bytes_read = 0; rec_bytes_read < m_block_size_bytes;
+                rec_bytes_read += RubySystem::getBlockSizeBytes()) {
+            Addr addr = traceRecord->m_data_address + rec_bytes_read;
+            data.setData(traceRecord->m_data + rec_bytes_read, 0,
+                         RubySystem::getBlockSizeBytes());
+
+            bool accepted = true;
+            for (auto cntrl : cntrls) {
+                if (!cntrl->installCacheLine(addr, traceRecord->m_type, data,
+                                             requestor, true)) {
+                    accepted = false;
+                    break;
+                }
+            }
+
+            if (accepted) {
+                for (auto cntrl : cntrls) {
+                    cntrl->installCacheLine(addr, traceRecord->m_type, data,
+                                            requestor, false);
+                }
+                installed++;
+            } else {
+                DPRINTF(RubyCacheTrace, "Skipping %#x of %s\n",
+                        addr, *traceRecord);
+                skipped++;
+            }
+        }
+
+        m_records_read++;
+    }
+
+    DPRINTF(RubyCacheTrace, "Installed %d lines of %d records, skipped %d\n",
+            installed, m_records_read, skipped);
+}
+
 void
 CacheRecorder::addRecord(int cntrl, Addr data_addr, Addr pc_addr,
                          RubyRequestType type, Tick time, DataBlock& data)
@@ -43,6 +43,7 @@
 #include "mem/ruby/common/DataBlock.hh"
 #include "mem/ruby/common/TypeDefines.hh"
 
+class AbstractController;
 class Sequencer;
 
 /*!
@@ -97,6 +98,15 @@ class CacheRecorder
      */
     void enqueueNextFetchRequest();
 
+    /*!
+     * Function for warming up the caches without simulation. Each recorded
+     * line is installed directly into the controllers in a stable state,
+     * if all of them accept it. Lines that conflict with more recently
+     * used ones, e.g. because they do not fit into the cache anymore, are
+     * skipped.
+     */
+    void installRecords(std::vector<AbstractController*>& cntrls);
+
   private:
     // Private copy constructor and assignment operator
     CacheRecorder(const CacheRecorder& obj);
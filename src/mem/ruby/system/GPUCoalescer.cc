@@ -922,9 +922,9 @@ GPUCoalescer::issueRequest(PacketPtr pkt, RubyRequestType secondary_type)
             accessMask[tmpOffset + j] = true;
         }
     }
-    std::shared_ptr<RubyRequest> msg;
+    RefCountingPtr<RubyRequest> msg;
     if (pkt->isAtomicOp()) {
-        msg = std::make_shared<RubyRequest>(clockEdge(), pkt->getAddr(),
+        msg = new RubyRequest(clockEdge(), pkt->getAddr(),
                               pkt->getPtr<uint8_t>(),
                               pkt->getSize(), pc, secondary_type,
                               RubyAccessMode_Supervisor, pkt,
@@ -933,7 +933,7 @@ GPUCoalescer::issueRequest(PacketPtr pkt, RubyRequestType secondary_type)
                               dataBlock, atomicOps,
                               accessScope, accessSegment);
     } else {
-        msg = std::make_shared<RubyRequest>(clockEdge(), pkt->getAddr(),
+        msg = new RubyRequest(clockEdge(), pkt->getAddr(),
                               pkt->getPtr<uint8_t>(),
                               pkt->getSize(), pc, secondary_type,
                               RubyAccessMode_Supervisor, pkt,
@@ -58,7 +58,7 @@ bool RubySystem::m_cooldown_enabled = false;
 
 RubySystem::RubySystem(const Params *p)
     : ClockedObject(p), m_access_backing_store(p->access_backing_store),
-      m_cache_recorder(NULL)
+      m_install_cache_trace(p->install_cache_trace), m_cache_recorder(NULL)
 {
     m_randomization = p->randomization;
 
@@ -347,20 +347,18 @@ RubySystem::startup()
     // simulation starts. And then one also needs to hope that the time
     // Ruby finishes restoring the state is less than the time when the
     // state was checkpointed.
+    //
+    // If the protocol supports it, the recorded lines are instead installed
+    // directly into the controllers in stable states. This neither needs to
+    // reset the clock nor to simulate anything.
 
     if (m_warmup_enabled) {
-        DPRINTF(RubyCacheTrace, "Starting ruby cache warmup\n");
-        // save the current tick value
-        Tick curtick_original = curTick();
-        // save the event queue head
-        Event* eventq_head = eventq->replaceHead(NULL);
-        // set curTick to 0 and reset Ruby System's clock
-        setCurTick(0);
-        resetClock();
-
-        // Schedule an event to start cache warmup
-        enqueueRubyEvent(curTick());
-        simulate();
+        if (m_install_cache_trace && canInstallCacheTrace()) {
+            DPRINTF(RubyCacheTrace, "Installing ruby cache contents\n");
+            m_cache_recorder->installRecords(m_abs_cntrl_vec);
+        } else {
+            replayCacheTrace();
+        }
 
         delete m_cache_recorder;
         m_cache_recorder = NULL;
@@ -368,17 +366,44 @@ RubySystem::startup()
         if (m_systems_to_warmup == 0) {
             m_warmup_enabled = false;
         }
-
-        // Restore eventq head
-        eventq->replaceHead(eventq_head);
-        // Restore curTick and Ruby System's clock
-        setCurTick(curtick_original);
-        resetClock();
     }
 
     resetStats();
 }
 
+bool
+RubySystem::canInstallCacheTrace() const
+{
+    for (auto cntrl : m_abs_cntrl_vec) {
+        if (!cntrl->supportsCacheLineInstall())
+            return false;
+    }
+    return true;
+}
+
+void
+RubySystem::replayCacheTrace()
+{
+    DPRINTF(RubyCacheTrace, "Starting ruby cache warmup\n");
+    // save the current tick value
+    Tick curtick_original = curTick();
+    // save the event queue head
+    Event* eventq_head = eventq->replaceHead(NULL);
+    // set curTick to 0 and reset Ruby System's clock
+    setCurTick(0);
+    resetClock();
+
+    // Schedule an event to start cache warmup
+    enqueueRubyEvent(curTick());
+    simulate();
+
+    // Restore eventq head
+    eventq->replaceHead(eventq_head);
+    // Restore curTick and Ruby System's clock
+    setCurTick(curtick_original);
+    resetClock();
+}
+
 void
 RubySystem::processRubyEvent()
 {
@@ -117,6 +117,8 @@ class RubySystem : public ClockedObject
                                      uint64_t uncompressed_trace_size);
 
     void processRubyEvent();
+    bool canInstallCacheTrace() const;
+    void replayCacheTrace();
   private:
     // configuration parameters
     static bool m_randomization;
@@ -129,6 +131,7 @@ class RubySystem : public ClockedObject
     static bool m_cooldown_enabled;
     SimpleMemory *m_phys_mem;
     const bool m_access_backing_store;
+    const bool m_install_cache_trace;
 
     Network* m_network;
     std::vector<AbstractController *> m_abs_cntrl_vec;
@@ -47,6 +47,9 @@ class RubySystem(ClockedObject):
 
     access_backing_store = Param.Bool(False, "Use phys_mem as the functional \
         store and only use ruby for timing.")
+    install_cache_trace = Param.Bool(True, "Restore the cache contents of a \
+        checkpoint by installing them directly into the controllers if the \
+        protocol supports it, instead of replaying the recorded accesses.")
 
     # Profiler related configuration variables
     hot_lines = Param.Bool(False, "")
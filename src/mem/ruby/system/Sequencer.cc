@@ -57,6 +57,8 @@ Sequencer::Sequencer(const Params *p)
       deadlockCheckEvent([this]{ wakeup(); }, "Sequencer deadlock check")
 {
     m_outstanding_count = 0;
+    m_ppHit = nullptr;
+    m_ppMiss = nullptr;
 
     m_instCache_ptr = p->icache;
     m_dataCache_ptr = p->dcache;
@@ -91,39 +93,23 @@ Sequencer::wakeup()
     // Check across all outstanding requests
     int total_outstanding = 0;
 
-    RequestTable::iterator read = m_readRequestTable.begin();
-    RequestTable::iterator read_end = m_readRequestTable.end();
-    for (; read != read_end; ++read) {
-        SequencerRequest* request = read->second;
-        if (current_time - request->issue_time < m_deadlock_threshold)
-            continue;
-
-        panic("Possible Deadlock detected. Aborting!\n"
-              "version: %d request.paddr: 0x%x m_readRequestTable: %d "
-              "current time: %u issue_time: %d difference: %d\n", m_version,
-              request->pkt->getAddr(), m_readRequestTable.size(),
-              current_time * clockPeriod(), request->issue_time * clockPeriod(),
-              (current_time * clockPeriod()) - (request->issue_time * clockPeriod()));
-    }
-
-    RequestTable::iterator write = m_writeRequestTable.begin();
-    RequestTable::iterator write_end = m_writeRequestTable.end();
-    for (; write != write_end; ++write) {
-        SequencerRequest* request = write->second;
-        if (current_time - request->issue_time < m_deadlock_threshold)
-            continue;
-
-        panic("Possible Deadlock detected. Aborting!\n"
-              "version: %d request.paddr: 0x%x m_writeRequestTable: %d "
-              "current time: %u issue_time: %d difference: %d\n", m_version,
-              request->pkt->getAddr(), m_writeRequestTable.size(),
-              current_time * clockPeriod(), request->issue_time * clockPeriod(),
-              (current_time * clockPeriod()) - (request->issue_time * clockPeriod()));
+    for (const auto &table_entry : m_RequestTable) {
+        for (const auto &request : table_entry.second) {
+            if (current_time - request.issue_time < m_deadlock_threshold)
+                continue;
+
+            panic("Possible Deadlock detected. Aborting!\n"
+                  "version: %d request.paddr: 0x%x m_RequestTable: %d "
+                  "current time: %u issue_time: %d difference: %d\n",
+                  m_version, request.pkt->getAddr(), m_RequestTable.size(),
+                  current_time * clockPeriod(),
+                  request.issue_time * clockPeriod(),
+                  (current_time * clockPeriod()) -
+                  (request.issue_time * clockPeriod()));
+        }
+        total_outstanding += table_entry.second.size();
     }
 
-    total_outstanding += m_writeRequestTable.size();
-    total_outstanding += m_readRequestTable.size();
-
     assert(m_outstanding_count == total_outstanding);
 
     if (m_outstanding_count > 0) {
@@ -160,14 +146,42 @@ void Sequencer::resetStats()
     }
 }
 
-// Insert the request on the correct request table.  Return true if
-// the entry was already present.
-RequestStatus
-Sequencer::insertRequest(PacketPtr pkt, RubyRequestType request_type)
+static bool
+isReadRequest(RubyRequestType type)
 {
-    assert(m_outstanding_count ==
-        (m_writeRequestTable.size() + m_readRequestTable.size()));
+    return (type == RubyRequestType_LD) || (type == RubyRequestType_IFETCH);
+}
 
+// Requests that need the line for themselves and are therefore neither
+// queued behind other requests nor have others queued behind them.
+static bool
+isExclusiveRequest(RubyRequestType type)
+{
+    return (type == RubyRequestType_Locked_RMW_Read) ||
+           (type == RubyRequestType_Locked_RMW_Write) ||
+           (type == RubyRequestType_FLUSH);
+}
+
+// Whether the completion of a request of type 'issued' also completes a
+// later request of type 'type' to the same line. Fills with write
+// permission complete everything but instruction fetches, which need the
+// line in the instruction cache.
+static bool
+canCoalesce(RubyRequestType issued, RubyRequestType type)
+{
+    if (type == RubyRequestType_IFETCH || issued == RubyRequestType_IFETCH)
+        return type == issued;
+    if (issued == RubyRequestType_LD)
+        return type == RubyRequestType_LD;
+    return true;
+}
+
+// Insert the request into the queue of its line. Return Ready if it has
+// to be issued and Aliased if it waits for an earlier request to the line.
+RequestStatus
+Sequencer::insertRequest(PacketPtr pkt, RubyRequestType request_type,
+                         RubyRequestType secondary_type)
+{
     // See if we should schedule a deadlock check
     if (!deadlockCheckEvent.scheduled() &&
         drainState() != DrainState::Draining) {
@@ -179,69 +193,45 @@ Sequencer::insertRequest(PacketPtr pkt, RubyRequestType request_type)
     // Check if the line is blocked for a Locked_RMW
     if (m_controller->isBlocked(line_addr) &&
         (request_type != RubyRequestType_Locked_RMW_Write)) {
-        // Return that this request's cache line address aliases with
-        // a prior request that locked the cache line. The request cannot
-        // proceed until the cache line is unlocked by a Locked_RMW_Write
-        return RequestStatus_Aliased;
+        // The request cannot proceed until the cache line is unlocked by a
+        // Locked_RMW_Write. The CPU has to retry it.
+        return RequestStatus_BufferFull;
     }
 
-    // Create a default entry, mapping the address to NULL, the cast is
-    // there to make gcc 4.4 happy
-    RequestTable::value_type default_entry(line_addr,
-                                           (SequencerRequest*) NULL);
-
-    if ((request_type == RubyRequestType_ST) ||
-        (request_type == RubyRequestType_RMW_Read) ||
-        (request_type == RubyRequestType_RMW_Write) ||
-        (request_type == RubyRequestType_Load_Linked) ||
-        (request_type == RubyRequestType_Store_Conditional) ||
-        (request_type == RubyRequestType_Locked_RMW_Read) ||
-        (request_type == RubyRequestType_Locked_RMW_Write) ||
-        (request_type == RubyRequestType_FLUSH)) {
-
-        // Check if there is any outstanding read request for the same
-        // cache line.
-        if (m_readRequestTable.count(line_addr) > 0) {
-            m_store_waiting_on_load++;
-            return RequestStatus_Aliased;
-        }
-
-        pair<RequestTable::iterator, bool> r =
-            m_writeRequestTable.insert(default_entry);
-        if (r.second) {
-            RequestTable::iterator i = r.first;
-            i->second = new SequencerRequest(pkt, request_type, curCycle());
-            m_outstanding_count++;
+    auto table_entry = m_RequestTable.find(line_addr);
+    if (table_entry != m_RequestTable.end()) {
+        std::list<SequencerRequest> &requests = table_entry->second;
+        assert(!requests.empty());
+
+        bool pending_read = isReadRequest(requests.front().m_type);
+        if (isReadRequest(request_type)) {
+            if (pending_read)
+                m_load_waiting_on_load++;
+            else
+                m_load_waiting_on_store++;
         } else {
-          // There is an outstanding write request for the cache line
-          m_store_waiting_on_store++;
-          return RequestStatus_Aliased;
-        }
-    } else {
-        // Check if there is any outstanding write request for the same
-        // cache line.
-        if (m_writeRequestTable.count(line_addr) > 0) {
-            m_load_waiting_on_store++;
-            return RequestStatus_Aliased;
+            if (pending_read)
+                m_store_waiting_on_load++;
+            else
+                m_store_waiting_on_store++;
         }
 
-        pair<RequestTable::iterator, bool> r =
-            m_readRequestTable.insert(default_entry);
-
-        if (r.second) {
-            RequestTable::iterator i = r.first;
-            i->second = new SequencerRequest(pkt, request_type, curCycle());
-            m_outstanding_count++;
-        } else {
-            // There is an outstanding read request for the cache line
-            m_load_waiting_on_load++;
-            return RequestStatus_Aliased;
+        // the CPU has to retry these once the line is idle
+        if (isExclusiveRequest(request_type) ||
+            isExclusiveRequest(requests.front().m_type)) {
+            return RequestStatus_BufferFull;
         }
+
+        requests.emplace_back(pkt, request_type, secondary_type, curCycle());
+        m_outstanding_count++;
+        m_outstandReqHist.sample(m_outstanding_count);
+        return RequestStatus_Aliased;
     }
 
+    m_RequestTable[line_addr].emplace_back(pkt, request_type, secondary_type,
+                                           curCycle());
+    m_outstanding_count++;
     m_outstandReqHist.sample(m_outstanding_count);
-    assert(m_outstanding_count ==
-        (m_writeRequestTable.size() + m_readRequestTable.size()));
 
     return RequestStatus_Ready;
 }
@@ -250,8 +240,7 @@ void
 Sequencer::markRemoved()
 {
     m_outstanding_count--;
-    assert(m_outstanding_count ==
-           m_writeRequestTable.size() + m_readRequestTable.size());
+    assert(m_outstanding_count >= 0);
 }
 
 void
@@ -365,51 +354,88 @@ Sequencer::writeCallback(Addr address, DataBlock& data,
                          const Cycles firstResponseTime)
 {
     assert(address == makeLineAddress(address));
-    assert(m_writeRequestTable.count(makeLineAddress(address)));
-
-    RequestTable::iterator i = m_writeRequestTable.find(address);
-    assert(i != m_writeRequestTable.end());
-    SequencerRequest* request = i->second;
-
-    m_writeRequestTable.erase(i);
-    markRemoved();
-
-    assert((request->m_type == RubyRequestType_ST) ||
-           (request->m_type == RubyRequestType_ATOMIC) ||
-           (request->m_type == RubyRequestType_RMW_Read) ||
-           (request->m_type == RubyRequestType_RMW_Write) ||
-           (request->m_type == RubyRequestType_Load_Linked) ||
-           (request->m_type == RubyRequestType_Store_Conditional) ||
-           (request->m_type == RubyRequestType_Locked_RMW_Read) ||
-           (request->m_type == RubyRequestType_Locked_RMW_Write) ||
-           (request->m_type == RubyRequestType_FLUSH));
-
-    //
-    // For Alpha, properly handle LL, SC, and write requests with respect to
-    // locked cache blocks.
-    //
-    // Not valid for Garnet_standalone protocl
-    //
-    bool success = true;
-    if (!m_runningGarnetStandalone)
-        success = handleLlsc(address, request);
-
-    // Handle SLICC block_on behavior for Locked_RMW accesses. NOTE: the
-    // address variable here is assumed to be a line address, so when
-    // blocking buffers, must check line addresses.
-    if (request->m_type == RubyRequestType_Locked_RMW_Read) {
-        // blockOnQueue blocks all first-level cache controller queues
-        // waiting on memory accesses for the specified address that go to
-        // the specified queue. In this case, a Locked_RMW_Write must go to
-        // the mandatory_q before unblocking the first-level controller.
-        // This will block standard loads, stores, ifetches, etc.
-        m_controller->blockOnQueue(address, m_mandatory_q_ptr);
-    } else if (request->m_type == RubyRequestType_Locked_RMW_Write) {
-        m_controller->unblock(address);
+
+    RequestTable::iterator i = m_RequestTable.find(address);
+    assert(i != m_RequestTable.end());
+
+    // Complete the request that was sent to the cache and all later ones
+    // that the line in its current state satisfies as well
+    RubyRequestType issued_type = i->second.front().m_type;
+    bool coalesced = false;
+    for (;;) {
+        // the callbacks might have added other lines, invalidating 'i'
+        i = m_RequestTable.find(address);
+        assert(i != m_RequestTable.end());
+        std::list<SequencerRequest> &requests = i->second;
+        SequencerRequest *request = &requests.front();
+
+        if (coalesced && !canCoalesce(issued_type, request->m_type)) {
+            m_reissued_requests++;
+            issueRequest(request->pkt, request->m_second_type);
+            return;
+        }
+
+        assert((request->m_type == RubyRequestType_ST) ||
+               (request->m_type == RubyRequestType_ATOMIC) ||
+               (request->m_type == RubyRequestType_RMW_Read) ||
+               (request->m_type == RubyRequestType_RMW_Write) ||
+               (request->m_type == RubyRequestType_Load_Linked) ||
+               (request->m_type == RubyRequestType_Store_Conditional) ||
+               (request->m_type == RubyRequestType_Locked_RMW_Read) ||
+               (request->m_type == RubyRequestType_Locked_RMW_Write) ||
+               (request->m_type == RubyRequestType_FLUSH) ||
+               (coalesced && request->m_type == RubyRequestType_LD));
+
+        //
+        // For Alpha, properly handle LL, SC, and write requests with
+        // respect to locked cache blocks.
+        //
+        // Not valid for Garnet_standalone protocl
+        //
+        bool success = true;
+        if (!m_runningGarnetStandalone &&
+            request->m_type != RubyRequestType_LD)
+            success = handleLlsc(address, request);
+
+        // Handle SLICC block_on behavior for Locked_RMW accesses. NOTE: the
+        // address variable here is assumed to be a line address, so when
+        // blocking buffers, must check line addresses.
+        if (request->m_type == RubyRequestType_Locked_RMW_Read) {
+            // blockOnQueue blocks all first-level cache controller queues
+            // waiting on memory accesses for the specified address that go
+            // to the specified queue. In this case, a Locked_RMW_Write must
+            // go to the mandatory_q before unblocking the first-level
+            // controller. This will block standard loads, stores, ifetches,
+            // etc.
+            m_controller->blockOnQueue(address, m_mandatory_q_ptr);
+        } else if (request->m_type == RubyRequestType_Locked_RMW_Write) {
+            m_controller->unblock(address);
+        }
+
+        if (coalesced)
+            m_coalesced_requests++;
+
+        // Retire the request before the CPU sees the response: the callback
+        // retries blocked requests synchronously, and these must find the
+        // request gone and, once it was the last one, the line idle.
+        SequencerRequest done = *request;
+        requests.pop_front();
+        markRemoved();
+        bool last = requests.empty();
+        if (last)
+            m_RequestTable.erase(i);
+
+        hitCallback(&done, data, success, mach, externalHit,
+                    initialRequestTime, forwardRequestTime,
+                    firstResponseTime, coalesced);
+
+        // requests for this line issued by the callback went to the cache
+        if (last)
+            break;
+        coalesced = true;
     }
 
-    hitCallback(request, data, success, mach, externalHit,
-                initialRequestTime, forwardRequestTime, firstResponseTime);
+    testDrainComplete();
 }
 
 void
@@ -420,20 +446,55 @@ Sequencer::readCallback(Addr address, DataBlock& data,
                         Cycles firstResponseTime)
 {
     assert(address == makeLineAddress(address));
-    assert(m_readRequestTable.count(makeLineAddress(address)));
-
-    RequestTable::iterator i = m_readRequestTable.find(address);
-    assert(i != m_readRequestTable.end());
-    SequencerRequest* request = i->second;
 
-    m_readRequestTable.erase(i);
-    markRemoved();
+    RequestTable::iterator i = m_RequestTable.find(address);
+    assert(i != m_RequestTable.end());
+
+    // Complete the request that was sent to the cache and all later reads;
+    // the first write has to be sent to the cache, because it needs write
+    // permission
+    RubyRequestType issued_type = i->second.front().m_type;
+    bool coalesced = false;
+    for (;;) {
+        // the callbacks might have added other lines, invalidating 'i'
+        i = m_RequestTable.find(address);
+        assert(i != m_RequestTable.end());
+        std::list<SequencerRequest> &requests = i->second;
+        SequencerRequest *request = &requests.front();
+
+        if (coalesced && !canCoalesce(issued_type, request->m_type)) {
+            m_reissued_requests++;
+            issueRequest(request->pkt, request->m_second_type);
+            return;
+        }
 
-    assert((request->m_type == RubyRequestType_LD) ||
-           (request->m_type == RubyRequestType_IFETCH));
+        assert((request->m_type == RubyRequestType_LD) ||
+               (request->m_type == RubyRequestType_IFETCH));
+
+        if (coalesced)
+            m_coalesced_requests++;
+
+        // Retire the request before the CPU sees the response: the callback
+        // retries blocked requests synchronously, and these must find the
+        // request gone and, once it was the last one, the line idle.
+        SequencerRequest done = *request;
+        requests.pop_front();
+        markRemoved();
+        bool last = requests.empty();
+        if (last)
+            m_RequestTable.erase(i);
+
+        hitCallback(&done, data, true, mach, externalHit,
+                    initialRequestTime, forwardRequestTime,
+                    firstResponseTime, coalesced);
+
+        // requests for this line issued by the callback went to the cache
+        if (last)
+            break;
+        coalesced = true;
+    }
 
-    hitCallback(request, data, true, mach, externalHit,
-                initialRequestTime, forwardRequestTime, firstResponseTime);
+    testDrainComplete();
 }
 
 void
@@ -442,7 +503,8 @@ Sequencer::hitCallback(SequencerRequest* srequest, DataBlock& data,
                        const MachineType mach, const bool externalHit,
                        const Cycles initialRequestTime,
                        const Cycles forwardRequestTime,
-                       const Cycles firstResponseTime)
+                       const Cycles firstResponseTime,
+                       const bool wasCoalesced)
 {
     warn_once("Replacement policy updates recently became the responsibility "
               "of SLICC state machines. Make sure to setMRU() near callbacks "
@@ -456,10 +518,13 @@ Sequencer::hitCallback(SequencerRequest* srequest, DataBlock& data,
     assert(curCycle() >= issued_time);
     Cycles total_latency = curCycle() - issued_time;
 
-    // Profile the latency for all demand accesses.
-    recordMissLatency(total_latency, type, mach, externalHit, issued_time,
-                      initialRequestTime, forwardRequestTime,
-                      firstResponseTime, curCycle());
+    // Profile the latency for all demand accesses. Coalesced requests did
+    // not go through the cache hierarchy on their own.
+    if (!wasCoalesced) {
+        recordMissLatency(total_latency, type, mach, externalHit,
+                          issued_time, initialRequestTime, forwardRequestTime,
+                          firstResponseTime, curCycle());
+    }
 
     DPRINTFR(ProtocolTrace, "%15s %3s %10s%20s %6s>%-6s %#x %d cycles\n",
              curTick(), m_version, "Seq",
@@ -508,8 +573,6 @@ Sequencer::hitCallback(SequencerRequest* srequest, DataBlock& data,
         testerSenderState->subBlock.mergeFrom(data);
     }
 
-    delete srequest;
-
     RubySystem *rs = m_ruby_system;
     if (RubySystem::getWarmupEnabled()) {
         assert(pkt->req);
@@ -519,15 +582,19 @@ Sequencer::hitCallback(SequencerRequest* srequest, DataBlock& data,
         delete pkt;
         rs->m_cache_recorder->enqueueNextFlushRequest();
     } else {
+        // the packet is gone after the callback
+        if (externalHit && !wasCoalesced)
+            m_ppMiss->notify(pkt);
+        else
+            m_ppHit->notify(pkt);
         ruby_hit_callback(pkt);
-        testDrainComplete();
     }
 }
 
 bool
 Sequencer::empty() const
 {
-    return m_writeRequestTable.empty() && m_readRequestTable.empty();
+    return m_RequestTable.empty();
 }
 
 RequestStatus
@@ -610,7 +677,10 @@ Sequencer::makeRequest(PacketPtr pkt)
         }
     }
 
-    RequestStatus status = insertRequest(pkt, primary_type);
+    RequestStatus status = insertRequest(pkt, primary_type, secondary_type);
+    // aliased requests are queued behind an earlier request to the line
+    if (status == RequestStatus_Aliased)
+        return RequestStatus_Issued;
     if (status != RequestStatus_Ready)
         return status;
 
@@ -637,13 +707,13 @@ Sequencer::issueRequest(PacketPtr pkt, RubyRequestType secondary_type)
 
     // check if the packet has data as for example prefetch and flush
     // requests do not
-    std::shared_ptr<RubyRequest> msg =
-        std::make_shared<RubyRequest>(clockEdge(), pkt->getAddr(),
-                                      pkt->isFlush() ?
-                                      nullptr : pkt->getPtr<uint8_t>(),
-                                      pkt->getSize(), pc, secondary_type,
-                                      RubyAccessMode_Supervisor, pkt,
-                                      PrefetchBit_No, proc_id, core_id);
+    RefCountingPtr<RubyRequest> msg =
+        new RubyRequest(clockEdge(), pkt->getAddr(),
+                        pkt->isFlush() ?
+                        nullptr : pkt->getPtr<uint8_t>(),
+                        pkt->getSize(), pc, secondary_type,
+                        RubyAccessMode_Supervisor, pkt,
+                        PrefetchBit_No, proc_id, core_id);
 
     DPRINTFR(ProtocolTrace, "%15s %3s %10s%20s %6s>%-6s %#x %s\n",
             curTick(), m_version, "Seq", "Begin", "", "",
@@ -669,29 +739,18 @@ Sequencer::issueRequest(PacketPtr pkt, RubyRequestType secondary_type)
     m_mandatory_q_ptr->enqueue(msg, clockEdge(), cyclesToTicks(latency));
 }
 
-template <class KEY, class VALUE>
-std::ostream &
-operator<<(ostream &out, const std::unordered_map<KEY, VALUE> &map)
-{
-    auto i = map.begin();
-    auto end = map.end();
-
-    out << "[";
-    for (; i != end; ++i)
-        out << " " << i->first << "=" << i->second;
-    out << " ]";
-
-    return out;
-}
-
 void
 Sequencer::print(ostream& out) const
 {
     out << "[Sequencer: " << m_version
         << ", outstanding requests: " << m_outstanding_count
-        << ", read request table: " << m_readRequestTable
-        << ", write request table: " << m_writeRequestTable
-        << "]";
+        << ", request table: [";
+    for (const auto &table_entry : m_RequestTable) {
+        out << " " << table_entry.first << "=";
+        for (const auto &request : table_entry.second)
+            out << " " << RubyRequestType_to_string(request.m_type);
+    }
+    out << " ]]";
 }
 
 // this can be called from setState whenever coherence permissions are
@@ -739,6 +798,14 @@ Sequencer::regStats()
         .name(name() + ".load_waiting_on_store")
         .desc("Number of times a load aliased with a pending store")
         .flags(Stats::nozero);
+    m_coalesced_requests
+        .name(name() + ".coalesced_requests")
+        .desc("Number of requests completed by an earlier request's fill")
+        .flags(Stats::nozero);
+    m_reissued_requests
+        .name(name() + ".reissued_requests")
+        .desc("Number of queued requests sent after an earlier one")
+        .flags(Stats::nozero);
 
     // These statistical variables are not for display.
     // The profiler will collate these across different
@@ -792,3 +859,13 @@ Sequencer::regStats()
         }
     }
 }
+
+void
+Sequencer::regProbePoints()
+{
+    RubyPort::regProbePoints();
+
+    // same names as in the classic caches to use the same probes for both
+    m_ppHit = new ProbePointArg<PacketPtr>(getProbeManager(), "Hit");
+    m_ppMiss = new ProbePointArg<PacketPtr>(getProbeManager(), "Miss");
+}
@@ -30,6 +30,7 @@
 #define __MEM_RUBY_SYSTEM_SEQUENCER_HH__
 
 #include <iostream>
+#include <list>
 #include <unordered_map>
 
 #include "mem/protocol/MachineType.hh"
@@ -39,16 +40,19 @@
 #include "mem/ruby/structures/CacheMemory.hh"
 #include "mem/ruby/system/RubyPort.hh"
 #include "params/RubySequencer.hh"
+#include "sim/probe/probe.hh"
 
 struct SequencerRequest
 {
     PacketPtr pkt;
     RubyRequestType m_type;
+    RubyRequestType m_second_type;
     Cycles issue_time;
 
     SequencerRequest(PacketPtr _pkt, RubyRequestType _m_type,
-                     Cycles _issue_time)
-        : pkt(_pkt), m_type(_m_type), issue_time(_issue_time)
+                     RubyRequestType _m_second_type, Cycles _issue_time)
+        : pkt(_pkt), m_type(_m_type), m_second_type(_m_second_type),
+          issue_time(_issue_time)
     {}
 };
 
@@ -66,6 +70,7 @@ class Sequencer : public RubyPort
     void resetStats();
     void collateStats();
     void regStats();
+    void regProbePoints();
 
     void writeCallback(Addr address,
                        DataBlock& data,
@@ -156,7 +161,8 @@ class Sequencer : public RubyPort
                      const MachineType mach, const bool externalHit,
                      const Cycles initialRequestTime,
                      const Cycles forwardRequestTime,
-                     const Cycles firstResponseTime);
+                     const Cycles firstResponseTime,
+                     const bool wasCoalesced);
 
     void recordMissLatency(const Cycles t, const RubyRequestType type,
                            const MachineType respondingMach,
@@ -165,7 +171,8 @@ class Sequencer : public RubyPort
                            Cycles forwardRequestTime, Cycles firstResponseTime,
                            Cycles completionTime);
 
-    RequestStatus insertRequest(PacketPtr pkt, RubyRequestType request_type);
+    RequestStatus insertRequest(PacketPtr pkt, RubyRequestType request_type,
+                                RubyRequestType secondary_type);
     bool handleLlsc(Addr address, SequencerRequest* request);
 
     // Private copy constructor and assignment operator
@@ -186,10 +193,13 @@ class Sequencer : public RubyPort
     Cycles m_data_cache_hit_latency;
     Cycles m_inst_cache_hit_latency;
 
-    typedef std::unordered_map<Addr, SequencerRequest*> RequestTable;
-    RequestTable m_writeRequestTable;
-    RequestTable m_readRequestTable;
-    // Global outstanding request count, across all request tables
+    // All requests to a line, in the order the CPU issued them. Only the
+    // first one has been sent to the cache; the others are coalesced with
+    // it or sent once it completes.
+    typedef std::unordered_map<Addr, std::list<SequencerRequest>>
+        RequestTable;
+    RequestTable m_RequestTable;
+    // Global outstanding request count, across all lines
     int m_outstanding_count;
     bool m_deadlock_check_scheduled;
 
@@ -198,6 +208,14 @@ class Sequencer : public RubyPort
     Stats::Scalar m_store_waiting_on_store;
     Stats::Scalar m_load_waiting_on_store;
     Stats::Scalar m_load_waiting_on_load;
+    //! Requests completed by the fill of an earlier request to the line
+    Stats::Scalar m_coalesced_requests;
+    //! Requests sent to the cache after an earlier request to the line
+    Stats::Scalar m_reissued_requests;
+
+    //! Completed demand accesses that hit or missed in this controller
+    ProbePointArg<PacketPtr> *m_ppHit;
+    ProbePointArg<PacketPtr> *m_ppMiss;
 
     int m_coreId;
 
@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2016, Nils Asmussen
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#include "mem/sampled_stack_dist_calc.hh"
+
+#include <algorithm>
+#include <cassert>
+
+constexpr uint64_t SampledStackDistCalc::Infinity;
+constexpr uint64_t SampledStackDistCalc::Modulus;
+
+SampledStackDistCalc::SampledStackDistCalc(double rate, uint64_t max_samples)
+    : maxSamples(max_samples),
+      threshold(std::max<uint64_t>(1, rate * Modulus)),
+      now(0),
+      numEvicted(0),
+      tree(std::max<uint64_t>(1024, 4 * max_samples) + 1),
+      entries(),
+      byHash()
+{
+    assert(rate > 0 && rate <= 1);
+    threshold = std::min(threshold, Modulus);
+}
+
+uint64_t
+SampledStackDistCalc::hash(Addr addr)
+{
+    // MurmurHash3 finalizer; the sampling needs to be independent of the
+    // address pattern, so that strided accesses are sampled uniformly
+    uint64_t h = addr;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h % Modulus;
+}
+
+void
+SampledStackDistCalc::treeAdd(uint64_t time, int64_t val)
+{
+    for (; time < tree.size(); time += time & -time)
+        tree[time] += val;
+}
+
+uint64_t
+SampledStackDistCalc::treePrefix(uint64_t time) const
+{
+    int64_t sum = 0;
+    for (; time > 0; time -= time & -time)
+        sum += tree[time];
+    return sum;
+}
+
+void
+SampledStackDistCalc::compact()
+{
+    std::vector<Entry*> order;
+    order.reserve(entries.size());
+    for (auto &e : entries)
+        order.push_back(&e.second);
+    std::sort(order.begin(), order.end(),
+              [](const Entry *a, const Entry *b) { return a->time < b->time; });
+
+    // without a sample limit, the number of entries is unbounded. make
+    // sure that we don't compact too often.
+    size_t size = tree.size() - 1;
+    while (order.size() * 2 > size)
+        size *= 2;
+    tree.assign(size + 1, 0);
+
+    now = 0;
+    for (auto e : order)
+    {
+        e->time = ++now;
+        treeAdd(e->time, 1);
+    }
+}
+
+void
+SampledStackDistCalc::evict()
+{
+    while (entries.size() > maxSamples)
+    {
+        // the new threshold excludes the largest tracked hash value
+        threshold = byHash.rbegin()->first;
+
+        while (!byHash.empty() && byHash.rbegin()->first >= threshold)
+        {
+            auto it = std::prev(byHash.end());
+            auto entry = entries.find(it->second);
+            assert(entry != entries.end());
+
+            treeAdd(entry->second.time, -1);
+            entries.erase(entry);
+            byHash.erase(it);
+            numEvicted++;
+        }
+    }
+}
+
+SampledStackDistCalc::Result
+SampledStackDistCalc::calcStackDistAndUpdate(Addr addr)
+{
+    uint64_t h = hash(addr);
+    if (h >= threshold)
+        return Result{false, Infinity, 0};
+
+    // use the rate before a potential eviction; this access was sampled
+    // with it
+    const double r = rate();
+
+    if (now + 1 >= tree.size())
+        compact();
+
+    uint64_t dist = Infinity;
+    auto it = entries.find(addr);
+    if (it != entries.end())
+    {
+        uint64_t prev = it->second.time;
+        dist = treePrefix(tree.size() - 1) - treePrefix(prev);
+        treeAdd(prev, -1);
+        it->second.time = ++now;
+    }
+    else
+    {
+        entries.emplace(addr, Entry{++now, h});
+        if (maxSamples)
+            byHash.emplace(h, addr);
+    }
+    treeAdd(now, 1);
+
+    if (maxSamples && entries.size() > maxSamples)
+        evict();
+
+    if (dist != Infinity)
+        dist = static_cast<uint64_t>(dist / r);
+    return Result{true, dist, 1.0 / r};
+}
@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2016, Nils Asmussen
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#ifndef __MEM_SAMPLED_STACK_DIST_CALC_HH__
+#define __MEM_SAMPLED_STACK_DIST_CALC_HH__
+
+#include <cstdint>
+#include <limits>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "base/types.hh"
+
+/**
+ * The sampled stack distance calculator approximates stack distances
+ * using spatially hashed sampling (SHARDS, Waldspurger et al., FAST'15).
+ *
+ * An address is sampled if hash(addr) mod P < T, i.e., with rate R = T/P.
+ * For the sampled addresses, the exact stack distance among the sampled
+ * addresses is calculated and scaled by 1/R, which is an unbiased
+ * estimate of the stack distance in the full address stream.
+ *
+ * If a maximum number of samples is given (fixed-size SHARDS), the
+ * threshold T is lowered whenever more addresses are tracked than
+ * allowed. In this case, all addresses with the largest hash value are
+ * evicted. Thus, memory consumption is bounded independent of the
+ * footprint, whereas the sampling rate adapts to it.
+ *
+ * Stack distances of the sampled addresses are computed with a Fenwick
+ * tree over the access timestamps, which contains a one for the most
+ * recent access of each tracked address. The stack distance of an address
+ * is the number of ones after its previous timestamp. The timestamps are
+ * compacted once the tree is full.
+ */
+class SampledStackDistCalc
+{
+  public:
+
+    static constexpr uint64_t Infinity = std::numeric_limits<uint64_t>::max();
+
+    /** The modulus used for the hash-based sampling decision */
+    static constexpr uint64_t Modulus = 1 << 24;
+
+    struct Result
+    {
+        /** Whether the address has been sampled */
+        bool sampled;
+        /** The scaled stack distance (or Infinity) */
+        uint64_t distance;
+        /** The weight of this sample (1/R at the time of the access) */
+        double weight;
+    };
+
+    /**
+     * @param rate the initial sampling rate (0 < rate <= 1)
+     * @param max_samples the maximum number of tracked addresses (0 for
+     *                    no limit)
+     */
+    SampledStackDistCalc(double rate, uint64_t max_samples);
+
+    /**
+     * Determines the stack distance of the given address and records the
+     * access.
+     *
+     * @param addr the (aligned) address
+     * @return the result (see Result)
+     */
+    Result calcStackDistAndUpdate(Addr addr);
+
+    /**
+     * @return the current sampling rate
+     */
+    double rate() const { return static_cast<double>(threshold) / Modulus; }
+
+    /**
+     * @return the number of currently tracked addresses
+     */
+    uint64_t tracked() const { return entries.size(); }
+
+    /**
+     * @return the number of evicted addresses due to the sample limit
+     */
+    uint64_t evicted() const { return numEvicted; }
+
+    /**
+     * The hash function used for the sampling decision.
+     */
+    static uint64_t hash(Addr addr);
+
+  private:
+
+    struct Entry
+    {
+        uint64_t time;
+        uint64_t hash;
+    };
+
+    /** Adds val to the timestamp time in the Fenwick tree */
+    void treeAdd(uint64_t time, int64_t val);
+
+    /** Returns the number of ones in the timestamps [1, time] */
+    uint64_t treePrefix(uint64_t time) const;
+
+    /** Renumbers all timestamps (and grows the tree if required) */
+    void compact();
+
+    /** Lowers the threshold until at most maxSamples entries are left */
+    void evict();
+
+    const uint64_t maxSamples;
+
+    uint64_t threshold;
+
+    uint64_t now;
+
+    uint64_t numEvicted;
+
+    std::vector<int64_t> tree;
+
+    std::unordered_map<Addr, Entry> entries;
+
+    /** The tracked addresses ordered by hash (only with a sample limit) */
+    std::set<std::pair<uint64_t, Addr>> byHash;
+};
+
+#endif // __MEM_SAMPLED_STACK_DIST_CALC_HH__
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2016, Nils Asmussen
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are
+ * those of the authors and should not be interpreted as representing official
+ * policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#include <gtest/gtest.h>
+
+#include "mem/sampled_stack_dist_calc.hh"
+
+/** With a sampling rate of 1, the distances are exact */
+TEST(SampledStackDistCalcTest, Exact)
+{
+    SampledStackDistCalc calc(1.0, 0);
+
+    auto res = calc.calcStackDistAndUpdate(0x0);
+    ASSERT_TRUE(res.sampled);
+    ASSERT_EQ(res.distance, SampledStackDistCalc::Infinity);
+    ASSERT_EQ(res.weight, 1.0);
+
+    calc.calcStackDistAndUpdate(0x40);
+    calc.calcStackDistAndUpdate(0x80);
+    calc.calcStackDistAndUpdate(0x40);
+
+    // 0x40 and 0x80 have been accessed since then
+    ASSERT_EQ(calc.calcStackDistAndUpdate(0x0).distance, 2);
+    // immediate reuse
+    ASSERT_EQ(calc.calcStackDistAndUpdate(0x0).distance, 0);
+    // 0x40 and 0x0
+    ASSERT_EQ(calc.calcStackDistAndUpdate(0x80).distance, 2);
+    ASSERT_EQ(calc.tracked(), 3);
+}
+
+/** Timestamps are compacted without changing the distances */
+TEST(SampledStackDistCalcTest, Compaction)
+{
+    SampledStackDistCalc calc(1.0, 0);
+
+    const Addr lines = 100;
+    for (Addr a = 0; a < lines; ++a)
+        calc.calcStackDistAndUpdate(a * 64);
+
+    // cyclic accesses over all lines; each reuse has a distance of lines-1
+    for (int i = 0; i < 100; ++i)
+    {
+        for (Addr a = 0; a < lines; ++a)
+        {
+            auto res = calc.calcStackDistAndUpdate(a * 64);
+            ASSERT_EQ(res.distance, lines - 1);
+        }
+    }
+}
+
+/** Only addresses with a hash below the threshold are sampled */
+TEST(SampledStackDistCalcTest, Sampling)
+{
+    const double rate = 0.1;
+    SampledStackDistCalc calc(rate, 0);
+
+    uint64_t sampled = 0;
+    const Addr lines = 100000;
+    for (Addr a = 0; a < lines; ++a)
+    {
+        auto res = calc.calcStackDistAndUpdate(a * 64);
+        ASSERT_EQ(res.sampled,
+                  SampledStackDistCalc::hash(a * 64) <
+                  rate * SampledStackDistCalc::Modulus);
+        sampled += res.sampled;
+    }
+
+    ASSERT_NEAR(sampled, lines * rate, lines * rate * 0.05);
+    ASSERT_EQ(calc.tracked(), sampled);
+}
+
+/** The scaled distances estimate the real distances */
+TEST(SampledStackDistCalcTest, ScaledDistance)
+{
+    SampledStackDistCalc calc(0.05, 0);
+
+    const Addr lines = 20000;
+    for (int i = 0; i < 2; ++i)
+    {
+        double sum = 0;
+        uint64_t count = 0;
+        for (Addr a = 0; a < lines; ++a)
+        {
+            auto res = calc.calcStackDistAndUpdate(a * 64);
+            if (i == 1 && res.sampled)
+            {
+                sum += res.distance;
+                count++;
+            }
+        }
+
+        if (i == 1) {
+            ASSERT_NEAR(sum / count, lines - 1, (lines - 1) * 0.1);
+        }
+    }
+}
+
+/** With a sample limit, the number of tracked addresses is bounded */
+TEST(SampledStackDistCalcTest, FixedSize)
+{
+    const uint64_t max = 128;
+    SampledStackDistCalc calc(1.0, max);
+
+    for (Addr a = 0; a < 100000; ++a)
+    {
+        auto res = calc.calcStackDistAndUpdate(a * 64);
+        ASSERT_LE(calc.tracked(), max);
+        if (res.sampled) {
+            ASSERT_GE(res.weight, 1.0);
+        }
+    }
+
+    ASSERT_LT(calc.rate(), 1.0);
+    ASSERT_GT(calc.evicted(), 0);
+    // the rate has been adapted to the footprint
+    ASSERT_NEAR(calc.rate() * 100000, max, max * 0.5);
+}
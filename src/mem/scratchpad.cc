@@ -122,6 +122,21 @@ Scratchpad::ScratchpadPort::recvAtomic(PacketPtr pkt)
     return scratchpad.recvAtomic(pkt);
 }
 
+Tick
+Scratchpad::ScratchpadPort::recvAtomicBackdoor(PacketPtr pkt,
+                                               MemBackdoorPtr &backdoor)
+{
+    Tick latency = scratchpad.recvAtomic(pkt);
+
+    // we accept requests outside of our range (see recvAtomic), but the
+    // backdoor is only valid for the memory itself
+    AddrRange pktRange(pkt->getAddr(), pkt->getAddr() + pkt->getSize() - 1);
+    if (pktRange.isSubset(scratchpad.getAddrRange()))
+        scratchpad.getBackdoor(backdoor);
+
+    return latency;
+}
+
 Scratchpad*
 ScratchpadParams::create()
 {
@@ -53,6 +53,9 @@ class Scratchpad : public AbstractMemory
 
         Tick recvAtomic(PacketPtr pkt) override;
 
+        Tick recvAtomicBackdoor(PacketPtr pkt,
+                                MemBackdoorPtr &backdoor) override;
+
         AddrRangeList getAddrRanges() const override;
     };
 
@@ -271,6 +271,15 @@ SimpleMemory::MemoryPort::recvAtomic(PacketPtr pkt)
     return memory.recvAtomic(pkt);
 }
 
+Tick
+SimpleMemory::MemoryPort::recvAtomicBackdoor(PacketPtr pkt,
+                                             MemBackdoorPtr &_backdoor)
+{
+    Tick latency = memory.recvAtomic(pkt);
+    memory.getBackdoor(_backdoor);
+    return latency;
+}
+
 void
 SimpleMemory::MemoryPort::recvFunctional(PacketPtr pkt)
 {
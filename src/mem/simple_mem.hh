@@ -97,6 +97,8 @@ class SimpleMemory : public AbstractMemory
 
         Tick recvAtomic(PacketPtr pkt);
 
+        Tick recvAtomicBackdoor(PacketPtr pkt, MemBackdoorPtr &_backdoor);
+
         void recvFunctional(PacketPtr pkt);
 
         bool recvTimingReq(PacketPtr pkt);
@@ -47,6 +47,9 @@ class SLICC(Grammar):
         self.symtab = SymbolTable(self)
         self.base_dir = base_dir
 
+        # don't leave a parsetab.py behind in the working directory
+        self.setupParserFactory(write_tables=False)
+
         try:
             self.decl_list = self.parse_file(filename, **kwargs)
         except ParseError, e:
@@ -214,7 +214,7 @@ class StateMachine(Symbol):
         self.printControllerPython(path)
         self.printControllerHH(path)
         self.printControllerCC(path, includes)
-        self.printCSwitch(path)
+        self.printCSwitch(path, includes)
         self.printCWakeup(path, includes)
 
     def printControllerPython(self, path):
@@ -291,6 +291,12 @@ class $py_ident(RubyController):
         code('''
 extern std::stringstream ${ident}_transitionComment;
 
+#ifndef NDEBUG
+#define APPEND_TRANSITION_COMMENT(str) (${ident}_transitionComment << str)
+#else
+#define APPEND_TRANSITION_COMMENT(str) do {} while (0)
+#endif
+
 class $c_ident : public AbstractController
 {
   public:
@@ -320,6 +326,8 @@ class $c_ident : public AbstractController
     uint64_t getEventCount(${ident}_Event event);
     bool isPossible(${ident}_State state, ${ident}_Event event);
     uint64_t getTransitionCount(${ident}_State state, ${ident}_Event event);
+    uint64_t getTransitionHostTime(${ident}_State state,
+                                   ${ident}_Event event);
 
 private:
 ''')
@@ -368,9 +376,12 @@ TransitionResult doTransitionWorker(${ident}_Event event,
 int m_counters[${ident}_State_NUM][${ident}_Event_NUM];
 int m_event_counters[${ident}_Event_NUM];
 bool m_possible[${ident}_State_NUM][${ident}_Event_NUM];
+// host nanoseconds spent in each transition, if profiled
+uint64_t m_host_time[${ident}_State_NUM][${ident}_Event_NUM];
 
 static std::vector<Stats::Vector *> eventVec;
 static std::vector<std::vector<Stats::Vector *> > transVec;
+static std::vector<std::vector<Stats::Vector *> > hostTimeVec;
 static int m_num_controllers;
 
 // Internal functions
@@ -502,16 +513,11 @@ ${c_ident}Params::create()
 int $c_ident::m_num_controllers = 0;
 std::vector<Stats::Vector *>  $c_ident::eventVec;
 std::vector<std::vector<Stats::Vector *> >  $c_ident::transVec;
+std::vector<std::vector<Stats::Vector *> >  $c_ident::hostTimeVec;
 
 // for adding information to the protocol debug trace
 stringstream ${ident}_transitionComment;
 
-#ifndef NDEBUG
-#define APPEND_TRANSITION_COMMENT(str) (${ident}_transitionComment << str)
-#else
-#define APPEND_TRANSITION_COMMENT(str) do {} while (0)
-#endif
-
 /** \\brief constructor */
 $c_ident::$c_ident(const Params *p)
     : AbstractController(p)
@@ -550,6 +556,7 @@ for (int state = 0; state < ${ident}_State_NUM; state++) {
     for (int event = 0; event < ${ident}_Event_NUM; event++) {
         m_possible[state][event] = false;
         m_counters[state][event] = 0;
+        m_host_time[state][event] = 0;
     }
 }
 for (int event = 0; event < ${ident}_Event_NUM; event++) {
@@ -773,6 +780,27 @@ $c_ident::regStats()
                 transVec[state].push_back(t);
             }
         }
+
+        if (m_profile_transitions) {
+            for (${ident}_State state = ${ident}_State_FIRST;
+                 state < ${ident}_State_NUM; ++state) {
+
+                hostTimeVec.push_back(std::vector<Stats::Vector *>());
+
+                for (${ident}_Event event = ${ident}_Event_FIRST;
+                     event < ${ident}_Event_NUM; ++event) {
+
+                    Stats::Vector *t = new Stats::Vector();
+                    t->init(m_num_controllers);
+                    t->name(params()->ruby_system->name() + ".${c_ident}." +
+                            "host_time." + ${ident}_State_to_string(state) +
+                            "." + ${ident}_Event_to_string(event));
+                    t->desc("Host nanoseconds spent in the transition");
+                    t->flags(Stats::total | Stats::oneline | Stats::nozero);
+                    hostTimeVec[state].push_back(t);
+                }
+            }
+        }
     }
 }
 
@@ -804,6 +832,11 @@ $c_ident::collateStats()
                 assert(it != rs->m_abstract_controls[MachineType_${ident}].end());
                 (*transVec[state][event])[i] =
                     (($c_ident *)(*it).second)->getTransitionCount(state, event);
+                if (m_profile_transitions) {
+                    (*hostTimeVec[state][event])[i] =
+                        (($c_ident *)(*it).second)->getTransitionHostTime(
+                            state, event);
+                }
             }
         }
     }
@@ -842,6 +875,13 @@ $c_ident::getTransitionCount(${ident}_State state,
     return m_counters[state][event];
 }
 
+uint64_t
+$c_ident::getTransitionHostTime(${ident}_State state,
+                                ${ident}_Event event)
+{
+    return m_host_time[state][event];
+}
+
 int
 $c_ident::getNumControllers()
 {
@@ -871,6 +911,7 @@ void $c_ident::resetStats()
     for (int state = 0; state < ${ident}_State_NUM; state++) {
         for (int event = 0; event < ${ident}_Event_NUM; event++) {
             m_counters[state][event] = 0;
+            m_host_time[state][event] = 0;
         }
     }
 
@@ -934,74 +975,6 @@ $c_ident::recordCacheTrace(int cntrl, CacheRecorder* tr)
         code.dedent()
         code('''
 }
-
-// Actions
-''')
-        if self.TBEType != None and self.EntryType != None:
-            for action in self.actions.itervalues():
-                if "c_code" not in action:
-                 continue
-
-                code('''
-/** \\brief ${{action.desc}} */
-void
-$c_ident::${{action.ident}}(${{self.TBEType.c_ident}}*& m_tbe_ptr, ${{self.EntryType.c_ident}}*& m_cache_entry_ptr, Addr addr)
-{
-    DPRINTF(RubyGenerated, "executing ${{action.ident}}\\n");
-    try {
-       ${{action["c_code"]}}
-    } catch (const RejectException & e) {
-       fatal("Error in action ${{ident}}:${{action.ident}}: "
-             "executed a peek statement with the wrong message "
-             "type specified. ");
-    }
-}
-
-''')
-        elif self.TBEType != None:
-            for action in self.actions.itervalues():
-                if "c_code" not in action:
-                 continue
-
-                code('''
-/** \\brief ${{action.desc}} */
-void
-$c_ident::${{action.ident}}(${{self.TBEType.c_ident}}*& m_tbe_ptr, Addr addr)
-{
-    DPRINTF(RubyGenerated, "executing ${{action.ident}}\\n");
-    ${{action["c_code"]}}
-}
-
-''')
-        elif self.EntryType != None:
-            for action in self.actions.itervalues():
-                if "c_code" not in action:
-                 continue
-
-                code('''
-/** \\brief ${{action.desc}} */
-void
-$c_ident::${{action.ident}}(${{self.EntryType.c_ident}}*& m_cache_entry_ptr, Addr addr)
-{
-    DPRINTF(RubyGenerated, "executing ${{action.ident}}\\n");
-    ${{action["c_code"]}}
-}
-
-''')
-        else:
-            for action in self.actions.itervalues():
-                if "c_code" not in action:
-                 continue
-
-                code('''
-/** \\brief ${{action.desc}} */
-void
-$c_ident::${{action.ident}}(Addr addr)
-{
-    DPRINTF(RubyGenerated, "executing ${{action.ident}}\\n");
-    ${{action["c_code"]}}
-}
-
 ''')
         for func in self.functions:
             code(func.generateCode())
@@ -1157,33 +1130,235 @@ ${ident}_Controller::wakeup()
 
         code.write(path, "%s_Wakeup.cc" % self.ident)
 
-    def printCSwitch(self, path):
-        '''Output switch statement for transition table'''
+    def printActions(self, code):
+        '''Output the actions. They are only called by the transitions and
+        defined in the same file, so that they can be inlined there.'''
+
+        ident = self.ident
+        c_ident = "%s_Controller" % self.ident
+
+        if self.TBEType != None and self.EntryType != None:
+            for action in self.actions.itervalues():
+                if "c_code" not in action:
+                 continue
+
+                code('''
+/** \\brief ${{action.desc}} */
+inline void
+$c_ident::${{action.ident}}(${{self.TBEType.c_ident}}*& m_tbe_ptr, ${{self.EntryType.c_ident}}*& m_cache_entry_ptr, Addr addr)
+{
+    DPRINTF(RubyGenerated, "executing ${{action.ident}}\\n");
+    try {
+       ${{action["c_code"]}}
+    } catch (const RejectException & e) {
+       fatal("Error in action ${{ident}}:${{action.ident}}: "
+             "executed a peek statement with the wrong message "
+             "type specified. ");
+    }
+}
+
+''')
+        elif self.TBEType != None:
+            for action in self.actions.itervalues():
+                if "c_code" not in action:
+                 continue
+
+                code('''
+/** \\brief ${{action.desc}} */
+inline void
+$c_ident::${{action.ident}}(${{self.TBEType.c_ident}}*& m_tbe_ptr, Addr addr)
+{
+    DPRINTF(RubyGenerated, "executing ${{action.ident}}\\n");
+    ${{action["c_code"]}}
+}
+
+''')
+        elif self.EntryType != None:
+            for action in self.actions.itervalues():
+                if "c_code" not in action:
+                 continue
+
+                code('''
+/** \\brief ${{action.desc}} */
+inline void
+$c_ident::${{action.ident}}(${{self.EntryType.c_ident}}*& m_cache_entry_ptr, Addr addr)
+{
+    DPRINTF(RubyGenerated, "executing ${{action.ident}}\\n");
+    ${{action["c_code"]}}
+}
+
+''')
+        else:
+            for action in self.actions.itervalues():
+                if "c_code" not in action:
+                 continue
+
+                code('''
+/** \\brief ${{action.desc}} */
+inline void
+$c_ident::${{action.ident}}(Addr addr)
+{
+    DPRINTF(RubyGenerated, "executing ${{action.ident}}\\n");
+    ${{action["c_code"]}}
+}
+
+''')
+
+    def printCSwitch(self, path, includes):
+        '''Output the transition table and the code of the transitions'''
 
         code = self.symtab.codeFormatter()
         ident = self.ident
 
+        # The code of all transitions. Transitions with the same code share
+        # the same block, which are numbered starting with 1.
+        cases = orderdict()
+        case_index = {}
+
+        for trans in self.transitions:
+            case = self.symtab.codeFormatter()
+            # Only set next_state if it changes
+            if trans.state != trans.nextState:
+                if trans.nextState.isWildcard():
+                    # When * is encountered as an end state of a transition,
+                    # the next state is determined by calling the
+                    # machine-specific getNextState function. The next state
+                    # is determined before any actions of the transition
+                    # execute, and therefore the next state calculation cannot
+                    # depend on any of the transitionactions.
+                    case('next_state = getNextState(addr);')
+                else:
+                    ns_ident = trans.nextState.ident
+                    case('next_state = ${ident}_State_${ns_ident};')
+
+            actions = trans.actions
+            request_types = trans.request_types
+
+            # Check for resources
+            case_sorter = []
+            res = trans.resources
+            for key,val in res.iteritems():
+                val = '''
+if (!%s.areNSlotsAvailable(%s, clockEdge()))
+    return TransitionResult_ResourceStall;
+''' % (key.code, val)
+                case_sorter.append(val)
+
+            # Check all of the request_types for resource constraints
+            for request_type in request_types:
+                val = '''
+if (!checkResourceAvailable(%s_RequestType_%s, addr)) {
+    return TransitionResult_ResourceStall;
+}
+''' % (self.ident, request_type.ident)
+                case_sorter.append(val)
+
+            # Emit the code sequences in a sorted order.  This makes the
+            # output deterministic (without this the output order can vary
+            # since Map's keys() on a vector of pointers is not deterministic
+            for c in sorted(case_sorter):
+                case("$c")
+
+            # Record access types for this transition
+            for request_type in request_types:
+                case('recordRequestType(${ident}_RequestType_${{request_type.ident}}, addr);')
+
+            # Figure out if we stall
+            stall = False
+            for action in actions:
+                if action.ident == "z_stall":
+                    stall = True
+                    break
+
+            if stall:
+                case('return TransitionResult_ProtocolStall;')
+            else:
+                if self.TBEType != None and self.EntryType != None:
+                    for action in actions:
+                        case('${{action.ident}}(m_tbe_ptr, m_cache_entry_ptr, addr);')
+                elif self.TBEType != None:
+                    for action in actions:
+                        case('${{action.ident}}(m_tbe_ptr, addr);')
+                elif self.EntryType != None:
+                    for action in actions:
+                        case('${{action.ident}}(m_cache_entry_ptr, addr);')
+                else:
+                    for action in actions:
+                        case('${{action.ident}}(addr);')
+                case('return TransitionResult_Valid;')
+
+            case = str(case)
+
+            # Look to see if this transition code is unique.
+            if case not in cases:
+                cases[case] = []
+
+            cases[case].append(trans)
+
+        for i, case in enumerate(cases.iterkeys()):
+            for trans in cases[case]:
+                case_index[(trans.state.ident, trans.event.ident)] = i + 1
+
+        if len(cases) < 256:
+            table_type = "uint8_t"
+        else:
+            table_type = "uint16_t"
+
         code('''
 // Auto generated C++ code started by $__file__:$__line__
 // ${ident}: ${{self.short}}
 
 #include <cassert>
+#include <chrono>
 
+#include "base/compiler.hh"
+#include "base/cprintf.hh"
 #include "base/logging.hh"
 #include "base/trace.hh"
+#include "mem/ruby/common/BoolVec.hh"
+
+''')
+        for f in self.debug_flags:
+            code('#include "debug/${{f}}.hh"')
+        code('''
 #include "debug/ProtocolTrace.hh"
-#include "debug/RubyGenerated.hh"
 #include "mem/protocol/${ident}_Controller.hh"
 #include "mem/protocol/${ident}_Event.hh"
 #include "mem/protocol/${ident}_State.hh"
 #include "mem/protocol/Types.hh"
+#include "mem/ruby/network/Network.hh"
 #include "mem/ruby/system/RubySystem.hh"
 
-#define HASH_FUN(state, event)  ((int(state)*${ident}_Event_NUM)+int(event))
+''')
+        for include_path in includes:
+            code('#include "${{include_path}}"')
+
+        code('''
+
+using namespace std;
 
 #define GET_TRANSITION_COMMENT() (${ident}_transitionComment.str())
 #define CLEAR_TRANSITION_COMMENT() (${ident}_transitionComment.str(""))
 
+// The code block of each (state, event) pair, 0 if the pair is invalid
+static const $table_type
+transitionTable[${ident}_State_NUM][${ident}_Event_NUM] = {
+''')
+        code.indent()
+        for state in self.states.itervalues():
+            row = [ str(case_index.get((state.ident, event.ident), 0))
+                    for event in self.events.itervalues() ]
+            code('// ${{state.ident}}')
+            code('{ ${{", ".join(row)}} },')
+        code.dedent()
+        code('''
+};
+
+// Actions
+''')
+        self.printActions(code)
+
+        code('''
 TransitionResult
 ${ident}_Controller::doTransition(${ident}_Event event,
 ''')
@@ -1210,6 +1385,15 @@ ${ident}_Controller::doTransition(${ident}_Event event,
         else:
             code('${ident}_State state = getState(addr);')
 
+        if self.TBEType != None and self.EntryType != None:
+            worker = 'doTransitionWorker(event, state, next_state, m_tbe_ptr, m_cache_entry_ptr, addr)'
+        elif self.TBEType != None:
+            worker = 'doTransitionWorker(event, state, next_state, m_tbe_ptr, addr)'
+        elif self.EntryType != None:
+            worker = 'doTransitionWorker(event, state, next_state, m_cache_entry_ptr, addr)'
+        else:
+            worker = 'doTransitionWorker(event, state, next_state, addr)'
+
         code('''
 ${ident}_State next_state = state;
 
@@ -1217,16 +1401,18 @@ DPRINTF(RubyGenerated, "%s, Time: %lld, state: %s, event: %s, addr: %#x\\n",
         *this, curCycle(), ${ident}_State_to_string(state),
         ${ident}_Event_to_string(event), addr);
 
-TransitionResult result =
+TransitionResult result;
+if (m_profile_transitions) {
+    auto start = std::chrono::steady_clock::now();
+    result = $worker;
+    auto end = std::chrono::steady_clock::now();
+    m_host_time[state][event] +=
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            end - start).count();
+} else {
+    result = $worker;
+}
 ''')
-        if self.TBEType != None and self.EntryType != None:
-            code('doTransitionWorker(event, state, next_state, m_tbe_ptr, m_cache_entry_ptr, addr);')
-        elif self.TBEType != None:
-            code('doTransitionWorker(event, state, next_state, m_tbe_ptr, addr);')
-        elif self.EntryType != None:
-            code('doTransitionWorker(event, state, next_state, m_cache_entry_ptr, addr);')
-        else:
-            code('doTransitionWorker(event, state, next_state, addr);')
 
         port_to_buf_map, in_msg_bufs, msg_bufs = self.getBufferMaps(ident)
 
@@ -1300,102 +1486,16 @@ ${ident}_Controller::doTransitionWorker(${ident}_Event event,
         code('''
                                         Addr addr)
 {
-    switch(HASH_FUN(state, event)) {
+    switch (transitionTable[state][event]) {
 ''')
 
-        # This map will allow suppress generating duplicate code
-        cases = orderdict()
-
-        for trans in self.transitions:
-            case_string = "%s_State_%s, %s_Event_%s" % \
-                (self.ident, trans.state.ident, self.ident, trans.event.ident)
-
-            case = self.symtab.codeFormatter()
-            # Only set next_state if it changes
-            if trans.state != trans.nextState:
-                if trans.nextState.isWildcard():
-                    # When * is encountered as an end state of a transition,
-                    # the next state is determined by calling the
-                    # machine-specific getNextState function. The next state
-                    # is determined before any actions of the transition
-                    # execute, and therefore the next state calculation cannot
-                    # depend on any of the transitionactions.
-                    case('next_state = getNextState(addr);')
-                else:
-                    ns_ident = trans.nextState.ident
-                    case('next_state = ${ident}_State_${ns_ident};')
-
-            actions = trans.actions
-            request_types = trans.request_types
-
-            # Check for resources
-            case_sorter = []
-            res = trans.resources
-            for key,val in res.iteritems():
-                val = '''
-if (!%s.areNSlotsAvailable(%s, clockEdge()))
-    return TransitionResult_ResourceStall;
-''' % (key.code, val)
-                case_sorter.append(val)
-
-            # Check all of the request_types for resource constraints
-            for request_type in request_types:
-                val = '''
-if (!checkResourceAvailable(%s_RequestType_%s, addr)) {
-    return TransitionResult_ResourceStall;
-}
-''' % (self.ident, request_type.ident)
-                case_sorter.append(val)
-
-            # Emit the code sequences in a sorted order.  This makes the
-            # output deterministic (without this the output order can vary
-            # since Map's keys() on a vector of pointers is not deterministic
-            for c in sorted(case_sorter):
-                case("$c")
-
-            # Record access types for this transition
-            for request_type in request_types:
-                case('recordRequestType(${ident}_RequestType_${{request_type.ident}}, addr);')
-
-            # Figure out if we stall
-            stall = False
-            for action in actions:
-                if action.ident == "z_stall":
-                    stall = True
-                    break
-
-            if stall:
-                case('return TransitionResult_ProtocolStall;')
-            else:
-                if self.TBEType != None and self.EntryType != None:
-                    for action in actions:
-                        case('${{action.ident}}(m_tbe_ptr, m_cache_entry_ptr, addr);')
-                elif self.TBEType != None:
-                    for action in actions:
-                        case('${{action.ident}}(m_tbe_ptr, addr);')
-                elif self.EntryType != None:
-                    for action in actions:
-                        case('${{action.ident}}(m_cache_entry_ptr, addr);')
-                else:
-                    for action in actions:
-                        case('${{action.ident}}(addr);')
-                case('return TransitionResult_Valid;')
-
-            case = str(case)
-
-            # Look to see if this transition code is unique.
-            if case not in cases:
-                cases[case] = []
-
-            cases[case].append(case_string)
-
         # Walk through all of the unique code blocks and spit out the
         # corresponding case statement elements
-        for case,transitions in cases.iteritems():
-            # Iterative over all the multiple transitions that share
-            # the same code
-            for trans in transitions:
-                code('  case HASH_FUN($trans):')
+        for i, case in enumerate(cases.iterkeys()):
+            # List the transitions that share the same code
+            for trans in cases[case]:
+                code('  // ${{trans.state.ident}}, ${{trans.event.ident}}')
+            code('  case ${{i + 1}}:')
             code('    $case\n')
 
         code('''
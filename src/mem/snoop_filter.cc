@@ -386,6 +386,32 @@ SnoopFilter::updateResponse(const Packet* cpkt, const SlavePort& slave_port)
             __func__, sf_item.requested, sf_item.holder);
 }
 
+void
+SnoopFilter::insertHolder(Addr addr, bool is_secure,
+                          const SlavePort& slave_port)
+{
+    if (!slave_port.isSnooping())
+        return;
+
+    Addr line_addr = addr & ~Addr(linesize - 1);
+    if (is_secure) {
+        line_addr |= LineSecure;
+    }
+
+    auto sf_it = cachedLocations.find(line_addr);
+    panic_if(sf_it == cachedLocations.end() &&
+             cachedLocations.size() >= maxEntryCount,
+             "snoop filter exceeded capacity of %d cache blocks\n",
+             maxEntryCount);
+    if (sf_it == cachedLocations.end())
+        sf_it = cachedLocations.emplace(line_addr, SnoopItem()).first;
+
+    sf_it->second.holder |= portToMask(slave_port);
+    DPRINTF(SnoopFilter, "%s: %s holds %#llx, SF value %x.%x\n",
+            __func__, slave_port.name(), addr,
+            sf_it->second.requested, sf_it->second.holder);
+}
+
 void
 SnoopFilter::regStats()
 {
@@ -192,6 +192,17 @@ class SnoopFilter : public SimObject {
      */
     void updateResponse(const Packet *cpkt, const SlavePort& slave_port);
 
+    /**
+     * Record that the caches behind the given port hold a line, which
+     * they got without a request passing the snoop filter, i.e., by
+     * functional warming.
+     *
+     * @param addr       Address of the line.
+     * @param is_secure  Whether the line is secure.
+     * @param slave_port SlavePort of the caches that hold the line.
+     */
+    void insertHolder(Addr addr, bool is_secure, const SlavePort& slave_port);
+
     virtual void regStats();
 
   protected:
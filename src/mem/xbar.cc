@@ -49,6 +49,7 @@
 
 #include "mem/xbar.hh"
 
+#include "base/intmath.hh"
 #include "base/logging.hh"
 #include "base/trace.hh"
 #include "debug/AddrRanges.hh"
@@ -61,11 +62,29 @@ BaseXBar::BaseXBar(const BaseXBarParams *p)
       forwardLatency(p->forward_latency),
       responseLatency(p->response_latency),
       width(p->width),
+      layersPerPort(p->layers_per_port),
+      layerInterleave(p->layer_interleave),
+      layerFrequencyRatio(p->layer_frequency_ratio),
+      decodeCache(p->decode_cache_entries,
+                  DecodeCacheEntry{0, InvalidPortID}),
+      decodeBlockBits(floorLog2(p->decode_cache_block_size)),
       gotAddrRanges(p->port_default_connection_count +
                           p->port_master_connection_count, false),
       gotAllAddrRanges(false), defaultPortID(InvalidPortID),
       useDefaultRange(p->use_default_range)
-{}
+{
+    fatal_if(layersPerPort == 0, "%s needs at least one layer per port",
+             name());
+    fatal_if(layerInterleave == 0, "%s needs a layer interleaving",
+             name());
+    fatal_if(layerFrequencyRatio == 0, "%s needs a layer frequency ratio",
+             name());
+    fatal_if((p->decode_cache_entries != 0 &&
+              !isPowerOf2(p->decode_cache_entries)) ||
+             !isPowerOf2(p->decode_cache_block_size),
+             "The decode cache of %s needs a power-of-two number of "
+             "entries and block size", name());
+}
 
 BaseXBar::~BaseXBar()
 {
@@ -133,8 +152,10 @@ BaseXBar::calcPacketTiming(PacketPtr pkt, Tick header_delay)
         // we take the maximum since the payload delay could already
         // be longer than what this parcitular crossbar enforces.
         pkt->payloadDelay = std::max<Tick>(pkt->payloadDelay,
-                                           divCeil(pkt->getSize(), width) *
-                                           clockPeriod());
+                                           divCeil(divCeil(pkt->getSize(),
+                                                           width) *
+                                                   clockPeriod(),
+                                                   layerFrequencyRatio));
     }
 
     // the payload delay is not paying for the clock offset as that is
@@ -327,6 +348,57 @@ BaseXBar::findPort(AddrRange addr_range)
     // ranges of all connected slave modules
     assert(gotAllAddrRanges);
 
+    // only ranges within one block can be served by the decode cache
+    const Addr block = addr_range.start() >> decodeBlockBits;
+    if (decodeCache.empty() || block != addr_range.end() >> decodeBlockBits)
+        return decodePort(addr_range);
+
+    const DecodeCacheEntry &entry =
+        decodeCache[block & (decodeCache.size() - 1)];
+    if (entry.port != InvalidPortID && entry.block == block) {
+        decodeCacheHits++;
+        return entry.port;
+    }
+
+    decodeCacheMisses++;
+    PortID port_id = decodePort(addr_range);
+    cacheDecode(block, port_id);
+    return port_id;
+}
+
+void
+BaseXBar::cacheDecode(Addr block, PortID port_id)
+{
+    AddrRange block_range = RangeSize(block << decodeBlockBits,
+                                      ULL(1) << decodeBlockBits);
+
+    // the block can only be cached if all of its addresses go to the
+    // same port; otherwise we always do the full lookup
+    auto i = portMap.contains(block_range);
+    if (i != portMap.end()) {
+        if (i->second != port_id)
+            return;
+    } else if (port_id != defaultPortID ||
+               portMap.intersects(block_range) != portMap.end() ||
+               (useDefaultRange && !block_range.isSubset(defaultRange))) {
+        return;
+    }
+
+    DecodeCacheEntry &entry = decodeCache[block & (decodeCache.size() - 1)];
+    entry.block = block;
+    entry.port = port_id;
+}
+
+void
+BaseXBar::flushDecodeCache()
+{
+    for (auto &entry : decodeCache)
+        entry.port = InvalidPortID;
+}
+
+PortID
+BaseXBar::decodePort(AddrRange addr_range)
+{
     // Check the address map interval tree
     auto i = portMap.contains(addr_range);
     if (i != portMap.end()) {
@@ -359,6 +431,9 @@ BaseXBar::recvRangeChange(PortID master_port_id)
     DPRINTF(AddrRanges, "Received range change from slave port %s\n",
             masterPorts[master_port_id]->getSlavePort().name());
 
+    // the address map changes, so forget all cached decodings
+    flushDecodeCache();
+
     // remember that we got a range from this master port and thus the
     // connected slave module
     gotAddrRanges[master_port_id] = true;
@@ -563,6 +638,16 @@ BaseXBar::regStats()
         .desc("Cumulative packet size per connected master and slave (bytes)")
         .flags(total | nozero | nonan);
 
+    decodeCacheHits
+        .name(name() + ".decode_cache_hits")
+        .desc("Number of address decodings served by the decode cache")
+        .flags(nozero);
+
+    decodeCacheMisses
+        .name(name() + ".decode_cache_misses")
+        .desc("Number of address decodings that missed the decode cache")
+        .flags(nozero);
+
     // both the packet count and total size are two-dimensional
     // vectors, indexed by slave port id and master port id, thus the
     // neighbouring master and slave, they do not differentiate what
@@ -154,6 +154,12 @@ class BaseXBar : public MemObject
          */
         void failedTiming(SrcType* src_port, Tick busy_time);
 
+        /**
+         * Determine if the layer failed to forward a packet and is
+         * waiting for a retry from the peer.
+         */
+        bool isWaitingForPeer() const { return waitingForPeer != NULL; }
+
         /** Occupy the layer until until */
         void occupyLayer(Tick until);
 
@@ -319,8 +325,32 @@ class BaseXBar : public MemObject
     /** the width of the xbar in bytes */
     const uint32_t width;
 
+    /** Number of parallel layers per destination port */
+    const unsigned layersPerPort;
+    /** Address-interleaving granularity of the parallel layers */
+    const Addr layerInterleave;
+    /** Number of data transfers per cycle of a layer */
+    const unsigned layerFrequencyRatio;
+
     AddrRangeMap<PortID, 3> portMap;
 
+    /**
+     * An entry of the address-decode cache, which maps an aligned
+     * block of addresses to the port that is responsible for the
+     * whole block.
+     */
+    struct DecodeCacheEntry
+    {
+        Addr block;
+        PortID port;
+    };
+
+    /** The direct-mapped address-decode cache */
+    std::vector<DecodeCacheEntry> decodeCache;
+
+    /** Log2 of the block size of the decode cache */
+    const unsigned decodeBlockBits;
+
     /**
      * Remember where request packets came from so that we can route
      * responses to the appropriate port. This relies on the fact that
@@ -351,6 +381,95 @@ class BaseXBar : public MemObject
      */
     PortID findPort(AddrRange addr_range);
 
+    /**
+     * Find the port for the given address range by searching the
+     * address map, bypassing the decode cache.
+     *
+     * @param addr_range Address range to find port for.
+     * @return id of port that the packet should be sent out of.
+     */
+    PortID decodePort(AddrRange addr_range);
+
+    /**
+     * Remember in the decode cache to which port the block at the
+     * given address is mapped, if the whole block goes to one port.
+     *
+     * @param block The block number
+     * @param port_id The port the block's first address is mapped to
+     */
+    void cacheDecode(Addr block, PortID port_id);
+
+    /** Invalidate all entries of the decode cache. */
+    void flushDecodeCache();
+
+    /**
+     * Create the layers for a destination port and append them to the
+     * given vector.
+     *
+     * @param layers The layers of all ports
+     * @param port The destination port
+     * @param name The name prefix of the layers
+     * @param port_id The id of the destination port
+     */
+    template <typename L, typename P>
+    void createLayers(std::vector<L*> &layers, P &port,
+                      const std::string &name, PortID port_id)
+    {
+        for (unsigned i = 0; i < layersPerPort; ++i) {
+            std::string layer_name = layersPerPort == 1 ?
+                csprintf("%s%d", name, port_id) :
+                csprintf("%s%d_%d", name, port_id, i);
+            layers.push_back(new L(port, *this, layer_name));
+        }
+    }
+
+    /**
+     * Select the layer of a destination port that a packet with the
+     * given address goes through. If a layer of this port is waiting
+     * for a retry from the peer, all packets have to wait for it, as
+     * we may not send anything else to the peer in the meantime.
+     *
+     * @param layers The layers of all ports
+     * @param port_id The id of the destination port
+     * @param addr The address of the packet
+     * @return the layer to use
+     */
+    template <typename L>
+    L* selectLayer(const std::vector<L*> &layers, PortID port_id,
+                   Addr addr) const
+    {
+        const size_t first = port_id * layersPerPort;
+        if (layersPerPort == 1)
+            return layers[first];
+
+        for (size_t i = first; i < first + layersPerPort; ++i) {
+            if (layers[i]->isWaitingForPeer())
+                return layers[i];
+        }
+        return layers[first + (addr / layerInterleave) % layersPerPort];
+    }
+
+    /**
+     * Pass a retry from the peer to the layer of the destination port
+     * that is waiting for it.
+     *
+     * @param layers The layers of all ports
+     * @param port_id The id of the destination port
+     */
+    template <typename L>
+    void retryLayer(const std::vector<L*> &layers, PortID port_id)
+    {
+        const size_t first = port_id * layersPerPort;
+        for (size_t i = first; i < first + layersPerPort; ++i) {
+            if (layers[i]->isWaitingForPeer()) {
+                layers[i]->recvRetry();
+                return;
+            }
+        }
+        panic("%s got a retry for port %d without waiting layer\n",
+              name(), port_id);
+    }
+
     /**
      * Return the address ranges the crossbar is responsible for.
      *
@@ -406,6 +525,10 @@ class BaseXBar : public MemObject
     Stats::Vector2d pktCount;
     Stats::Vector2d pktSize;
 
+    /** Hits and misses of the address-decode cache */
+    Stats::Scalar decodeCacheHits;
+    Stats::Scalar decodeCacheMisses;
+
   public:
 
     virtual ~BaseXBar();
@@ -95,6 +95,170 @@ ProtoOutputStream::write(const Message& msg)
     msg.SerializeWithCachedSizes(&codedStream);
 }
 
+ThreadedProtoOutputStream::ThreadedProtoOutputStream(const string& filename,
+                                                     size_t batch_size,
+                                                     size_t max_batches,
+                                                     int level) :
+    fileStream(filename.c_str(), ios::out | ios::binary | ios::trunc),
+    fileName(filename), useGzip(false), zBuffer(1 << 16),
+    batchSize(batch_size), maxBatches(max_batches), inFlight(0),
+    closing(false)
+{
+    if (!fileStream.good())
+        panic("Could not open %s for writing\n", filename);
+
+    useGzip = filename.find_last_of('.') != string::npos &&
+        filename.substr(filename.find_last_of('.') + 1) == "gz";
+    if (useGzip) {
+        zStream.zalloc = Z_NULL;
+        zStream.zfree = Z_NULL;
+        zStream.opaque = Z_NULL;
+        // 15 window bits plus 16 to get a gzip header and trailer
+        if (deflateInit2(&zStream, level, Z_DEFLATED, 15 + 16, 8,
+                         Z_DEFAULT_STRATEGY) != Z_OK)
+            panic("Unable to initialize compression for %s\n", filename);
+    }
+
+    batch.reserve(batchSize + 256);
+
+    // Write the magic number to the file
+    {
+        io::StringOutputStream stringStream(&batch);
+        io::CodedOutputStream codedStream(&stringStream);
+        codedStream.WriteLittleEndian32(magicNumber);
+    }
+
+    if (maxBatches > 0)
+        writer = thread(&ThreadedProtoOutputStream::run, this);
+}
+
+ThreadedProtoOutputStream::~ThreadedProtoOutputStream()
+{
+    submitBatch();
+
+    if (writer.joinable()) {
+        {
+            lock_guard<std::mutex> lock(mutex);
+            closing = true;
+        }
+        batchAvailable.notify_one();
+        writer.join();
+    }
+
+    writeData(string(), true);
+    if (useGzip)
+        deflateEnd(&zStream);
+    fileStream.close();
+}
+
+void
+ThreadedProtoOutputStream::write(const Message& msg)
+{
+    {
+        io::StringOutputStream stringStream(&batch);
+        io::CodedOutputStream codedStream(&stringStream);
+
+        // Write the size of the message to the stream
+        codedStream.WriteVarint32(msg.ByteSize());
+
+        // Write the message itself to the stream
+        msg.SerializeWithCachedSizes(&codedStream);
+    }
+
+    if (batch.size() >= batchSize)
+        submitBatch();
+}
+
+void
+ThreadedProtoOutputStream::flush()
+{
+    submitBatch();
+
+    if (writer.joinable()) {
+        unique_lock<std::mutex> lock(mutex);
+        batchWritten.wait(lock, [this] {
+            return pending.empty() && inFlight == 0;
+        });
+    }
+    fileStream.flush();
+}
+
+void
+ThreadedProtoOutputStream::submitBatch()
+{
+    if (batch.empty())
+        return;
+
+    if (!writer.joinable()) {
+        writeData(batch, false);
+        batch.clear();
+        return;
+    }
+
+    {
+        // apply backpressure if the writer falls behind
+        unique_lock<std::mutex> lock(mutex);
+        batchWritten.wait(lock, [this] {
+            return pending.size() + inFlight < maxBatches;
+        });
+        pending.push_back(string());
+        pending.back().swap(batch);
+    }
+    batchAvailable.notify_one();
+
+    batch.reserve(batchSize + 256);
+}
+
+void
+ThreadedProtoOutputStream::run()
+{
+    unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        batchAvailable.wait(lock, [this] {
+            return !pending.empty() || closing;
+        });
+        if (pending.empty())
+            break;
+
+        string data;
+        data.swap(pending.front());
+        pending.pop_front();
+        inFlight++;
+
+        lock.unlock();
+        writeData(data, false);
+        lock.lock();
+
+        inFlight--;
+        batchWritten.notify_all();
+    }
+}
+
+void
+ThreadedProtoOutputStream::writeData(const string& data, bool finish)
+{
+    if (!useGzip) {
+        fileStream.write(data.data(), data.size());
+        return;
+    }
+
+    zStream.next_in = (Bytef*)data.data();
+    zStream.avail_in = data.size();
+    int res;
+    do {
+        zStream.next_out = zBuffer.data();
+        zStream.avail_out = zBuffer.size();
+        res = deflate(&zStream, finish ? Z_FINISH : Z_NO_FLUSH);
+        if (res == Z_STREAM_ERROR)
+            panic("Unable to compress data for %s\n", fileName);
+        fileStream.write((const char*)zBuffer.data(),
+                         zBuffer.size() - zStream.avail_out);
+    } while (zStream.avail_out == 0 || (finish && res != Z_STREAM_END));
+
+    if (!fileStream.good())
+        panic("Unable to write to %s\n", fileName);
+}
+
 ProtoInputStream::ProtoInputStream(const string& filename) :
     fileStream(filename.c_str(), ios::in | ios::binary), fileName(filename),
     useGzip(false),
@@ -51,7 +51,15 @@
 #include <google/protobuf/io/zero_copy_stream_impl.h>
 #include <google/protobuf/message.h>
 
+#include <zlib.h>
+
+#include <condition_variable>
+#include <deque>
 #include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 
 /**
  * A ProtoStream provides the shared functionality of the input and
@@ -132,6 +140,125 @@ class ProtoOutputStream : public ProtoStream
 
 };
 
+/**
+ * A ThreadedProtoOutputStream produces the same format as the
+ * ProtoOutputStream, but moves the compression and the file I/O off
+ * the simulation thread. Messages are serialized into batches, which
+ * are handed over to a background thread that deflates them into a
+ * single gzip stream and writes them to the file. The number of
+ * pending batches is bounded; if the background thread falls behind,
+ * write() blocks until a batch has been written. The resulting file
+ * can be read with a ProtoInputStream.
+ */
+class ThreadedProtoOutputStream : public ProtoStream
+{
+
+  public:
+
+    /**
+     * Create an output stream for a given file name. If the filename
+     * ends with .gz then the file will be compressed accordingly.
+     *
+     * @param filename Path to the file to create or truncate
+     * @param batch_size Number of bytes to collect before a batch is
+     *                   handed over to the background thread
+     * @param max_batches Maximum number of pending batches. If 0, the
+     *                    batches are written by the calling thread.
+     * @param level zlib compression level
+     */
+    ThreadedProtoOutputStream(const std::string& filename,
+                              size_t batch_size = 1 << 20,
+                              size_t max_batches = 8,
+                              int level = Z_BEST_SPEED);
+
+    /**
+     * Destruct the output stream, wait until all pending batches are
+     * written and close the underlying file stream.
+     */
+    ~ThreadedProtoOutputStream();
+
+    /**
+     * Write a message to the stream, preprending it with the message
+     * size.
+     *
+     * @param msg Message to write to the stream
+     */
+    void write(const google::protobuf::Message& msg);
+
+    /**
+     * Hand over the current batch and wait until all pending batches
+     * are written to the file.
+     */
+    void flush();
+
+  private:
+
+    /**
+     * Hand over the current batch to the background thread, waiting
+     * for a free slot if necessary.
+     */
+    void submitBatch();
+
+    /**
+     * The main loop of the background thread.
+     */
+    void run();
+
+    /**
+     * Compress the given data (if enabled) and write it to the file.
+     *
+     * @param data The serialized messages
+     * @param finish Whether to finish the compressed stream
+     */
+    void writeData(const std::string& data, bool finish);
+
+    /// Underlying file output stream
+    std::ofstream fileStream;
+
+    /// Hold on to the file name for debug messages
+    const std::string fileName;
+
+    /// Boolean flag to remember whether we use gzip or not
+    bool useGzip;
+
+    /// The zlib state, only used by the writing thread
+    z_stream zStream;
+
+    /// Output buffer for the compressed data
+    std::vector<unsigned char> zBuffer;
+
+    /// The batch that is currently filled by write()
+    std::string batch;
+
+    /// Number of bytes after which a batch is handed over
+    const size_t batchSize;
+
+    /// Maximum number of pending batches
+    const size_t maxBatches;
+
+    /// Batches waiting to be written
+    std::deque<std::string> pending;
+
+    /// Number of batches taken by the background thread, but not written
+    size_t inFlight;
+
+    /// Protects pending, inFlight and closing
+    std::mutex mutex;
+
+    /// Signalled when a batch has been submitted or the stream is closed
+    std::condition_variable batchAvailable;
+
+    /// Signalled when a batch has been written
+    std::condition_variable batchWritten;
+
+    /// Set on destruction to stop the background thread
+    bool closing;
+
+    /// The background thread
+    std::thread writer;
+
+};
+
 /**
  * A ProtoInputStream wraps a coded stream, potentially with
  * decompression, based on looking at the file name. Reading from the
@@ -70,6 +70,10 @@ class Root(SimObject):
 
     full_system = Param.Bool("if this is a full system simulation")
 
+    # Optionally, decoded instructions are shared by the decoders of all CPUs
+    shared_decode_cache = Param.Bool(False, "share decoded instructions "
+                                     "between all CPUs")
+
     # Time syncing prevents the simulation from running faster than real time.
     time_sync_enable = Param.Bool(False, "whether time syncing is enabled")
     time_sync_period = Param.Clock("100ms", "how often to sync with real time")
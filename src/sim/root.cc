@@ -135,6 +135,7 @@ Root::serialize(CheckpointOut &cp) const
 
 bool FullSystem;
 unsigned int FullSystemInt;
+bool SharedDecodeCache = false;
 
 Root *
 RootParams::create()
@@ -147,6 +148,7 @@ RootParams::create()
 
     FullSystem = full_system;
     FullSystemInt = full_system ? 1 : 0;
+    SharedDecodeCache = shared_decode_cache;
 
     return new Root(this);
 }
@@ -0,0 +1,106 @@
+#! /usr/bin/env python2
+
+# Copyright (c) 2016 Nils Asmussen
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#
+# 1. Redistributions of source code must retain the above copyright notice, this
+#    list of conditions and the following disclaimer.
+# 2. Redistributions in binary form must reproduce the above copyright notice,
+#    this list of conditions and the following disclaimer in the documentation
+#    and/or other materials provided with the distribution.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+# ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+# DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+# ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+# (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+# LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+# ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+# SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+# The views and conclusions contained in the software and documentation are those
+# of the authors and should not be interpreted as representing official policies,
+# either expressed or implied, of the FreeBSD Project.
+
+
+import optparse
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+
+parser = optparse.OptionParser(usage="%prog [options] gem5-binary...")
+
+# This script measures the simulation speed of the O3 CPU in simulated
+# instructions per host second (host_inst_rate). It runs the given
+# workload with se.py on each of the given gem5 binaries a number of times
+# and reports the median rate per binary. To compare the speed before and
+# after a change, build gem5 twice and pass both binaries.
+
+parser.add_option('-c', '--count', type='int', default=5,
+                  help="number of runs per binary")
+parser.add_option('--cmd', default='tests/test-progs/hello/bin/x86/linux/hello',
+                  help="the workload to simulate")
+parser.add_option('--options', default='',
+                  help="the arguments for the workload")
+parser.add_option('--maxinsts', type='int', default=0,
+                  help="stop after this number of instructions (0 = run to end)")
+parser.add_option('--cpu-type', default='DerivO3CPU')
+
+(options, args) = parser.parse_args()
+
+if len(args) < 1:
+    print "Error: Expecting at least one gem5 binary"
+    sys.exit(1)
+
+def run(gem5_binary):
+    outdir = tempfile.mkdtemp(prefix='o3-host-rate-')
+    try:
+        cmd = [gem5_binary, '-d', outdir, 'configs/example/se.py',
+               '--cpu-type=%s' % options.cpu_type, '--caches',
+               '--cmd=%s' % options.cmd]
+        if options.options:
+            cmd.append('--options=%s' % options.options)
+        if options.maxinsts:
+            cmd.append('--maxinsts=%d' % options.maxinsts)
+
+        with open(os.devnull, 'w') as null:
+            status = subprocess.call(cmd, stdout=null, stderr=null)
+        if status != 0:
+            print "Error: %s failed with status %d" % (gem5_binary, status)
+            sys.exit(1)
+
+        with open(os.path.join(outdir, 'stats.txt')) as stats:
+            for line in stats:
+                m = re.match(r'host_inst_rate\s+(\d+)', line)
+                if m:
+                    return int(m.group(1))
+        print "Error: no host_inst_rate in the stats of %s" % gem5_binary
+        sys.exit(1)
+    finally:
+        shutil.rmtree(outdir)
+
+def median(values):
+    values = sorted(values)
+    mid = len(values) / 2
+    if len(values) % 2 == 0:
+        return (values[mid - 1] + values[mid]) / 2
+    return values[mid]
+
+results = []
+for binary in args:
+    rates = [run(binary) for i in range(options.count)]
+    results.append((binary, median(rates), min(rates), max(rates)))
+
+base = results[0][1]
+print "%-50s %12s %12s %12s %8s" % ("binary", "median", "min", "max", "speedup")
+for binary, med, lo, hi in results:
+    print "%-50s %12d %12d %12d %7.2fx" % (binary, med, lo, hi,
+                                           float(med) / base)